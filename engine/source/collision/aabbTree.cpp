@@ -0,0 +1,307 @@
+//-----------------------------------------------------------------------------
+// Torque Game Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#include "collision/aabbTree.h"
+
+AABBTree::AABBTree(F32 margin)
+{
+    VECTOR_SET_ASSOCIATION(mNodes);
+
+    mRoot = NullNode;
+    mFreeList = NullNode;
+    mProxyCount = 0;
+    mMargin = margin;
+}
+
+//----------------------------------------------------------------------------
+
+S32 AABBTree::allocateNode()
+{
+    if (mFreeList == NullNode)
+    {
+        mNodes.increment();
+        Node& node = mNodes.last();
+        node.parent = mFreeList;
+        node.height = -1;
+        mFreeList = mNodes.size() - 1;
+    }
+
+    S32 index = mFreeList;
+    Node& node = mNodes[index];
+    mFreeList = node.parent;
+
+    node.userData = NULL;
+    node.parent = NullNode;
+    node.child1 = NullNode;
+    node.child2 = NullNode;
+    node.height = 0;
+    return index;
+}
+
+void AABBTree::freeNode(S32 index)
+{
+    Node& node = mNodes[index];
+    node.userData = NULL;
+    node.parent = mFreeList;
+    node.height = -1;
+    mFreeList = index;
+}
+
+F32 AABBTree::getCost(const Box3F& box)
+{
+    // Surface area, give or take a factor of two
+    F32 x = box.len_x();
+    F32 y = box.len_y();
+    F32 z = box.len_z();
+    return x * y + y * z + z * x;
+}
+
+Box3F AABBTree::getUnion(const Box3F& a, const Box3F& b)
+{
+    Box3F result = a;
+    result.min.setMin(b.min);
+    result.max.setMax(b.max);
+    return result;
+}
+
+//----------------------------------------------------------------------------
+
+S32 AABBTree::createProxy(const Box3F& box, void* userData)
+{
+    S32 proxy = allocateNode();
+    Node& node = mNodes[proxy];
+
+    node.box = box;
+    node.box.min -= Point3F(mMargin, mMargin, mMargin);
+    node.box.max += Point3F(mMargin, mMargin, mMargin);
+    node.userData = userData;
+
+    insertLeaf(proxy);
+    mProxyCount++;
+    return proxy;
+}
+
+void AABBTree::destroyProxy(S32 proxy)
+{
+    AssertFatal(proxy >= 0 && proxy < mNodes.size() && mNodes[proxy].isLeaf() && mNodes[proxy].height == 0,
+        "AABBTree::destroyProxy - invalid proxy");
+
+    removeLeaf(proxy);
+    freeNode(proxy);
+    mProxyCount--;
+}
+
+bool AABBTree::moveProxy(S32 proxy, const Box3F& box)
+{
+    AssertFatal(proxy >= 0 && proxy < mNodes.size() && mNodes[proxy].isLeaf() && mNodes[proxy].height == 0,
+        "AABBTree::moveProxy - invalid proxy");
+
+    if (mNodes[proxy].box.isContained(box))
+        return false;
+
+    removeLeaf(proxy);
+
+    Node& node = mNodes[proxy];
+    node.box = box;
+    node.box.min -= Point3F(mMargin, mMargin, mMargin);
+    node.box.max += Point3F(mMargin, mMargin, mMargin);
+
+    insertLeaf(proxy);
+    return true;
+}
+
+//----------------------------------------------------------------------------
+
+void AABBTree::insertLeaf(S32 leaf)
+{
+    if (mRoot == NullNode)
+    {
+        mRoot = leaf;
+        mNodes[mRoot].parent = NullNode;
+        return;
+    }
+
+    // Walk down to the sibling that makes the cheapest tree, by the surface
+    // area heuristic.
+    const Box3F leafBox = mNodes[leaf].box;
+    S32 index = mRoot;
+    while (!mNodes[index].isLeaf())
+    {
+        const Node& node = mNodes[index];
+        S32 child1 = node.child1;
+        S32 child2 = node.child2;
+
+        F32 area = getCost(node.box);
+        F32 combinedArea = getCost(getUnion(node.box, leafBox));
+
+        // Cost of making a new parent for this node and the leaf
+        F32 cost = 2.0f * combinedArea;
+
+        // Minimum cost of pushing the leaf further down the tree
+        F32 inheritanceCost = 2.0f * (combinedArea - area);
+
+        F32 cost1 = getCost(getUnion(leafBox, mNodes[child1].box)) + inheritanceCost;
+        if (!mNodes[child1].isLeaf())
+            cost1 -= getCost(mNodes[child1].box);
+
+        F32 cost2 = getCost(getUnion(leafBox, mNodes[child2].box)) + inheritanceCost;
+        if (!mNodes[child2].isLeaf())
+            cost2 -= getCost(mNodes[child2].box);
+
+        if (cost < cost1 && cost < cost2)
+            break;
+
+        index = cost1 < cost2 ? child1 : child2;
+    }
+
+    S32 sibling = index;
+
+    // Make a new parent for the sibling and the leaf.  Note allocateNode
+    // can move mNodes, so no references across it.
+    S32 oldParent = mNodes[sibling].parent;
+    S32 newParent = allocateNode();
+    mNodes[newParent].parent = oldParent;
+    mNodes[newParent].box = getUnion(leafBox, mNodes[sibling].box);
+    mNodes[newParent].height = mNodes[sibling].height + 1;
+    mNodes[newParent].child1 = sibling;
+    mNodes[newParent].child2 = leaf;
+    mNodes[sibling].parent = newParent;
+    mNodes[leaf].parent = newParent;
+
+    if (oldParent != NullNode)
+    {
+        if (mNodes[oldParent].child1 == sibling)
+            mNodes[oldParent].child1 = newParent;
+        else
+            mNodes[oldParent].child2 = newParent;
+    }
+    else
+        mRoot = newParent;
+
+    // Fix up heights and boxes on the way back up
+    index = mNodes[leaf].parent;
+    while (index != NullNode)
+    {
+        index = balance(index);
+
+        Node& node = mNodes[index];
+        node.height = 1 + getMax(mNodes[node.child1].height, mNodes[node.child2].height);
+        node.box = getUnion(mNodes[node.child1].box, mNodes[node.child2].box);
+
+        index = node.parent;
+    }
+}
+
+void AABBTree::removeLeaf(S32 leaf)
+{
+    if (leaf == mRoot)
+    {
+        mRoot = NullNode;
+        return;
+    }
+
+    S32 parent = mNodes[leaf].parent;
+    S32 grandParent = mNodes[parent].parent;
+    S32 sibling = mNodes[parent].child1 == leaf ? mNodes[parent].child2 : mNodes[parent].child1;
+
+    if (grandParent != NullNode)
+    {
+        // Replace the parent with the sibling
+        if (mNodes[grandParent].child1 == parent)
+            mNodes[grandParent].child1 = sibling;
+        else
+            mNodes[grandParent].child2 = sibling;
+        mNodes[sibling].parent = grandParent;
+        freeNode(parent);
+
+        S32 index = grandParent;
+        while (index != NullNode)
+        {
+            index = balance(index);
+
+            Node& node = mNodes[index];
+            node.height = 1 + getMax(mNodes[node.child1].height, mNodes[node.child2].height);
+            node.box = getUnion(mNodes[node.child1].box, mNodes[node.child2].box);
+
+            index = node.parent;
+        }
+    }
+    else
+    {
+        mRoot = sibling;
+        mNodes[sibling].parent = NullNode;
+        freeNode(parent);
+    }
+
+    mNodes[leaf].parent = NullNode;
+}
+
+S32 AABBTree::balance(S32 iA)
+{
+    Node* A = &mNodes[iA];
+    if (A->isLeaf() || A->height < 2)
+        return iA;
+
+    S32 iB = A->child1;
+    S32 iC = A->child2;
+    Node* B = &mNodes[iB];
+    Node* C = &mNodes[iC];
+
+    S32 diff = C->height - B->height;
+
+    // Rotate the taller child up.  The two cases mirror each other; swap
+    // names so the same code handles both.
+    if (diff > 1 || diff < -1)
+    {
+        bool rotateC = diff > 1;
+        S32 iUp = rotateC ? iC : iB;
+        S32 iOther = rotateC ? iB : iC;
+        Node* up = &mNodes[iUp];
+        Node* other = &mNodes[iOther];
+
+        S32 iF = up->child1;
+        S32 iG = up->child2;
+        Node* F = &mNodes[iF];
+        Node* G = &mNodes[iG];
+
+        // Swap A and up
+        up->child1 = iA;
+        up->parent = A->parent;
+        A->parent = iUp;
+
+        if (up->parent != NullNode)
+        {
+            if (mNodes[up->parent].child1 == iA)
+                mNodes[up->parent].child1 = iUp;
+            else
+                mNodes[up->parent].child2 = iUp;
+        }
+        else
+            mRoot = iUp;
+
+        // The taller grandchild stays under up, the other goes to A
+        S32 iKeep = F->height > G->height ? iF : iG;
+        S32 iMove = F->height > G->height ? iG : iF;
+        Node* keep = &mNodes[iKeep];
+        Node* move = &mNodes[iMove];
+
+        up->child2 = iKeep;
+        if (rotateC)
+            A->child2 = iMove;
+        else
+            A->child1 = iMove;
+        move->parent = iA;
+
+        A->box = getUnion(other->box, move->box);
+        up->box = getUnion(A->box, keep->box);
+
+        A->height = 1 + getMax(other->height, move->height);
+        up->height = 1 + getMax(A->height, keep->height);
+
+        return iUp;
+    }
+
+    return iA;
+}
@@ -0,0 +1,218 @@
+//-----------------------------------------------------------------------------
+// Torque Game Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#ifndef _AABBTREE_H_
+#define _AABBTREE_H_
+
+#ifndef _PLATFORM_H_
+#include "platform/platform.h"
+#endif
+#ifndef _MBOX_H_
+#include "math/mBox.h"
+#endif
+#ifndef _TVECTOR_H_
+#include "core/tVector.h"
+#endif
+
+/// Dynamic bounding volume hierarchy over axis aligned boxes.
+///
+/// Every object is a leaf ("proxy") holding a slightly enlarged copy of the
+/// object's box.  As long as the object stays inside its enlarged box,
+/// moving it costs nothing; once it leaves, the leaf is pulled out and
+/// reinserted where it adds the least surface area to the tree, and the
+/// parents are rotated to keep the tree balanced.
+///
+/// Queries walk the tree with callbacks:
+///
+/// @code
+/// struct Collector
+/// {
+///    bool queryCallback(S32 proxy) { ...; return true; }   // false stops the query
+///    F32 rayCastCallback(S32 proxy, F32 maxT) { ...; return maxT; }   // < 0 stops the cast
+/// };
+/// @endcode
+///
+/// Queries don't change the tree, so they may be nested, but the tree must
+/// not be modified from inside a callback.
+class AABBTree
+{
+public:
+    enum Constants
+    {
+        NullNode = -1,
+        MaxStackDepth = 256,
+    };
+
+private:
+    struct Node
+    {
+        Box3F box;
+        void* userData;
+
+        /// Parent while in use, next free node while on the free list.
+        S32 parent;
+        S32 child1;
+        S32 child2;
+
+        /// Leaves are 0, free nodes -1.
+        S32 height;
+
+        bool isLeaf() const { return child1 == NullNode; }
+    };
+
+    Vector<Node> mNodes;
+    S32 mRoot;
+    S32 mFreeList;
+    U32 mProxyCount;
+
+    /// How far leaf boxes are grown past the object's box.
+    F32 mMargin;
+
+    S32 allocateNode();
+    void freeNode(S32 node);
+
+    void insertLeaf(S32 leaf);
+    void removeLeaf(S32 leaf);
+
+    /// Rotate the subtree at node if it is out of balance, returns the new
+    /// root of the subtree.
+    S32 balance(S32 node);
+
+    static F32 getCost(const Box3F& box);
+    static Box3F getUnion(const Box3F& a, const Box3F& b);
+
+    /// Does the segment start + t * dir, t in [0, maxT], touch the box?
+    static bool segmentOverlaps(const Box3F& box, const Point3F& start, const Point3F& dir, F32 maxT);
+
+public:
+    AABBTree(F32 margin = 1.0f);
+
+    /// Add a leaf for an object with the given box.  Returns the proxy id.
+    S32 createProxy(const Box3F& box, void* userData);
+    void destroyProxy(S32 proxy);
+
+    /// Update the box of a proxy.  Returns true if the leaf had to be
+    /// reinserted, false if the box still fit inside the old leaf.
+    bool moveProxy(S32 proxy, const Box3F& box);
+
+    void* getUserData(S32 proxy) const { return mNodes[proxy].userData; }
+    const Box3F& getFatBox(S32 proxy) const { return mNodes[proxy].box; }
+
+    U32 getProxyCount() const { return mProxyCount; }
+    U32 getNodeCount() const { return mProxyCount ? mProxyCount * 2 - 1 : 0; }
+    S32 getHeight() const { return mRoot == NullNode ? 0 : mNodes[mRoot].height; }
+
+    /// Call callback->queryCallback(proxy) for every leaf overlapping box.
+    template <class T> void query(const Box3F& box, T* callback) const;
+
+    /// Call callback->rayCastCallback(proxy, maxT) for every leaf the
+    /// segment from start to end passes through, nearest subtrees aren't
+    /// necessarily visited first.  The callback returns the new maxT, so
+    /// leaves beyond the closest hit so far are skipped.
+    template <class T> void rayCast(const Point3F& start, const Point3F& end, T* callback) const;
+};
+
+//------------------------------------------------------------------------------
+
+template <class T> inline void AABBTree::query(const Box3F& box, T* callback) const
+{
+    if (mRoot == NullNode)
+        return;
+
+    S32 stack[MaxStackDepth];
+    S32 count = 0;
+    stack[count++] = mRoot;
+
+    while (count > 0)
+    {
+        const Node& node = mNodes[stack[--count]];
+        if (!node.box.isOverlapped(box))
+            continue;
+
+        if (node.isLeaf())
+        {
+            if (!callback->queryCallback(S32(&node - mNodes.address())))
+                return;
+        }
+        else
+        {
+            AssertFatal(count + 2 <= MaxStackDepth, "AABBTree::query - stack overflow");
+            stack[count++] = node.child1;
+            stack[count++] = node.child2;
+        }
+    }
+}
+
+template <class T> inline void AABBTree::rayCast(const Point3F& start, const Point3F& end, T* callback) const
+{
+    if (mRoot == NullNode)
+        return;
+
+    Point3F dir = end - start;
+    F32 maxT = 1.0f;
+
+    S32 stack[MaxStackDepth];
+    S32 count = 0;
+    stack[count++] = mRoot;
+
+    while (count > 0)
+    {
+        const Node& node = mNodes[stack[--count]];
+        if (!segmentOverlaps(node.box, start, dir, maxT))
+            continue;
+
+        if (node.isLeaf())
+        {
+            maxT = callback->rayCastCallback(S32(&node - mNodes.address()), maxT);
+            if (maxT < 0.0f)
+                return;
+        }
+        else
+        {
+            AssertFatal(count + 2 <= MaxStackDepth, "AABBTree::rayCast - stack overflow");
+            stack[count++] = node.child1;
+            stack[count++] = node.child2;
+        }
+    }
+}
+
+inline bool AABBTree::segmentOverlaps(const Box3F& box, const Point3F& start, const Point3F& dir, F32 maxT)
+{
+    F32 tMin = 0.0f;
+    F32 tMax = maxT;
+
+    for (U32 i = 0; i < 3; i++)
+    {
+        F32 s = start[i];
+        F32 d = dir[i];
+        F32 bMin = box.min[i];
+        F32 bMax = box.max[i];
+
+        if (mFabs(d) < 1e-9f)
+        {
+            if (s < bMin || s > bMax)
+                return false;
+            continue;
+        }
+
+        F32 inv = 1.0f / d;
+        F32 t1 = (bMin - s) * inv;
+        F32 t2 = (bMax - s) * inv;
+        if (t1 > t2)
+        {
+            F32 temp = t1;
+            t1 = t2;
+            t2 = temp;
+        }
+
+        tMin = getMax(tMin, t1);
+        tMax = getMin(tMax, t2);
+        if (tMin > tMax)
+            return false;
+    }
+    return true;
+}
+
+#endif // _AABBTREE_H_
@@ -1323,6 +1323,10 @@ namespace Sim
     SimTime getCurrentTime();
     SimTime getTargetTime();
 
+    /// Time the earliest pending event is due.  Returns false if there are
+    /// no events queued.
+    bool getNextEventTime(SimTime* time);
+
     /// a target time of 0 on an event means current event
     U32 postEvent(SimObject*, SimEvent*, U32 targetTime);
 
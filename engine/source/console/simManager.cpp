@@ -249,6 +249,18 @@ namespace Sim
         return gTargetTime;
     }
 
+    bool getNextEventTime(SimTime* time)
+    {
+        // The queue is kept sorted, so the head is the next one due.
+        Mutex::lockMutex(gEventQueueMutex);
+        bool pending = gEventQueue != NULL;
+        if (pending)
+            *time = gEventQueue->time;
+        Mutex::unlockMutex(gEventQueueMutex);
+
+        return pending;
+    }
+
     //---------------------------------------------------------------------------
     //---------------------------------------------------------------------------
 
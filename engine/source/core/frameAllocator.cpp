@@ -5,17 +5,108 @@
 
 #include "core/frameAllocator.h"
 #include "console/console.h"
+#include "platform/platformMutex.h"
 
-U8* FrameAllocator::smBuffer = NULL;
-U32   FrameAllocator::smWaterMark = 0;
-U32   FrameAllocator::smHighWaterMark = 0;
+ScratchArena* ScratchArena::smArenaList = NULL;
+void*         ScratchArena::smListMutex = NULL;
 
-#if defined(TORQUE_DEBUG)
+thread_local ScratchArena* FrameAllocator::smArena = NULL;
 
+//--------------------------------------
+ScratchArena::ScratchArena(const U32 size, const char* name)
+{
+    mBuffer = new U8[size];
+    mSize = size;
+    mWaterMark = 0;
+    mPeakWaterMark = 0;
+    dStrncpy(mName, name, sizeof(mName) - 1);
+    mName[sizeof(mName) - 1] = 0;
+
+    // The main thread's arena is made before any other thread starts, so
+    // the list lock can be made with it.
+    if (!smListMutex)
+        smListMutex = Mutex::createMutex();
+
+    MutexHandle handle;
+    handle.lock(smListMutex);
+    mNext = smArenaList;
+    smArenaList = this;
+}
+
+ScratchArena::~ScratchArena()
+{
+    {
+        MutexHandle handle;
+        handle.lock(smListMutex);
+        for (ScratchArena** walk = &smArenaList; *walk; walk = &(*walk)->mNext)
+        {
+            if (*walk == this)
+            {
+                *walk = mNext;
+                break;
+            }
+        }
+    }
+
+    delete[] mBuffer;
+}
+
+void ScratchArena::dumpStats(bool resetPeaks)
+{
+    if (!smListMutex)
+        return;
+
+    MutexHandle handle;
+    handle.lock(smListMutex);
+
+    // Other threads' numbers can be a little stale, but that's fine for a
+    // report.
+    Con::printf("Frame allocators:");
+    for (ScratchArena* walk = smArenaList; walk; walk = walk->mNext)
+    {
+        Con::printf("   %-24s %8d KB size, %8d KB peak (%d%%), %d bytes in use",
+            walk->mName, walk->mSize / 1024, walk->mPeakWaterMark / 1024,
+            U32(U64(walk->mPeakWaterMark) * 100 / walk->mSize), walk->mWaterMark);
+
+        if (resetPeaks)
+            walk->resetPeakWaterMark();
+    }
+}
+
+//--------------------------------------
+void FrameAllocator::init(const U32 frameSize)
+{
+    initThread(frameSize, "Main thread");
+}
+
+void FrameAllocator::destroy()
+{
+    destroyThread();
+}
+
+void FrameAllocator::initThread(const U32 frameSize, const char* name)
+{
+    AssertFatal(smArena == NULL, "Error, already initialized");
+    smArena = new ScratchArena(frameSize, name);
+}
+
+void FrameAllocator::destroyThread()
+{
+    AssertFatal(smArena != NULL, "Error, not initialized");
+
+    delete smArena;
+    smArena = NULL;
+}
+
+//--------------------------------------
 ConsoleFunction(getMaxFrameAllocation, S32, 1, 1, "getMaxFrameAllocation();")
 {
     argc, argv;
-    return sgMaxFrameAllocation;
+    return FrameAllocator::getPeakWaterMark();
 }
 
-#endif
+ConsoleFunction(dumpFrameAllocators, void, 1, 2, "(bool resetPeaks = false)"
+    "Print the size and peak use of every thread's frame allocator and every scratch arena.")
+{
+    ScratchArena::dumpStats(argc > 1 && dAtob(argv[1]));
+}
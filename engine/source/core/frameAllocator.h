@@ -10,6 +10,84 @@
 #include "platform/platform.h"
 #endif
 
+/// A bump allocator over one fixed block of memory.
+///
+/// Allocations are carved off the front of the block, and are all freed
+/// together by moving the water mark back to where it was.  An arena must
+/// only be used by one thread at a time.
+///
+/// Every arena is listed with its peak use by dumpFrameAllocators(), so
+/// the sizes can be tuned.  Each thread's FrameAllocator is one of these,
+/// and code which wants scratch memory with a different lifetime can make
+/// its own:
+///
+/// @code
+///   ScratchArena arena(256 * 1024, "Lighting");
+///
+///   FrameAllocatorMarker mem(arena);
+///   Point3F* points = (Point3F*)mem.alloc(sizeof(Point3F) * count);
+/// @endcode
+class ScratchArena
+{
+    U8* mBuffer;
+    U32 mSize;
+    U32 mWaterMark;
+    U32 mPeakWaterMark;
+    char mName[32];
+
+    /// @name Arena list
+    /// @{
+    ScratchArena* mNext;
+    static ScratchArena* smArenaList;
+    static void* smListMutex;
+    /// @}
+
+public:
+    ScratchArena(const U32 size, const char* name);
+    ~ScratchArena();
+
+    inline void* alloc(const U32 allocSize);
+
+    inline void setWaterMark(const U32);
+    U32  getWaterMark() const { return mWaterMark; }
+
+    /// Size of the block.
+    U32  getSize() const { return mSize; }
+
+    /// The most that has been in use at once since the last reset.
+    U32  getPeakWaterMark() const { return mPeakWaterMark; }
+    void resetPeakWaterMark() { mPeakWaterMark = mWaterMark; }
+
+    const char* getName() const { return mName; }
+
+    /// Print every arena's size and peak use, and optionally reset the
+    /// peaks.
+    static void dumpStats(bool resetPeaks);
+};
+
+void* ScratchArena::alloc(const U32 allocSize)
+{
+    // Keep all frame allocator allocations aligned to DWORD boundries on the 360
+    // Add 3, mask out the lower 3 bits.
+    U32 start = ( mWaterMark + ( TORQUE_BYTE_ALIGNMENT - 1 ) ) & (~( TORQUE_BYTE_ALIGNMENT - 1 ));
+    AssertFatal(start + allocSize <= mSize, avar("Error alloc too large, increase the size of the %s arena!", mName));
+
+    U8* p = &mBuffer[start];
+    mWaterMark = start + allocSize;
+
+    if (mWaterMark > mPeakWaterMark)
+        mPeakWaterMark = mWaterMark;
+
+    return p;
+}
+
+void ScratchArena::setWaterMark(const U32 waterMark)
+{
+    AssertFatal(waterMark <= mSize, "Error, invalid waterMark");
+
+    mWaterMark = waterMark;
+}
+
 /// Temporary memory pool for per-frame allocations.
 ///
 /// In the course of rendering a frame, it is often necessary to allocate
@@ -26,85 +104,67 @@
 ///   // Free frameAllocator memory
 ///   FrameAllocator::setWaterMark(waterMark);
 /// @endcode
+///
+/// Each thread has its own arena.  The main thread's is made by init(),
+/// other threads which want one call initThread() when they start and
+/// destroyThread() before they exit.  ThreadPool workers already have one.
 class FrameAllocator
 {
-    static U8* smBuffer;
-    static U32   smHighWaterMark;
-    static U32   smWaterMark;
+    static thread_local ScratchArena* smArena;
 
 public:
-    inline static void init(const U32 frameSize);
-    inline static void destroy();
+    /// Set up the main thread's arena.
+    static void init(const U32 frameSize);
+    static void destroy();
+
+    /// Set up an arena for the calling thread.
+    static void initThread(const U32 frameSize, const char* name);
+    static void destroyThread();
+
+    /// The calling thread's arena.
+    inline static ScratchArena* getArena();
 
     inline static void* alloc(const U32 allocSize);
 
     inline static void setWaterMark(const U32);
     inline static U32  getWaterMark();
-    inline static U32  getHighWaterMark();
-};
 
-#if defined(TORQUE_DEBUG)
-static S32 sgMaxFrameAllocation = 0;
-#endif
+    /// Size of the calling thread's arena.
+    inline static U32  getHighWaterMark();
 
-void FrameAllocator::init(const U32 frameSize)
-{
-    AssertFatal(smBuffer == NULL, "Error, already initialized");
-    smBuffer = new U8[frameSize];
-    smWaterMark = 0;
-    smHighWaterMark = frameSize;
-}
+    /// The most of the calling thread's arena in use at once.
+    inline static U32  getPeakWaterMark();
+};
 
-void FrameAllocator::destroy()
+ScratchArena* FrameAllocator::getArena()
 {
-    AssertFatal(smBuffer != NULL, "Error, not initialized");
-
-    delete[] smBuffer;
-    smBuffer = NULL;
-    smWaterMark = 0;
-    smHighWaterMark = 0;
+    AssertFatal(smArena != NULL, "Error, no frame allocator on this thread!");
+    return smArena;
 }
 
-
 void* FrameAllocator::alloc(const U32 allocSize)
 {
-    AssertFatal(smBuffer != NULL, "Error, no buffer!");
-    AssertFatal(smWaterMark + allocSize <= smHighWaterMark, "Error alloc too large, increase frame size!");
-
-    // Keep all frame allocator allocations aligned to DWORD boundries on the 360
-    // Add 3, mask out the lower 3 bits.
-    smWaterMark = ( smWaterMark + ( TORQUE_BYTE_ALIGNMENT - 1 ) ) & (~( TORQUE_BYTE_ALIGNMENT - 1 ));
-
-    // Sanity check.
-    AssertFatal( !( smWaterMark & ( TORQUE_BYTE_ALIGNMENT - 1 ) ), "Frame allocation is not on a 4-byte boundry." );
-
-    U8* p = &smBuffer[smWaterMark];
-    smWaterMark += allocSize;
-
-#if defined(TORQUE_DEBUG)
-    if (smWaterMark > sgMaxFrameAllocation)
-        sgMaxFrameAllocation = smWaterMark;
-#endif
-
-    return p;
+    return getArena()->alloc(allocSize);
 }
 
-
 void FrameAllocator::setWaterMark(const U32 waterMark)
 {
-    AssertFatal(waterMark < smHighWaterMark, "Error, invalid waterMark");
-
-    smWaterMark = waterMark;
+    getArena()->setWaterMark(waterMark);
 }
 
 U32 FrameAllocator::getWaterMark()
 {
-    return smWaterMark;
+    return getArena()->getWaterMark();
 }
 
 U32 FrameAllocator::getHighWaterMark()
 {
-    return smHighWaterMark;
+    return getArena()->getSize();
+}
+
+U32 FrameAllocator::getPeakWaterMark()
+{
+    return getArena()->getPeakWaterMark();
 }
 
 /// Helper class to deal with FrameAllocator usage.
@@ -122,24 +182,35 @@ U32 FrameAllocator::getHighWaterMark()
 /// automatically restore the watermark on the FrameAllocator. In situations
 /// with complex branches, this can be a significant headache remover, as you
 /// don't have to remember to reset the FrameAllocator on every posssible branch.
+///
+/// The marker works on the calling thread's FrameAllocator, or on the
+/// ScratchArena it is given.
 class FrameAllocatorMarker
 {
+    ScratchArena* mArena;
     U32 mMarker;
 
 public:
     FrameAllocatorMarker()
     {
-        mMarker = FrameAllocator::getWaterMark();
+        mArena = FrameAllocator::getArena();
+        mMarker = mArena->getWaterMark();
+    }
+
+    explicit FrameAllocatorMarker(ScratchArena& arena)
+    {
+        mArena = &arena;
+        mMarker = mArena->getWaterMark();
     }
 
     ~FrameAllocatorMarker()
     {
-        FrameAllocator::setWaterMark(mMarker);
+        mArena->setWaterMark(mMarker);
     }
 
     void* alloc(const U32 allocSize) const
     {
-        return FrameAllocator::alloc(allocSize);
+        return mArena->alloc(allocSize);
     }
 };
 
@@ -173,6 +244,7 @@ template<class T>
 class FrameTemp
 {
 protected:
+    ScratchArena* mArena;
     U32 mWaterMark;
     T* mMemory;
 
@@ -195,14 +267,15 @@ public:
     FrameTemp(const U32 count = 1)
     {
         AssertFatal(count > 0, "Allocating a FrameTemp with less than one instance");
-        mWaterMark = FrameAllocator::getWaterMark();
-        mMemory = static_cast<T*>(FrameAllocator::alloc(sizeof(T) * count));
+        mArena = FrameAllocator::getArena();
+        mWaterMark = mArena->getWaterMark();
+        mMemory = static_cast<T*>(mArena->alloc(sizeof(T) * count));
     }
 
     /// Destructor restores the watermark
     ~FrameTemp()
     {
-        FrameAllocator::setWaterMark(mWaterMark);
+        mArena->setWaterMark(mWaterMark);
     }
 
     /// NOTE: This will return the memory, NOT perform a ones-complement
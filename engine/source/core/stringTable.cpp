@@ -5,9 +5,9 @@
 
 #include "platform/platform.h"
 #include "core/stringTable.h"
+#include "platform/platformMutex.h"
 
 _StringTable* StringTable = NULL;
-const U32 _StringTable::csm_stInitSize = 29;
 
 //---------------------------------------------------------------
 //
@@ -16,67 +16,114 @@ const U32 _StringTable::csm_stInitSize = 29;
 //---------------------------------------------------------------
 
 namespace {
-    bool sgInitTable = true;
-    U8   sgHashTable[256];
+    const U64 sgOnes = 0x0101010101010101ULL;
+    const U64 sgHighBits = 0x8080808080808080ULL;
+    const U64 sgHashMul = 0x9E3779B97F4A7C15ULL;
 
-    void initTolowerTable()
+    /// Lower case the ASCII letters in eight bytes at once, the same as
+    /// dTolower() on each byte.
+    inline U64 foldCase(U64 w)
     {
-        for (U32 i = 0; i < 256; i++) {
-            U8 c = dTolower(i);
-            sgHashTable[i] = c * c;
-        }
+        // With the top bit of each byte cleared the adds can't carry into
+        // the next byte, and leave the top bit set where the byte is at
+        // least 'A', or past 'Z'.
+        U64 low7 = w & ~sgHighBits;
+        U64 atLeastA = low7 + sgOnes * (0x80 - 'A');
+        U64 pastZ = low7 + sgOnes * (0x80 - 'Z' - 1);
+        U64 upper = atLeastA & ~pastZ & ~w & sgHighBits;
+        return w | (upper >> 2);
+    }
+
+    /// Read up to eight bytes, zero filled.  Written out a byte at a time
+    /// so it hashes the same on any endian, the compiler turns the full
+    /// word case into a single load.
+    inline U64 loadWord(const char* str, U32 len)
+    {
+        const U8* p = reinterpret_cast<const U8*>(str);
+        U64 w = 0;
+        for (U32 i = 0; i < len; i++)
+            w |= U64(p[i]) << (i * 8);
+        return w;
+    }
+
+    inline U64 mixWord(U64 h, U64 w)
+    {
+        h = (h ^ w) * sgHashMul;
+        return h ^ (h >> 29);
+    }
+
+    U32 hashFolded(const char* str, U32 len)
+    {
+        U64 h = len * sgHashMul;
+
+        U32 i = 0;
+        for (; i + 8 <= len; i += 8)
+            h = mixWord(h, foldCase(loadWord(str + i, 8)));
+        if (i < len)
+            h = mixWord(h, foldCase(loadWord(str + i, len - i)));
+
+        // Finish off so both the top bits (stripe) and the low bits
+        // (bucket) depend on every byte.
+        h *= sgHashMul;
+        h ^= h >> 32;
+        return U32(h);
+    }
+
+    /// Case insensitive compare of two strings of the same length.
+    bool equalsFolded(const char* a, const char* b, U32 len)
+    {
+        U32 i = 0;
+        for (; i + 8 <= len; i += 8)
+            if (foldCase(loadWord(a + i, 8)) != foldCase(loadWord(b + i, 8)))
+                return false;
+        return i == len || foldCase(loadWord(a + i, len - i)) == foldCase(loadWord(b + i, len - i));
+    }
 
-        sgInitTable = false;
+    U32 strLength(const char* str, S32 maxLen)
+    {
+        U32 len = 0;
+        while (len < U32(maxLen) && str[len])
+            len++;
+        return len;
     }
 
 } // namespace {}
 
 U32 _StringTable::hashString(const char* str)
 {
-    if (sgInitTable)
-        initTolowerTable();
-
     if (!str) return -1;
 
-    U32 ret = 0;
-    char c;
-    while ((c = *str++) != 0) {
-        ret <<= 1;
-        ret ^= sgHashTable[static_cast<U8>(c)];
-    }
-    return ret;
+    return hashFolded(str, dStrlen(str));
 }
 
 U32 _StringTable::hashStringn(const char* str, S32 len)
 {
-    if (sgInitTable)
-        initTolowerTable();
-
-    U32 ret = 0;
-    char c;
-    while ((c = *str++) != 0 && len--) {
-        ret <<= 1;
-        ret ^= sgHashTable[c];
-    }
-    return ret;
+    return hashFolded(str, strLength(str, len));
 }
 
 //--------------------------------------
 _StringTable::_StringTable()
 {
-    buckets = (Node**)dMalloc(csm_stInitSize * sizeof(Node*));
-    for (U32 i = 0; i < csm_stInitSize; i++) {
-        buckets[i] = 0;
-    }
+    for (U32 i = 0; i < NumStripes; i++) {
+        Stripe& stripe = mStripes[i];
+        stripe.mutex = Mutex::createMutex();
+        stripe.buckets = (Node**)dMalloc(InitStripeBuckets * sizeof(Node*));
+        for (U32 j = 0; j < InitStripeBuckets; j++) {
+            stripe.buckets[j] = 0;
+        }
 
-    numBuckets = csm_stInitSize;
-    itemCount = 0;
+        stripe.numBuckets = InitStripeBuckets;
+        stripe.itemCount = 0;
+    }
 }
 
 //--------------------------------------
 _StringTable::~_StringTable()
 {
-    dFree(buckets);
+    for (U32 i = 0; i < NumStripes; i++) {
+        dFree(mStripes[i].buckets);
+        Mutex::destroyMutex(mStripes[i].mutex);
+    }
 }
 
 
@@ -98,108 +145,130 @@ void _StringTable::destroy()
 
 
 //--------------------------------------
-StringTableEntry _StringTable::insert(const char* val, const bool  caseSens)
+_StringTable::Node* _StringTable::find(Stripe& stripe, U32 hash, const char* val, U32 len, bool caseSens)
 {
-    Node** walk, * temp;
-    U32 key = hashString(val);
-    walk = &buckets[key % numBuckets];
-    while ((temp = *walk) != NULL) {
-        if (caseSens && !dStrcmp(temp->val, val))
-            return temp->val;
-        else if (!caseSens && !dStricmp(temp->val, val))
-            return temp->val;
-        walk = &(temp->next);
-    }
-    char* ret = 0;
-    if (!*walk) {
-        *walk = (Node*)mempool.alloc(sizeof(Node));
-        (*walk)->next = 0;
-        (*walk)->val = (char*)mempool.alloc(dStrlen(val) + 1);
-        dStrcpy((*walk)->val, val);
-        ret = (*walk)->val;
-        itemCount++;
-    }
-    if (itemCount > 2 * numBuckets) {
-        resize(4 * numBuckets - 1);
+    // New strings go on the end of the chains, so the case insensitive
+    // match found is always the first one inserted.
+    for (Node* walk = stripe.buckets[hash & (stripe.numBuckets - 1)]; walk; walk = walk->next) {
+        if (walk->hash != hash || walk->len != len)
+            continue;
+        if (caseSens ? !dMemcmp(walk->val, val, len) : equalsFolded(walk->val, val, len))
+            return walk;
     }
-    return ret;
+    return NULL;
 }
 
 //--------------------------------------
-StringTableEntry _StringTable::insertn(const char* src, S32 len, const bool  caseSens)
+StringTableEntry _StringTable::insert(const char* val, const bool caseSens)
 {
-    char val[256];
-    AssertFatal(len < 255, "Invalid string to insertn");
-    dStrncpy(val, src, len);
-    val[len] = 0;
-    return insert(val, caseSens);
+    return insertn(val, dStrlen(val), caseSens);
 }
 
 //--------------------------------------
-StringTableEntry _StringTable::lookup(const char* val, const bool  caseSens)
+StringTableEntry _StringTable::insertn(const char* src, S32 len, const bool caseSens)
 {
-    Node** walk, * temp;
-    U32 key = hashString(val);
-    walk = &buckets[key % numBuckets];
-    while ((temp = *walk) != NULL) {
-        if (caseSens && !dStrcmp(temp->val, val))
-            return temp->val;
-        else if (!caseSens && !dStricmp(temp->val, val))
-            return temp->val;
-        walk = &(temp->next);
+    U32 length = strLength(src, len);
+    U32 key = hashFolded(src, length);
+    Stripe& stripe = getStripe(key);
+
+    MutexHandle handle;
+    handle.lock(stripe.mutex);
+
+    Node* node = find(stripe, key, src, length, caseSens);
+    if (node)
+        return node->val;
+
+    // The node and its string share one allocation, rounded up so the
+    // next node stays pointer aligned.
+    node = (Node*)stripe.mempool.alloc((sizeof(Node) + length + 8) & ~7);
+    node->next = 0;
+    node->hash = key;
+    node->len = length;
+    node->val = (char*)(node + 1);
+    dMemcpy(node->val, src, length);
+    node->val[length] = 0;
+
+    Node** walk = &stripe.buckets[key & (stripe.numBuckets - 1)];
+    while (*walk)
+        walk = &(*walk)->next;
+    *walk = node;
+
+    if (++stripe.itemCount > 2 * stripe.numBuckets) {
+        resizeStripe(stripe, 4 * stripe.numBuckets);
     }
-    return NULL;
+    return node->val;
 }
 
 //--------------------------------------
-StringTableEntry _StringTable::lookupn(const char* val, S32 len, const bool  caseSens)
+StringTableEntry _StringTable::lookup(const char* val, const bool caseSens)
 {
-    Node** walk, * temp;
-    U32 key = hashStringn(val, len);
-    walk = &buckets[key % numBuckets];
-    while ((temp = *walk) != NULL) {
-        if (caseSens && !dStrncmp(temp->val, val, len) && temp->val[len] == 0)
-            return temp->val;
-        else if (!caseSens && !dStrnicmp(temp->val, val, len) && temp->val[len] == 0)
-            return temp->val;
-        walk = &(temp->next);
-    }
-    return NULL;
+    return lookupn(val, dStrlen(val), caseSens);
 }
 
 //--------------------------------------
-void _StringTable::resize(const U32 newSize)
+StringTableEntry _StringTable::lookupn(const char* val, S32 len, const bool caseSens)
 {
-    Node* head = NULL, * walk, * temp;
-    U32 i;
-    // reverse individual bucket lists
-    // we do this because new strings are added at the end of bucket
-    // lists so that case sens strings are always after their
-    // corresponding case insens strings
-
-    for (i = 0; i < numBuckets; i++) {
-        walk = buckets[i];
-        while (walk)
-        {
-            temp = walk->next;
-            walk->next = head;
-            head = walk;
-            walk = temp;
-        }
-    }
-    buckets = (Node**)dRealloc(buckets, newSize * sizeof(Node));
-    for (i = 0; i < newSize; i++) {
+    U32 length = strLength(val, len);
+    U32 key = hashFolded(val, length);
+    Stripe& stripe = getStripe(key);
+
+    MutexHandle handle;
+    handle.lock(stripe.mutex);
+
+    Node* node = find(stripe, key, val, length, caseSens);
+    return node ? node->val : NULL;
+}
+
+//--------------------------------------
+void _StringTable::resizeStripe(Stripe& stripe, U32 newSize)
+{
+    AssertFatal(newSize && (newSize & (newSize - 1)) == 0, "StringTable::resizeStripe: bucket count must be a power of two.");
+    if (newSize == stripe.numBuckets)
+        return;
+
+    Node** oldBuckets = stripe.buckets;
+    U32 oldSize = stripe.numBuckets;
+
+    Node** buckets = (Node**)dMalloc(newSize * sizeof(Node*));
+    Node*** tails = (Node***)dMalloc(newSize * sizeof(Node**));
+    for (U32 i = 0; i < newSize; i++) {
         buckets[i] = 0;
+        tails[i] = &buckets[i];
     }
-    numBuckets = newSize;
-    walk = head;
-    while (walk) {
-        U32 key;
-        Node* temp = walk;
-
-        walk = walk->next;
-        key = hashString(temp->val);
-        temp->next = buckets[key % newSize];
-        buckets[key % newSize] = temp;
+
+    // Append to the new chains so strings with the same hash stay in the
+    // order they were inserted, and case sensitive strings stay after
+    // their case insensitive twins.
+    for (U32 i = 0; i < oldSize; i++) {
+        Node* walk = oldBuckets[i];
+        while (walk) {
+            Node* temp = walk;
+            walk = walk->next;
+
+            U32 index = temp->hash & (newSize - 1);
+            temp->next = NULL;
+            *tails[index] = temp;
+            tails[index] = &temp->next;
+        }
+    }
+
+    dFree(tails);
+    dFree(oldBuckets);
+    stripe.buckets = buckets;
+    stripe.numBuckets = newSize;
+}
+
+//--------------------------------------
+void _StringTable::resize(const U32 newSize)
+{
+    // Spread the size over the stripes, rounded up to a power of two
+    U32 stripeSize = InitStripeBuckets;
+    while (stripeSize * NumStripes < newSize)
+        stripeSize <<= 1;
+
+    for (U32 i = 0; i < NumStripes; i++) {
+        MutexHandle handle;
+        handle.lock(mStripes[i].mutex);
+        resizeStripe(mStripes[i], stripeSize);
     }
-}
\ No newline at end of file
+}
@@ -56,6 +56,11 @@
 /// @note Be aware that the StringTable NEVER DEALLOCATES memory, so be careful when you
 ///       add strings to it. If you carelessly add many strings, you will end up wasting
 ///       space.
+///
+/// The table may be used from any thread.  It is split into stripes by hash, each with
+/// its own lock, buckets and memory pool, so threads only contend when they hit the
+/// same stripe at the same time.  Each entry keeps its hash and length, so a chain walk
+/// only compares the characters of strings that are almost certainly a match.
 class _StringTable
 {
 private:
@@ -67,16 +72,39 @@ private:
     {
         char* val;
         Node* next;
+        U32   hash;
+        U32   len;
     };
 
-    Node** buckets;
-    U32         numBuckets;
-    U32         itemCount;
-    DataChunker mempool;
+    enum Constants
+    {
+        NumStripes = 16,        ///< Must be a power of two.
+        StripeShift = 28,       ///< Picks the stripe from the top bits of the hash.
+        InitStripeBuckets = 16, ///< Must be a power of two.
+    };
 
-protected:
-    static const U32 csm_stInitSize;
+    /// One independently locked part of the table.  The bucket is picked
+    /// from the low bits of the hash, the stripe from the high bits.
+    struct Stripe
+    {
+        void* mutex;
+        Node** buckets;
+        U32         numBuckets;
+        U32         itemCount;
+        DataChunker mempool;
+    };
 
+    Stripe mStripes[NumStripes];
+
+    Stripe& getStripe(U32 hash) { return mStripes[hash >> StripeShift]; }
+
+    /// Find a string in a stripe, which must be locked.
+    Node* find(Stripe& stripe, U32 hash, const char* string, U32 len, bool caseSens);
+
+    /// Rehash a stripe into newSize buckets.  The stripe must be locked.
+    void resizeStripe(Stripe& stripe, U32 newSize);
+
+protected:
     _StringTable();
     ~_StringTable();
 
@@ -125,16 +153,17 @@ public:
 
 
     /// Resize the StringTable to be able to hold newSize items. This
-    /// is called automatically by the StringTable when the table is
-    /// full past a certain threshhold.
+    /// is called automatically, a stripe at a time, by the StringTable
+    /// when a stripe is full past a certain threshhold.
     ///
     /// @param newSize   Number of new items to allocate space for.
     void             resize(const U32 newSize);
 
-    /// Hash a string into a U32.
+    /// Hash a string into a U32.  The hash ignores case, so strings which
+    /// only differ in case hash the same.
     static U32 hashString(const char* in_pString);
 
-    /// Hash a string of given length into a U32.
+    /// Hash a string of given length into a U32.  Stops early at a null.
     static U32 hashStringn(const char* in_pString, S32 len);
 };
 
@@ -0,0 +1,141 @@
+//-----------------------------------------------------------------------------
+// Torque Game Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#ifndef _TSPSCQUEUE_H_
+#define _TSPSCQUEUE_H_
+
+//Includes
+#ifndef _PLATFORM_H_
+#include "platform/platform.h"
+#endif
+#ifndef _PLATFORMASSERT_H_
+#include "platform/platformAssert.h"
+#endif
+
+#include <atomic>
+
+/// Fixed size, lock free, single producer / single consumer queue.
+///
+/// Exactly one thread may write and exactly one (other) thread may read.
+/// Elements live in place in the ring, so large elements (packet buffers,
+/// for instance) can be filled and consumed without extra copies:
+///
+/// @code
+/// // producer
+/// if (T* slot = queue.beginPush())
+/// {
+///    fill(slot);
+///    queue.endPush();
+/// }
+///
+/// // consumer
+/// while (T* slot = queue.front())
+/// {
+///    use(slot);
+///    queue.pop();
+/// }
+/// @endcode
+template <class T>
+class SPSCQueue
+{
+protected:
+    T* mElements;
+    U32 mMask;
+
+    std::atomic<U32> mHead;   ///< Next slot to read; written by the consumer only.
+    std::atomic<U32> mTail;   ///< Next slot to write; written by the producer only.
+
+public:
+    /// @param capacity Number of slots, must be a power of two.
+    SPSCQueue(const U32 capacity);
+    ~SPSCQueue();
+
+    U32 capacity() const { return mMask + 1; }
+    bool empty() const { return mHead.load(std::memory_order_acquire) == mTail.load(std::memory_order_acquire); }
+
+    /// @name Producer side
+    /// @{
+
+    /// Returns the slot to fill, or NULL if the queue is full.
+    T* beginPush();
+
+    /// Publish the slot returned by beginPush() to the consumer.
+    void endPush();
+
+    /// Copy an element in; returns false if the queue is full.
+    bool push(const T& element);
+
+    /// @}
+
+    /// @name Consumer side
+    /// @{
+
+    /// Returns the oldest element, or NULL if the queue is empty.
+    T* front();
+
+    /// Release the element returned by front() back to the producer.
+    void pop();
+
+    /// @}
+};
+
+template <class T>
+inline SPSCQueue<T>::SPSCQueue(const U32 capacity)
+    : mHead(0), mTail(0)
+{
+    AssertFatal(capacity > 0 && (capacity & (capacity - 1)) == 0, "SPSCQueue: capacity must be a power of two");
+
+    mElements = new T[capacity];
+    mMask = capacity - 1;
+}
+
+template <class T>
+inline SPSCQueue<T>::~SPSCQueue()
+{
+    delete[] mElements;
+}
+
+template <class T>
+inline T* SPSCQueue<T>::beginPush()
+{
+    U32 tail = mTail.load(std::memory_order_relaxed);
+    if (tail - mHead.load(std::memory_order_acquire) > mMask)
+        return NULL;
+    return &mElements[tail & mMask];
+}
+
+template <class T>
+inline void SPSCQueue<T>::endPush()
+{
+    mTail.store(mTail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+template <class T>
+inline bool SPSCQueue<T>::push(const T& element)
+{
+    T* slot = beginPush();
+    if (!slot)
+        return false;
+    *slot = element;
+    endPush();
+    return true;
+}
+
+template <class T>
+inline T* SPSCQueue<T>::front()
+{
+    U32 head = mHead.load(std::memory_order_relaxed);
+    if (head == mTail.load(std::memory_order_acquire))
+        return NULL;
+    return &mElements[head & mMask];
+}
+
+template <class T>
+inline void SPSCQueue<T>::pop()
+{
+    mHead.store(mHead.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+#endif //_TSPSCQUEUE_H_
@@ -167,6 +167,14 @@
 /// dumpUnflaggedAllocs() function of the memory manager.
 #define TORQUE_ENABLE_PROFILE_PATH
 
+/// Define me to compile in the allocation profiler (platform/allocProfiler.h).
+/// While it is turned on with allocProfilerEnable(true), every dMalloc is
+/// counted against its file and line and the innermost PROFILE_START zone,
+/// and allocProfilerDump() prints the bytes and allocations per frame.
+/// Turned off it costs a test of one flag per allocation.  Needs
+/// TORQUE_ENABLE_PROFILER.
+#define TORQUE_ALLOC_PROFILER
+
 /// Define me to enable a variety of network debugging aids.
 //#define TORQUE_DEBUG_NET
 
@@ -199,6 +207,16 @@
 /// available.
 #define TORQUE_DISABLE_MEMORY_MANAGER
 
+/// Define me to serve dMalloc, dFree and dRealloc from the size class
+/// allocator (platform/sizeClassAllocator.h) instead of the system, while
+/// the Torque Memory Manager is disabled.  It keeps per-thread free lists,
+/// so allocation heavy code doesn't fight over the system heap's lock.
+/// operator new is left to the system either way.
+///
+/// To get the tracking manager and its leak dumps back, comment out
+/// TORQUE_DISABLE_MEMORY_MANAGER above; this is then ignored.
+#define TORQUE_SIZE_CLASS_ALLOCATOR
+
 /// Define me if you want to enable debug guards in the memory manager.
 ///
 /// Debug guards are known values placed before and after every block of
@@ -245,6 +263,10 @@
 /// texture manager.
 #define TORQUE_FRAME_SIZE     16 << 20
 
+/// The size of the FrameAllocator given to each ThreadPool worker, and the
+/// default for other threads which ask for one.
+#define TORQUE_THREAD_FRAME_SIZE  1 << 20
+
 /// Define if you want nVIDIA's NVPerfHUD to work with TSE
 #define TORQUE_NVPERFHUD
 
@@ -288,6 +310,10 @@
 #  define TORQUE_ENABLE_PROFILER
 #endif
 
+#if defined(TORQUE_ALLOC_PROFILER) && !defined(TORQUE_ENABLE_PROFILER)
+#  undef TORQUE_ALLOC_PROFILER
+#endif
+
 #ifdef TORQUE_LIB
 #ifndef TORQUE_NO_OGGVORBIS
 #define TORQUE_NO_OGGVORBIS
@@ -17,6 +17,7 @@ public:
     void textureKill();
     void textureResurrect();
     void refreshWindow();
+    S32 getIdleTimeout();
 
     int main(int argc, const char** argv);
 
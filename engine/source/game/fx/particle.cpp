@@ -7,6 +7,10 @@
 #include "core/bitStream.h"
 #include "math/mRandom.h"
 
+#ifdef TORQUE_SUPPORTS_SSE
+#include <xmmintrin.h>
+#endif
+
 static ParticleData gDefaultParticleData;
 
 
@@ -310,3 +314,268 @@ void ParticleData::initializeParticle(Particle* init, const Point3F& inheritVelo
     init->spinSpeed = spinSpeed + gRandGen.randF(spinRandomMin, spinRandomMax);
 }
 
+
+
+//*****************************************************************************
+// ParticleList
+//*****************************************************************************
+ParticleList::ParticleList()
+{
+    mMemory = NULL;
+    mSize = 0;
+    mCapacity = 0;
+    for (U32 i = 0; i < NumStreams; i++)
+        mStreams[i] = NULL;
+}
+
+ParticleList::~ParticleList()
+{
+    dFree(mMemory);
+}
+
+//-----------------------------------------------------------------------------
+// reserve
+//-----------------------------------------------------------------------------
+void ParticleList::reserve(U32 count)
+{
+    if (count <= mCapacity)
+        return;
+
+    // Grow in whole lane groups, and at least double so emitters that keep
+    // growing one particle at a time don't reallocate every time.
+    U32 capacity = getMax(count, mCapacity * 2);
+    capacity = (capacity + Lanes - 1) & ~(Lanes - 1);
+
+    // One block for all streams, with room to align the first one to 16
+    // bytes.  Stream lengths are multiples of four floats so the rest follow.
+    U8* memory = (U8*)dMalloc(capacity * NumStreams * sizeof(F32) + 15);
+    dMemset(memory, 0, capacity * NumStreams * sizeof(F32) + 15);
+    F32* base = (F32*)((dsize_t(memory) + 15) & ~dsize_t(15));
+
+    for (U32 i = 0; i < NumStreams; i++)
+    {
+        F32* stream = base + i * capacity;
+        if (mSize)
+            dMemcpy(stream, mStreams[i], mSize * sizeof(F32));
+        mStreams[i] = stream;
+    }
+
+    dFree(mMemory);
+    mMemory = memory;
+    mCapacity = capacity;
+}
+
+//-----------------------------------------------------------------------------
+// add
+//-----------------------------------------------------------------------------
+U32 ParticleList::add(const Particle& part)
+{
+    if (mSize == mCapacity)
+        reserve(mSize + 1);
+
+    U32 i = mSize++;
+    mStreams[PosX][i] = part.pos.x;
+    mStreams[PosY][i] = part.pos.y;
+    mStreams[PosZ][i] = part.pos.z;
+    mStreams[VelX][i] = part.vel.x;
+    mStreams[VelY][i] = part.vel.y;
+    mStreams[VelZ][i] = part.vel.z;
+    mStreams[AccX][i] = part.acc.x;
+    mStreams[AccY][i] = part.acc.y;
+    mStreams[AccZ][i] = part.acc.z;
+    mStreams[OrientX][i] = part.orientDir.x;
+    mStreams[OrientY][i] = part.orientDir.y;
+    mStreams[OrientZ][i] = part.orientDir.z;
+    mStreams[ColorR][i] = part.color.red;
+    mStreams[ColorG][i] = part.color.green;
+    mStreams[ColorB][i] = part.color.blue;
+    mStreams[ColorA][i] = part.color.alpha;
+    mStreams[Size][i] = part.size;
+    mStreams[SpinSpeed][i] = part.spinSpeed;
+    mStreams[Age][i] = F32(part.currentAge);
+    mStreams[Lifetime][i] = F32(part.totalLifetime);
+    return i;
+}
+
+//-----------------------------------------------------------------------------
+// remove
+//-----------------------------------------------------------------------------
+void ParticleList::remove(U32 index)
+{
+    AssertFatal(index < mSize, "ParticleList::remove - index out of range");
+
+    U32 last = --mSize;
+    if (index != last)
+        for (U32 s = 0; s < NumStreams; s++)
+            mStreams[s][index] = mStreams[s][last];
+}
+
+//-----------------------------------------------------------------------------
+// age
+//-----------------------------------------------------------------------------
+void ParticleList::age(U32 ms)
+{
+    F32* ages = mStreams[Age];
+    const F32* lifetimes = mStreams[Lifetime];
+    const U32 count = paddedSize();
+
+#ifdef TORQUE_SUPPORTS_SSE
+    const __m128 delta = _mm_set1_ps(F32(ms));
+    for (U32 i = 0; i < count; i += Lanes)
+        _mm_store_ps(ages + i, _mm_add_ps(_mm_load_ps(ages + i), delta));
+#else
+    for (U32 i = 0; i < count; i++)
+        ages[i] += F32(ms);
+#endif
+
+    // Removal swaps the last particle in, so only advance when we keep one.
+    for (U32 i = 0; i < mSize; )
+    {
+        if (ages[i] > lifetimes[i])
+            remove(i);
+        else
+            i++;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// integrate
+//-----------------------------------------------------------------------------
+void ParticleList::integrate(F32 dt, const Point3F& accel, F32 drag)
+{
+    const U32 count = paddedSize();
+
+#ifdef TORQUE_SUPPORTS_SSE
+    const __m128 t = _mm_set1_ps(dt);
+    const __m128 d = _mm_set1_ps(drag);
+
+    for (U32 axis = 0; axis < 3; axis++)
+    {
+        F32* pos = mStreams[PosX + axis];
+        F32* vel = mStreams[VelX + axis];
+        const F32* acc = mStreams[AccX + axis];
+        const __m128 c = _mm_set1_ps(accel[axis]);
+
+        for (U32 i = 0; i < count; i += Lanes)
+        {
+            // a = acc - vel * drag + accel
+            __m128 v = _mm_load_ps(vel + i);
+            __m128 a = _mm_add_ps(_mm_sub_ps(_mm_load_ps(acc + i), _mm_mul_ps(v, d)), c);
+            v = _mm_add_ps(v, _mm_mul_ps(a, t));
+            _mm_store_ps(vel + i, v);
+            _mm_store_ps(pos + i, _mm_add_ps(_mm_load_ps(pos + i), _mm_mul_ps(v, t)));
+        }
+    }
+#else
+    for (U32 axis = 0; axis < 3; axis++)
+    {
+        F32* pos = mStreams[PosX + axis];
+        F32* vel = mStreams[VelX + axis];
+        const F32* acc = mStreams[AccX + axis];
+        const F32 c = accel[axis];
+
+        for (U32 i = 0; i < count; i++)
+        {
+            F32 a = acc[i] - vel[i] * drag + c;
+            vel[i] += a * dt;
+            pos[i] += vel[i] * dt;
+        }
+    }
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// updateKeyData - single particle
+//-----------------------------------------------------------------------------
+inline void ParticleList::updateKeyData(U32 i, const F32* times, const F32* invTotal, const ColorF* colors, const F32* sizes)
+{
+    F32 t = mStreams[Age][i] / mStreams[Lifetime][i];
+    for (U32 k = 1; k < ParticleData::PDC_NUM_KEYS; k++)
+    {
+        if (times[k] >= t)
+        {
+            F32 f = (t - times[k - 1]) * invTotal[k];
+            mStreams[ColorR][i] = colors[k - 1].red + (colors[k].red - colors[k - 1].red) * f;
+            mStreams[ColorG][i] = colors[k - 1].green + (colors[k].green - colors[k - 1].green) * f;
+            mStreams[ColorB][i] = colors[k - 1].blue + (colors[k].blue - colors[k - 1].blue) * f;
+            mStreams[ColorA][i] = colors[k - 1].alpha + (colors[k].alpha - colors[k - 1].alpha) * f;
+            mStreams[Size][i] = sizes[k - 1] + (sizes[k] - sizes[k - 1]) * f;
+            break;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// updateKeyData
+//
+// A particle uses the first key segment whose end time is at or past its
+// normalized age.  Segments are walked from last to first, each one
+// overwriting the lanes it applies to, so the first matching segment wins.
+// Particles past the last key keep their current color and size.
+//-----------------------------------------------------------------------------
+void ParticleList::updateKeyData(U32 start, U32 count, const F32* times, const ColorF* colors, const F32* sizes)
+{
+    F32 invTotal[ParticleData::PDC_NUM_KEYS];
+    for (U32 k = 1; k < ParticleData::PDC_NUM_KEYS; k++)
+    {
+        F32 total = times[k] - times[k - 1];
+        invTotal[k] = total > 0.0f ? 1.0f / total : 0.0f;
+    }
+
+    U32 i = start;
+    U32 end = start + count;
+
+#ifdef TORQUE_SUPPORTS_SSE
+    // Scalar up to a lane boundary, then whole lane groups, then the rest.
+    // A range that ends at the end of the list may finish with a partial
+    // group, the streams are padded for that.
+    U32 vectorEnd = (end == mSize) ? paddedSize() : (end & ~(Lanes - 1));
+    for (; i < end && (i & (Lanes - 1)); i++)
+        updateKeyData(i, times, invTotal, colors, sizes);
+
+    F32* red = mStreams[ColorR];
+    F32* green = mStreams[ColorG];
+    F32* blue = mStreams[ColorB];
+    F32* alpha = mStreams[ColorA];
+    F32* size = mStreams[Size];
+    const F32* ages = mStreams[Age];
+    const F32* lifetimes = mStreams[Lifetime];
+
+    for (; i < vectorEnd; i += Lanes)
+    {
+        const __m128 t = _mm_div_ps(_mm_load_ps(ages + i), _mm_load_ps(lifetimes + i));
+
+        __m128 r = _mm_load_ps(red + i);
+        __m128 g = _mm_load_ps(green + i);
+        __m128 b = _mm_load_ps(blue + i);
+        __m128 a = _mm_load_ps(alpha + i);
+        __m128 s = _mm_load_ps(size + i);
+
+        for (S32 k = ParticleData::PDC_NUM_KEYS - 1; k >= 1; k--)
+        {
+            const __m128 mask = _mm_cmpge_ps(_mm_set1_ps(times[k]), t);
+            const __m128 f = _mm_mul_ps(_mm_sub_ps(t, _mm_set1_ps(times[k - 1])), _mm_set1_ps(invTotal[k]));
+
+#define blendKey(dst, from, to) \
+            dst = _mm_or_ps(_mm_andnot_ps(mask, dst), _mm_and_ps(mask, \
+                _mm_add_ps(_mm_set1_ps(from), _mm_mul_ps(_mm_set1_ps((to) - (from)), f))));
+
+            blendKey(r, colors[k - 1].red, colors[k].red);
+            blendKey(g, colors[k - 1].green, colors[k].green);
+            blendKey(b, colors[k - 1].blue, colors[k].blue);
+            blendKey(a, colors[k - 1].alpha, colors[k].alpha);
+            blendKey(s, sizes[k - 1], sizes[k]);
+#undef blendKey
+        }
+
+        _mm_store_ps(red + i, r);
+        _mm_store_ps(green + i, g);
+        _mm_store_ps(blue + i, b);
+        _mm_store_ps(alpha + i, a);
+        _mm_store_ps(size + i, s);
+    }
+#endif
+
+    for (; i < end; i++)
+        updateKeyData(i, times, invTotal, colors, sizes);
+}
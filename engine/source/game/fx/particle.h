@@ -76,7 +76,8 @@ public:
 //*****************************************************************************
 // Particle
 // 
-// This structure should be as small as possible.
+// State of a single particle.  Live particles are stored in a ParticleList,
+// this is only used to set up a new one.
 //*****************************************************************************
 struct Particle
 {
@@ -99,4 +100,92 @@ struct Particle
 };
 
 
-#endif // _PARTICLE_H_
\ No newline at end of file
+//*****************************************************************************
+// ParticleList
+//
+// Structure of arrays storage for the live particles of one emitter.  Every
+// stream is 16 byte aligned and padded to a multiple of four entries so the
+// update kernels can work on four particles at a time.  All particles in a
+// list share one ParticleData.
+//*****************************************************************************
+class ParticleList
+{
+public:
+    enum Constants
+    {
+        Lanes = 4,
+    };
+
+    enum Streams
+    {
+        PosX, PosY, PosZ,
+        VelX, VelY, VelZ,
+        AccX, AccY, AccZ,
+        OrientX, OrientY, OrientZ,
+        ColorR, ColorG, ColorB, ColorA,
+        Size,
+        SpinSpeed,
+        Age,        ///< ms, kept as float so the kernels need only SSE1
+        Lifetime,
+        NumStreams
+    };
+
+private:
+    U8* mMemory;
+    F32* mStreams[NumStreams];
+    U32 mSize;
+    U32 mCapacity;
+
+public:
+    ParticleList();
+    ~ParticleList();
+
+    U32 size() const { return mSize; }
+    U32 capacity() const { return mCapacity; }
+    bool empty() const { return mSize == 0; }
+
+    /// Grow storage to hold at least count particles.  Existing particles are kept.
+    void reserve(U32 count);
+    void clear() { mSize = 0; }
+
+    /// Number of entries the kernels touch: size() rounded up to a whole lane group.
+    U32 paddedSize() const { return (mSize + Lanes - 1) & ~(Lanes - 1); }
+
+    /// Append a particle, growing storage if needed.  Returns its index.
+    U32 add(const Particle& part);
+
+    /// Remove a particle by moving the last one into its slot.
+    void remove(U32 index);
+
+    F32* stream(U32 s) { return mStreams[s]; }
+    const F32* stream(U32 s) const { return mStreams[s]; }
+    Point3F getPos(U32 i) const { return Point3F(mStreams[PosX][i], mStreams[PosY][i], mStreams[PosZ][i]); }
+    Point3F getVel(U32 i) const { return Point3F(mStreams[VelX][i], mStreams[VelY][i], mStreams[VelZ][i]); }
+    Point3F getOrientDir(U32 i) const { return Point3F(mStreams[OrientX][i], mStreams[OrientY][i], mStreams[OrientZ][i]); }
+    ColorF getColor(U32 i) const { return ColorF(mStreams[ColorR][i], mStreams[ColorG][i], mStreams[ColorB][i], mStreams[ColorA][i]); }
+    F32 getSize(U32 i) const { return mStreams[Size][i]; }
+    F32 getSpinSpeed(U32 i) const { return mStreams[SpinSpeed][i]; }
+    F32 getAge(U32 i) const { return mStreams[Age][i]; }
+
+    /// @name Update kernels
+    /// @{
+
+    /// Add ms to every particle's age and remove the ones that expired.
+    void age(U32 ms);
+
+    /// Integrate velocity and position over dt seconds.
+    /// @param   accel   Acceleration shared by all particles (gravity and wind).
+    /// @param   drag    Drag coefficient.
+    void integrate(F32 dt, const Point3F& accel, F32 drag);
+
+    /// Interpolate color and size from the keys for particles [start, start + count).
+    void updateKeyData(U32 start, U32 count, const F32* times, const ColorF* colors, const F32* sizes);
+
+    /// @}
+
+private:
+    inline void updateKeyData(U32 i, const F32* times, const F32* invTotal, const ColorF* colors, const F32* sizes);
+};
+
+
+#endif // _PARTICLE_H_
@@ -13,9 +13,13 @@
 #include "gfx/primBuilder.h"
 #include "renderInstance/renderInstMgr.h"
 #include "game/gameProcess.h"
+#include "platform/threadPool.h"
 
 static ParticleEmitterData gDefaultEmitterData;
 Point3F ParticleEmitter::mWindVelocity(0.0, 0.0, 0.0);
+S32 ParticleEmitter::smMaxParticles = 8192;
+S32 ParticleEmitter::smLiveParticles = 0;
+U32 ParticleEmitter::smDroppedParticles = 0;
 
 IMPLEMENT_CO_DATABLOCK_V1(ParticleEmitterData);
 
@@ -84,6 +88,18 @@ void ParticleEmitterData::initPersistFields()
     addField("useEmitterColors", TypeBool, Offset(useEmitterColors, ParticleEmitterData));
 }
 
+//-----------------------------------------------------------------------------
+// consoleInit - ParticleEmitter isn't a console class, so its globals live here
+//-----------------------------------------------------------------------------
+void ParticleEmitterData::consoleInit()
+{
+    Con::addVariable("$pref::Particles::maxParticles", TypeS32, &ParticleEmitter::smMaxParticles);
+    Con::addVariable("$Particles::liveCount", TypeS32, &ParticleEmitter::smLiveParticles);
+    Con::addVariable("$Particles::dropped", TypeS32, &ParticleEmitter::smDroppedParticles);
+
+    ParticleEmitter::initBatchRender();
+}
+
 //-----------------------------------------------------------------------------
 // packData
 //-----------------------------------------------------------------------------
@@ -260,64 +276,24 @@ bool ParticleEmitterData::preload(bool server, char errorBuffer[256])
 
     if (!server)
     {
-        allocPrimBuffer();
+        calcPartListSize();
     }
 
     return true;
 }
 
 //-----------------------------------------------------------------------------
-// alloc PrimitiveBuffer
-// The datablock allocates this static index buffer because it's the same
-// for all of the emitters - each particle quad uses the same index ordering
+// calcPartListSize
+// Estimate how many particles an emitter will have alive at once, so it can
+// reserve that many up front
 //-----------------------------------------------------------------------------
-void ParticleEmitterData::allocPrimBuffer(S32 overrideSize)
+void ParticleEmitterData::calcPartListSize()
 {
-    // calculate particle list size
     U32 partLife = particleDataBlock->lifetimeMS;
     U32 maxPartLife = partLife + particleDataBlock->lifetimeVarianceMS;
 
     partListInitSize = maxPartLife / (ejectionPeriodMS - periodVarianceMS);
     partListInitSize += 8; // add 8 as "fudge factor" to make sure it doesn't realloc if it goes over by 1
-
-    // if override size is specified, then the emitter overran its buffer and needs a larger allocation
-    if (overrideSize != -1)
-    {
-        partListInitSize = overrideSize;
-    }
-
-    // create index buffer based on that size
-    U32 indexListSize = partListInitSize * 6; // 6 indices per particle
-    U16* indices = new U16[indexListSize];
-
-    for (U32 i = 0; i < partListInitSize; i++)
-    {
-        // this index ordering should be optimal (hopefully) for the vertex cache
-        U16* idx = &indices[i * 6];
-        volatile U32 offset = i * 4;  // set to volatile to fix VC6 Release mode compiler bug
-        idx[0] = 0 + offset;
-        idx[1] = 1 + offset;
-        idx[2] = 3 + offset;
-        idx[3] = 1 + offset;
-        idx[4] = 3 + offset;
-        idx[5] = 2 + offset;
-    }
-
-
-    U16* ibIndices;
-    GFXBufferType bufferType = GFXBufferTypeStatic;
-
-#ifdef TORQUE_OS_XENON
-    // Because of the way the volatile buffers work on Xenon this is the only
-    // way to do this.
-    bufferType = GFXBufferTypeVolatile;
-#endif
-    primBuff.set(GFX, indexListSize, 0, bufferType);
-    primBuff.lock(&ibIndices);
-    dMemcpy(ibIndices, indices, indexListSize * sizeof(U16));
-    primBuff.unlock();
-
-    delete[] indices;
 }
 
 
@@ -338,8 +314,6 @@ ParticleEmitter::ParticleEmitter()
     mLifetimeMS = 0;
     mElapsedTimeMS = 0;
 
-    mLastPartIndex = 0;
-    mCurBuffSize = 0;
 
     mDead = false;
 }
@@ -349,6 +323,7 @@ ParticleEmitter::ParticleEmitter()
 //-----------------------------------------------------------------------------
 ParticleEmitter::~ParticleEmitter()
 {
+    smLiveParticles -= mParticles.size();
     //   AssertFatal(mParticleListHead == NULL, "Error, particles remain in emitter after remove?");
 }
 
@@ -368,7 +343,7 @@ bool ParticleEmitter::onAdd()
         mLifetimeMS += S32(gRandGen.randI() % (2 * mDataBlock->lifetimeVarianceMS + 1)) - S32(mDataBlock->lifetimeVarianceMS);
     }
 
-    mPartList.setSize(mDataBlock->partListInitSize);
+    mParticles.reserve(mDataBlock->partListInitSize);
 
     F32 radius = 5.0;
     mObjBox.min = Point3F(-radius, -radius, -radius);
@@ -408,14 +383,14 @@ ColorF ParticleEmitter::getCollectiveColor()
     U32 count = 0;
     ColorF color = ColorF(0.0f, 0.0f, 0.0f);
 
-    U32 numpart = getMin(mLastPartIndex, (mPartList.size() - 1));
+    U32 numpart = mParticles.size();
 
     //if(numpart <= 0)
     //	Con::printf("NumParts: %f", numpart);
 
     for (U32 i = 0; i < numpart; i++)
     {
-        color += mPartList[i].color;
+        color += mParticles.getColor(i);
         count++;
     }
 
@@ -454,14 +429,10 @@ bool ParticleEmitter::prepRenderImage(SceneState* state, const U32 stateKey,
 //-----------------------------------------------------------------------------
 void ParticleEmitter::prepBatchRender(const Point3F& camPos)
 {
-    if (mLastPartIndex == 0) return;
+    if (mParticles.empty()) return;
     if (mDead) return;
 
-    copyToVB(camPos);
-
     RenderInst* ri = gRenderInstManager.allocInst();
-    ri->vertBuff = &mVertBuff;
-    ri->primBuff = &mDataBlock->primBuff;
     ri->matInst = NULL;
     ri->translucent = true;
     ri->type = RenderInstManager::RIT_Translucent;
@@ -472,13 +443,22 @@ void ParticleEmitter::prepBatchRender(const Point3F& camPos)
     ri->worldXform = gRenderInstManager.allocXform();
     MatrixF world = GFX->getWorldMatrix();
     *ri->worldXform = world;
-    ri->primBuffIndex = mLastPartIndex;
-    ri->transFlags = mPartList[0].dataBlock->useInvAlpha;
+    ri->transFlags = mDataBlock->particleDataBlock->useInvAlpha;
 
-    ri->miscTex = &*(mPartList[0].dataBlock->textureList[0]);
+    ri->miscTex = &*(mDataBlock->particleDataBlock->textureList[0]);
 
     gRenderInstManager.addInst(ri);
 
+    // Vertices are built, and the buffer fields of ri filled in, by
+    // flushBatchRender once every emitter in view has been queued.
+    smBatchEntries.increment();
+    BatchEntry& entry = smBatchEntries.last();
+    entry.emitter = this;
+    entry.ri = ri;
+    entry.camPos = camPos;
+    entry.camView = world;
+    entry.camView.transpose();  // inverse - this gets the particles facing camera
+
 }
 
 //-----------------------------------------------------------------------------
@@ -646,7 +626,7 @@ void ParticleEmitter::emitParticles(const Point3F& start,
         updateBBox();
 
 
-    if (mLastPartIndex && mSceneManager == NULL)
+    if (!mParticles.empty() && mSceneManager == NULL)
     {
         getCurrentClientSceneGraph()->addObjectToScene(this);
         getCurrentClientContainer()->addObject(this);
@@ -717,7 +697,7 @@ void ParticleEmitter::emitParticles(const Point3F& rCenter,
     resetWorldBox();
 
     // Make sure we're part of the world
-    if (mLastPartIndex && mSceneManager == NULL)
+    if (!mParticles.empty() && mSceneManager == NULL)
     {
         getCurrentClientSceneGraph()->addObjectToScene(this);
         getCurrentClientContainer()->addObject(this);
@@ -735,11 +715,11 @@ void ParticleEmitter::updateBBox()
     Point3F min(1e10, 1e10, 1e10);
     Point3F max(-1e10, -1e10, -1e10);
 
-    for (U32 i = 0; i < mLastPartIndex; i++)
+    for (U32 i = 0; i < mParticles.size(); i++)
     {
-        Particle* part = &mPartList[i];
-        min.setMin(part->pos);
-        max.setMax(part->pos);
+        Point3F pos = mParticles.getPos(i);
+        min.setMin(pos);
+        max.setMax(pos);
     }
 
     mObjBox = Box3F(min, max);
@@ -755,18 +735,14 @@ void ParticleEmitter::addParticle(const Point3F& pos,
     const Point3F& vel,
     const Point3F& axisx)
 {
-    mLastPartIndex++;
-
-    // ARGGH, need to fix this - can get large numbers of particle to draw when dt is high?
-
-    if (mLastPartIndex > mPartList.size() || mLastPartIndex > mDataBlock->partListInitSize)
+    if (smMaxParticles > 0 && smLiveParticles >= smMaxParticles)
     {
-        mPartList.setSize(mPartList.size() + 16);
-
-        mDataBlock->allocPrimBuffer(mLastPartIndex + 16); // allocate larger primitive buffer or will crash
+        smDroppedParticles++;
+        return;
     }
 
-    Particle* pNew = &mPartList[mLastPartIndex - 1];
+    Particle newPart;
+    Particle* pNew = &newPart;
 
     Point3F ejectionAxis = axis;
     F32 theta = (mDataBlock->thetaMax - mDataBlock->thetaMin) * gRandGen.randF() +
@@ -796,7 +772,10 @@ void ParticleEmitter::addParticle(const Point3F& pos,
     pNew->currentAge = 0;
 
     mDataBlock->particleDataBlock->initializeParticle(pNew, vel);
-    updateKeyData(pNew);
+
+    U32 index = mParticles.add(newPart);
+    smLiveParticles++;
+    updateKeyData(index, 1);
 
 }
 
@@ -832,26 +811,19 @@ void ParticleEmitter::advanceTime(F32 dt)
     U32 numMSToUpdate = (U32)(dt * 1000.0f);
     if (numMSToUpdate == 0) return;
 
-    // remove dead particles
-    for (U32 i = 0; i < mLastPartIndex; i++)
-    {
-        Particle* part = &mPartList[i];
-        part->currentAge += numMSToUpdate;
-        if (part->currentAge > part->totalLifetime)
-        {
-            *part = mPartList[mLastPartIndex - 1];
-            mLastPartIndex--;
-        }
-    }
+    // age particles and remove dead ones
+    U32 numParticles = mParticles.size();
+    mParticles.age(numMSToUpdate);
+    smLiveParticles -= numParticles - mParticles.size();
 
 
-    if (mLastPartIndex <= 0 && mDeleteWhenEmpty)
+    if (mParticles.empty() && mDeleteWhenEmpty)
     {
         mDeleteOnTick = true;
         return;
     }
 
-    if (numMSToUpdate != 0 && mLastPartIndex > 0)
+    if (numMSToUpdate != 0 && !mParticles.empty())
     {
         update(numMSToUpdate);
     }
@@ -860,135 +832,332 @@ void ParticleEmitter::advanceTime(F32 dt)
 //-----------------------------------------------------------------------------
 // Update key related particle data
 //-----------------------------------------------------------------------------
-void ParticleEmitter::updateKeyData(Particle* part)
+void ParticleEmitter::updateKeyData(U32 start, U32 count)
 {
-    F32 t = F32(part->currentAge) / F32(part->totalLifetime);
-    AssertFatal(t <= 1.0f, "Out out bounds filter function for particle.");
+    ParticleData* data = mDataBlock->particleDataBlock;
 
-    for (U32 i = 1; i < ParticleData::PDC_NUM_KEYS; i++)
-    {
-        if (part->dataBlock->times[i] >= t)
-        {
-            F32 firstPart = t - part->dataBlock->times[i - 1];
-            F32 total = part->dataBlock->times[i] -
-                part->dataBlock->times[i - 1];
+    mParticles.updateKeyData(start, count, data->times,
+        mDataBlock->useEmitterColors ? colors : data->colors,
+        mDataBlock->useEmitterSizes ? sizes : data->sizes);
+}
+
+//-----------------------------------------------------------------------------
+// Update particles
+//-----------------------------------------------------------------------------
+void ParticleEmitter::update(U32 ms)
+{
+    ParticleData* data = mDataBlock->particleDataBlock;
 
-            firstPart /= total;
+    // Wind and gravity are the same for every particle in the emitter
+    Point3F accel = -mWindVelocity * data->windCoefficient;
+    accel += Point3F(0, 0, -9.81) * data->gravityCoefficient;
 
-            if (mDataBlock->useEmitterColors)
-            {
-                part->color.interpolate(colors[i - 1], colors[i], firstPart);
-            }
-            else
-            {
-                part->color.interpolate(part->dataBlock->colors[i - 1],
-                    part->dataBlock->colors[i],
-                    firstPart);
-            }
+    mParticles.integrate(F32(ms) / 1000.0, accel, data->dragCoefficient);
+    updateKeyData(0, mParticles.size());
+}
 
-            if (mDataBlock->useEmitterSizes)
-            {
-                part->size = (sizes[i - 1] * (1.0 - firstPart)) +
-                    (sizes[i] * firstPart);
-            }
-            else
-            {
-                part->size = (part->dataBlock->sizes[i - 1] * (1.0 - firstPart)) +
-                    (part->dataBlock->sizes[i] * firstPart);
-            }
-            break;
+//-----------------------------------------------------------------------------
+// Build vertices for particles [start, start + count)
+//-----------------------------------------------------------------------------
+void ParticleEmitter::buildVerts(U32 start, U32 count, const Point3F& camPos, const MatrixF& camView, GFXVertexPCT* buffPtr)
+{
+    U32 end = start + count;
+
+    if (mDataBlock->orientParticles)
+    {
+        for (U32 i = start; i < end; i++, buffPtr += 4)
+        {
+            setupOriented(i, camPos, buffPtr);
+        }
+    }
+    else
+    {
+        // somewhat odd ordering so that texture coordinates match the oriented
+        // particles
+        Point3F basePoints[4];
+        basePoints[0] = Point3F(-1.0, 0.0, 1.0);
+        basePoints[1] = Point3F(-1.0, 0.0, -1.0);
+        basePoints[2] = Point3F(1.0, 0.0, -1.0);
+        basePoints[3] = Point3F(1.0, 0.0, 1.0);
 
+        for (U32 i = start; i < end; i++, buffPtr += 4)
+        {
+            setupBillboard(i, basePoints, camView, buffPtr);
         }
     }
 }
 
 //-----------------------------------------------------------------------------
-// Update particles
+// Batched vertex generation
+//
+// Every emitter drawn in a pass gets a range of one of a few shared dynamic
+// vertex buffers.  The buffers are locked once, the ranges are filled in by
+// jobs on the thread pool, and all emitters share one index buffer holding
+// the quad pattern for a full buffer.
 //-----------------------------------------------------------------------------
-void ParticleEmitter::update(U32 ms)
+namespace
+{
+    enum BatchConstants
+    {
+        MaxBatchBuffers = 8,
+        MaxBatchParticles = 10920,  ///< Per buffer; 6 indices each must fit a U16 index buffer lock
+        BatchJobParticles = 256,    ///< Particles per job
+    };
+
+    GFXVertexBufferHandle<GFXVertexPCT>* sgBatchVB[MaxBatchBuffers];
+    U32 sgBatchVBSize[MaxBatchBuffers];
+    GFXPrimitiveBufferHandle* sgBatchPB = NULL;
+}
+
+Vector<ParticleEmitter::BatchEntry> ParticleEmitter::smBatchEntries(__FILE__, __LINE__);
+Vector<ParticleEmitter::BatchJob> ParticleEmitter::smBatchJobs(__FILE__, __LINE__);
+
+void ParticleEmitter::initBatchRender()
+{
+    gRenderInstManager.getPreSortSignal().notify(&ParticleEmitter::flushBatchRender);
+    GFXDevice::getDeviceEventSignal().notify(&ParticleEmitter::handleGFXEvent);
+}
+
+void ParticleEmitter::handleGFXEvent(GFXDevice::GFXDeviceEventType event)
+{
+    if (event != GFXDevice::deDestroy)
+        return;
+
+    for (U32 i = 0; i < MaxBatchBuffers; i++)
+    {
+        delete sgBatchVB[i];
+        sgBatchVB[i] = NULL;
+        sgBatchVBSize[i] = 0;
+    }
+    delete sgBatchPB;
+    sgBatchPB = NULL;
+}
+
+void ParticleEmitter::batchJob(void*, U32 index)
 {
+    const BatchJob& job = smBatchJobs[index];
+    const BatchEntry& entry = smBatchEntries[job.entry];
+
+    entry.emitter->buildVerts(job.start, job.count, entry.camPos, entry.camView, entry.verts + job.start * 4);
+}
+
+void ParticleEmitter::flushBatchRender()
+{
+    if (smBatchEntries.empty())
+        return;
+
+    PROFILE_START(ParticleEmitter_flushBatchRender);
+
+    if (!sgBatchPB)
+    {
+        U16* indices;
+        sgBatchPB = new GFXPrimitiveBufferHandle;
+        sgBatchPB->set(GFX, MaxBatchParticles * 6, 0, GFXBufferTypeStatic);
+        sgBatchPB->lock(&indices);
+        for (U32 i = 0; i < MaxBatchParticles; i++, indices += 6)
+        {
+            // this index ordering should be optimal (hopefully) for the vertex cache
+            U32 offset = i * 4;
+            indices[0] = 0 + offset;
+            indices[1] = 1 + offset;
+            indices[2] = 3 + offset;
+            indices[3] = 1 + offset;
+            indices[4] = 3 + offset;
+            indices[5] = 2 + offset;
+        }
+        sgBatchPB->unlock();
+    }
+
+    // Hand out buffer ranges.  An emitter never straddles two buffers.
+    U32 bufferCount[MaxBatchBuffers];
+    U32 numBuffers = 1;
+    bufferCount[0] = 0;
+
+    U32 numEntries = smBatchEntries.size();
+    for (U32 i = 0; i < numEntries; i++)
+    {
+        BatchEntry& entry = smBatchEntries[i];
+        U32 count = getMin(entry.emitter->mParticles.size(), U32(MaxBatchParticles));
+
+        if (bufferCount[numBuffers - 1] + count > MaxBatchParticles)
+        {
+            if (numBuffers == MaxBatchBuffers)
+            {
+                // Out of room for this pass, skip the rest
+                for (; i < numEntries; i++)
+                    smBatchEntries[i].ri->primBuffIndex = 0;
+                break;
+            }
+            bufferCount[numBuffers++] = 0;
+        }
+
+        entry.ri->primBuff = sgBatchPB;
+        entry.ri->primStartIndex = bufferCount[numBuffers - 1] * 6;
+        entry.ri->primBuffIndex = count;
+        entry.buffer = numBuffers - 1;
+        bufferCount[numBuffers - 1] += count;
+    }
 
-    for (U32 i = 0; i < mLastPartIndex; i++)
+    // Lock the buffers, growing them if needed
+    GFXVertexPCT* bufferVerts[MaxBatchBuffers];
+    for (U32 b = 0; b < numBuffers; b++)
     {
-        Particle* part = &mPartList[i];
+        if (!sgBatchVB[b])
+            sgBatchVB[b] = new GFXVertexBufferHandle<GFXVertexPCT>;
 
-        F32 t = F32(ms) / 1000.0;
+        if (bufferCount[b] > sgBatchVBSize[b])
+        {
+            sgBatchVBSize[b] = getMin((bufferCount[b] + BatchJobParticles) & ~(BatchJobParticles - 1), U32(MaxBatchParticles));
+            sgBatchVB[b]->set(GFX, sgBatchVBSize[b] * 4, GFXBufferTypeDynamic);
+        }
+
+        bufferVerts[b] = bufferCount[b] ? sgBatchVB[b]->lock(0, bufferCount[b] * 4) : NULL;
+    }
 
-        Point3F a = part->acc;
-        a -= part->vel * part->dataBlock->dragCoefficient;
-        a -= mWindVelocity * part->dataBlock->windCoefficient;
-        a += Point3F(0, 0, -9.81) * part->dataBlock->gravityCoefficient;
+    // One job per chunk of each emitter
+    smBatchJobs.clear();
+    for (U32 i = 0; i < numEntries; i++)
+    {
+        BatchEntry& entry = smBatchEntries[i];
+        U32 count = entry.ri->primBuffIndex;
+        if (count == 0)
+            continue;
 
-        part->vel += a * t;
-        part->pos += part->vel * t;
+        entry.ri->vertBuff = sgBatchVB[entry.buffer];
+        entry.verts = bufferVerts[entry.buffer] + (entry.ri->primStartIndex / 6) * 4;
 
-        updateKeyData(part);
+        for (U32 start = 0; start < count; start += BatchJobParticles)
+        {
+            smBatchJobs.increment();
+            BatchJob& job = smBatchJobs.last();
+            job.entry = i;
+            job.start = start;
+            job.count = getMin(count - start, U32(BatchJobParticles));
+        }
     }
 
+    ThreadPool::run(batchJob, NULL, smBatchJobs.size());
+
+    for (U32 b = 0; b < numBuffers; b++)
+        if (bufferCount[b])
+            sgBatchVB[b]->unlock();
+
+    smBatchEntries.clear();
+
+    PROFILE_END();
 }
 
 //-----------------------------------------------------------------------------
-// Copy particles to vertex buffer
+// benchmark
+// Runs emitters through emission, update and vertex generation outside of the
+// normal frame, with the thread pool off and then on.  Meant to be run with
+// the Null device so it measures CPU side work only.
 //-----------------------------------------------------------------------------
-void ParticleEmitter::copyToVB(const Point3F& camPos)
+void ParticleEmitter::benchmark(ParticleEmitterData* data, U32 numEmitters, U32 numFrames)
 {
-    Particle* partPtr = mPartList.address();
-
-    static Vector<GFXVertexPCT> tempBuff(2048);
-    tempBuff.reserve(mLastPartIndex * 4 + 64); // make sure tempBuff is big enough
-    GFXVertexPCT* buffPtr = tempBuff.address(); // use direct pointer (faster)
+    if (!data->particleDataBlock)
+    {
+        Con::errorf("particleBenchmark: %s has no particle datablock", data->getName());
+        return;
+    }
+    if (!data->partListInitSize)
+        data->calcPartListSize();
 
-    if (mDataBlock->orientParticles)
+    Vector<ParticleEmitter*> emitters(__FILE__, __LINE__);
+    for (U32 i = 0; i < numEmitters; i++)
     {
-        for (U32 i = 0; i < mLastPartIndex; i++, partPtr++, buffPtr += 4)
+        ParticleEmitter* emitter = new ParticleEmitter;
+        emitter->onNewDataBlock(data);
+        if (!emitter->registerObject())
         {
-            setupOriented(partPtr, camPos, buffPtr);
+            delete emitter;
+            continue;
         }
+        emitters.push_back(emitter);
     }
-    else
+
+    const U32 frameMS = 32;
+    const Point3F camPos(0, -20, 0);
+    const Point3F axis(0, 0, 1);
+
+    bool poolEnabled = Con::getBoolVariable("$ThreadPool::enabled");
+
+    for (U32 pass = 0; pass < 2; pass++)
     {
-        // somewhat odd ordering so that texture coordinates match the oriented
-        // particles
-        Point3F basePoints[4];
-        basePoints[0] = Point3F(-1.0, 0.0, 1.0);
-        basePoints[1] = Point3F(-1.0, 0.0, -1.0);
-        basePoints[2] = Point3F(1.0, 0.0, -1.0);
-        basePoints[3] = Point3F(1.0, 0.0, 1.0);
+        Con::setBoolVariable("$ThreadPool::enabled", pass == 1);
 
-        MatrixF camView = GFX->getWorldMatrix();
-        camView.transpose();  // inverse - this gets the particles facing camera
+        U32 updateTime = 0;
+        U32 prepTime = 0;
+        U32 buildTime = 0;
+        U32 numVerts = 0;
 
-        for (U32 i = 0; i < mLastPartIndex; i++, partPtr++, buffPtr += 4)
+        for (U32 frame = 0; frame < numFrames; frame++)
         {
-            setupBillboard(partPtr, basePoints, camView, buffPtr);
+            U32 time = Platform::getRealMilliseconds();
+            for (U32 i = 0; i < emitters.size(); i++)
+            {
+                Point3F pos(F32(i % 8) * 4.0f - 14.0f, 0, F32(i / 8) * 4.0f - 14.0f);
+                emitters[i]->emitParticles(pos, false, axis, Point3F(0, 0, 0), frameMS);
+                emitters[i]->advanceTime(frameMS / 1000.0f);
+            }
+
+            U32 prepStart = Platform::getRealMilliseconds();
+            for (U32 i = 0; i < emitters.size(); i++)
+            {
+                numVerts += emitters[i]->mParticles.size() * 4;
+                emitters[i]->prepBatchRender(camPos);
+            }
+
+            U32 buildStart = Platform::getRealMilliseconds();
+            flushBatchRender();
+            U32 end = Platform::getRealMilliseconds();
+            gRenderInstManager.clear();
+
+            updateTime += prepStart - time;
+            prepTime += buildStart - prepStart;
+            buildTime += end - buildStart;
         }
+
+        Con::printf("particleBenchmark: %s, %d emitters, %d frames, %d threads",
+            data->getName(), emitters.size(), numFrames, ThreadPool::getNumThreads());
+        Con::printf("   update %.3fms/frame, queue %.3fms/frame, build vertices %.3fms/frame (%d verts/frame)",
+            F32(updateTime) / numFrames, F32(prepTime) / numFrames, F32(buildTime) / numFrames, numVerts / numFrames);
     }
 
-    // create new VB if emitter size grows
-    if (!mVertBuff || mLastPartIndex > mCurBuffSize)
+    Con::setBoolVariable("$ThreadPool::enabled", poolEnabled);
+
+    for (U32 i = 0; i < emitters.size(); i++)
+        emitters[i]->deleteObject();
+}
+
+ConsoleFunction(particleBenchmark, void, 2, 4, "(ParticleEmitterData data, int emitters = 64, int frames = 300)"
+    "Time particle update and vertex generation for a set of emitters, single threaded and on the thread pool.  "
+    "Run with the Null device to time the CPU side only.")
+{
+    ParticleEmitterData* data = dynamic_cast<ParticleEmitterData*>(Sim::findObject(argv[1]));
+    if (!data)
     {
-        mCurBuffSize = mLastPartIndex;
-        mVertBuff.set(GFX, mLastPartIndex * 4, GFXBufferTypeDynamic);
+        Con::errorf("particleBenchmark: %s is not a ParticleEmitterData", argv[1]);
+        return;
     }
-    // lock and copy tempBuff to video RAM
-    GFXVertexPCT* verts = mVertBuff.lock();
-    dMemcpy(verts, tempBuff.address(), mLastPartIndex * 4 * sizeof(GFXVertexPCT));
-    mVertBuff.unlock();
 
+    ParticleEmitter::benchmark(data, argc > 2 ? dAtoi(argv[2]) : 64, argc > 3 ? dAtoi(argv[3]) : 300);
 }
 
 //-----------------------------------------------------------------------------
 // Set up particle for billboard style render
 //-----------------------------------------------------------------------------
-void ParticleEmitter::setupBillboard(Particle* part,
+void ParticleEmitter::setupBillboard(U32 part,
     Point3F* basePts,
     MatrixF camView,
     GFXVertexPCT* lVerts)
 {
     const F32 spinFactor = (1.0 / 1000.0) * (1.0 / 360.0) * M_PI * 2.0;
 
-    F32 width = part->size * 0.5;
-    F32 spinAngle = part->spinSpeed * part->currentAge * spinFactor;
+    F32 width = mParticles.getSize(part) * 0.5;
+    F32 spinAngle = mParticles.getSpinSpeed(part) * mParticles.getAge(part) * spinFactor;
+    Point3F pos = mParticles.getPos(part);
+    ColorF color = mParticles.getColor(part);
 
     F32 sy, cy;
     mSinCos(spinAngle, sy, cy);
@@ -1000,8 +1169,8 @@ void ParticleEmitter::setupBillboard(Particle* part,
       lVerts->point.z = sy * basePts->x + cy * basePts->z;  \
       camView.mulV( lVerts->point );                        \
       lVerts->point *= width;                               \
-      lVerts->point += part->pos;                           \
-      lVerts->color = part->color; }                        \
+      lVerts->point += pos;                                 \
+      lVerts->color = color; }                              \
 
 
     fillVert();
@@ -1028,7 +1197,7 @@ void ParticleEmitter::setupBillboard(Particle* part,
 //-----------------------------------------------------------------------------
 // Set up oriented particle
 //-----------------------------------------------------------------------------
-void ParticleEmitter::setupOriented(Particle* part,
+void ParticleEmitter::setupOriented(U32 part,
     const Point3F& camPos,
     GFXVertexPCT* lVerts)
 {
@@ -1037,45 +1206,48 @@ void ParticleEmitter::setupOriented(Particle* part,
     if (mDataBlock->orientOnVelocity)
     {
         // don't render oriented particle if it has no velocity
-        if (part->vel.magnitudeSafe() == 0.0) return;
-        dir = part->vel;
+        dir = mParticles.getVel(part);
+        if (dir.magnitudeSafe() == 0.0) return;
     }
     else
     {
-        dir = part->orientDir;
+        dir = mParticles.getOrientDir(part);
     }
 
-    Point3F dirFromCam = part->pos - camPos;
+    Point3F pos = mParticles.getPos(part);
+    ColorF color = mParticles.getColor(part);
+
+    Point3F dirFromCam = pos - camPos;
     Point3F crossDir;
     mCross(dirFromCam, dir, &crossDir);
     crossDir.normalize();
     dir.normalize();
 
 
-    F32 width = part->size * 0.5;
+    F32 width = mParticles.getSize(part) * 0.5;
     dir *= width;
     crossDir *= width;
-    Point3F start = part->pos - dir;
-    Point3F end = part->pos + dir;
+    Point3F start = pos - dir;
+    Point3F end = pos + dir;
 
 
     lVerts->point = start + crossDir;
-    lVerts->color = part->color;
+    lVerts->color = color;
     lVerts->texCoord.set(0.0, 0.0);
     ++lVerts;
 
     lVerts->point = start - crossDir;
-    lVerts->color = part->color;
+    lVerts->color = color;
     lVerts->texCoord.set(0.0, 1.0);
     ++lVerts;
 
     lVerts->point = end - crossDir;
-    lVerts->color = part->color;
+    lVerts->color = color;
     lVerts->texCoord.set(1.0, 1.0);
     ++lVerts;
 
     lVerts->point = end + crossDir;
-    lVerts->color = part->color;
+    lVerts->color = color;
     lVerts->texCoord.set(1.0, 0.0);
     ++lVerts;
 
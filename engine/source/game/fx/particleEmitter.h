@@ -17,6 +17,7 @@
 #include "gfx/gfxDevice.h"
 
 class  ParticleData;
+struct RenderInst;
 
 //*****************************************************************************
 // Particle Emitter Data
@@ -33,7 +34,8 @@ public:
     void unpackData(BitStream* stream);
     bool preload(bool server, char errorBuffer[256]);
     bool onAdd();
-    void allocPrimBuffer(S32 overrideSize = -1);
+    void calcPartListSize();
+    static void consoleInit();
 
 public:
     S32   ejectionPeriodMS;                   ///< Time, in Miliseconds, between particle ejection
@@ -63,8 +65,6 @@ public:
     U32                   partDataID;
     U32                   partListInitSize;   /// initial size of particle list calc'd from datablock info
 
-    GFXPrimitiveBufferHandle   primBuff;
-
 };
 
 DECLARE_CONSOLETYPE(ParticleEmitterData)
@@ -83,6 +83,16 @@ public:
     static Point3F mWindVelocity;
     static void setWindVelocity(const Point3F& vel) { mWindVelocity = vel; }
 
+    /// @name Particle budget
+    /// All emitters draw from one pool of live particles.  Once it is used up
+    /// new particles are dropped until old ones expire.
+    /// @{
+
+    static S32 smMaxParticles;     ///< $pref::Particles::maxParticles, 0 for no limit
+    static S32 smLiveParticles;    ///< $Particles::liveCount
+    static U32 smDroppedParticles; ///< $Particles::dropped, particles refused by the budget
+    /// @}
+
     ColorF getCollectiveColor();
 
     /// Sets sizes of particles based on sizelist provided
@@ -142,12 +152,12 @@ protected:
     void addParticle(const Point3F& pos, const Point3F& axis, const Point3F& vel, const Point3F& axisx);
 
 
-    inline void setupBillboard(Particle* part,
+    inline void setupBillboard(U32 part,
         Point3F* basePts,
         MatrixF camView,
         GFXVertexPCT* lVerts);
 
-    inline void setupOriented(Particle* part,
+    inline void setupOriented(U32 part,
         const Point3F& camPos,
         GFXVertexPCT* lVerts);
 
@@ -166,13 +176,52 @@ protected:
 protected:
     bool prepRenderImage(SceneState* state, const U32 stateKey, const U32 startZone, const bool modifyBaseZoneState);
     void prepBatchRender(const Point3F& camPos);
-    void copyToVB(const Point3F& camPos);
+    void buildVerts(U32 start, U32 count, const Point3F& camPos, const MatrixF& camView, GFXVertexPCT* verts);
+
+public:
+    /// @name Batched vertex generation
+    /// prepBatchRender only queues an emitter.  When scene traversal is done
+    /// flushBatchRender builds the vertices of every queued emitter on the
+    /// thread pool, each emitter (or chunk of a large one) writing its own
+    /// range of a shared vertex buffer.
+    /// @{
+    static void initBatchRender();
+    static void flushBatchRender();
+    /// @}
+
+    /// Time emission, update and vertex generation for a set of emitters,
+    /// without and with the thread pool.  See particleBenchmark().
+    static void benchmark(ParticleEmitterData* data, U32 numEmitters, U32 numFrames);
+
+private:
+    struct BatchEntry
+    {
+        ParticleEmitter* emitter;
+        RenderInst* ri;
+        Point3F camPos;
+        MatrixF camView;
+        U32 buffer;             ///< Shared vertex buffer this emitter goes in
+        GFXVertexPCT* verts;    ///< First vertex of this emitter's range
+    };
+
+    struct BatchJob
+    {
+        U32 entry;
+        U32 start;
+        U32 count;
+    };
+
+    static Vector<BatchEntry> smBatchEntries;
+    static Vector<BatchJob> smBatchJobs;
+
+    static void batchJob(void* data, U32 index);
+    static void handleGFXEvent(GFXDevice::GFXDeviceEventType event);
 
     // PEngine interface
 private:
 
     void update(U32 ms);
-    inline void updateKeyData(Particle* part);
+    inline void updateKeyData(U32 start, U32 count);
 
 
 private:
@@ -194,10 +243,7 @@ private:
     F32       sizes[ParticleData::PDC_NUM_KEYS];
     ColorF    colors[ParticleData::PDC_NUM_KEYS];
 
-    GFXVertexBufferHandle<GFXVertexPCT> mVertBuff;
-    Vector <Particle> mPartList;
-    S32       mLastPartIndex;
-    S32       mCurBuffSize;
+    ParticleList mParticles;
 
 };
 
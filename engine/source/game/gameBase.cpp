@@ -157,7 +157,7 @@ GameBase::GameBase()
     mProcessTick = true;
     mNameTag = "";
     mControllingClient = 0;
-    mTickCacheHead = NULL;
+    mTickCache = NULL;
 
 #ifdef TORQUE_DEBUG_NET_MOVES
     mLastMoveId = 0;
@@ -169,12 +169,8 @@ GameBase::GameBase()
 GameBase::~GameBase()
 {
     plUnlink();
-    if (mTickCacheHead)
-    {
-        setTickCacheSize(0);
-        TickCacheHead::free(mTickCacheHead);
-        mTickCacheHead = NULL;
-    }
+    delete mTickCache;
+    mTickCache = NULL;
 }
 
 
@@ -440,102 +436,43 @@ void GameBase::clearProcessAfter()
 void GameBase::beginTickCacheList()
 {
     // get ready iterate from oldest to newest entry
-    if (mTickCacheHead)
-        mTickCacheHead->next = mTickCacheHead->oldest;
-    // if no head, that's ok, we'll just add entries as we go
+    if (mTickCache)
+        mTickCache->beginCacheList();
+    // if no cache, that's ok, we'll just add entries as we go
 }
 
 TickCacheEntry* GameBase::incTickCacheList(bool addIfNeeded)
 {
     // continue iterating through cache, returning current entry
     // we'll add new entries if need be
-    TickCacheEntry * ret = NULL;
-    if (mTickCacheHead && mTickCacheHead->next)
-    {
-        ret = mTickCacheHead->next;
-        mTickCacheHead->next = mTickCacheHead->next->next;
-    }
-    else if (addIfNeeded)
+    if (!mTickCache)
     {
-        addTickCacheEntry();
-        ret = mTickCacheHead->newest;
+        if (!addIfNeeded)
+            return NULL;
+        mTickCache = new TickCache;
     }
-    return ret;
+    return mTickCache->incCacheList(addIfNeeded);
 }
 
 TickCacheEntry* GameBase::addTickCacheEntry()
 {
-    // Add a new entry, creating head if needed
-    if (!mTickCacheHead)
-    {
-        mTickCacheHead = TickCacheHead::alloc();
-        mTickCacheHead->newest = mTickCacheHead->oldest = mTickCacheHead->next = NULL;
-        mTickCacheHead->numEntry = 0;
-    }
-    if (!mTickCacheHead->newest)
-    {
-        mTickCacheHead->newest = mTickCacheHead->oldest = TickCacheEntry::alloc();
-    }
-    else
-    {
-        mTickCacheHead->newest->next = TickCacheEntry::alloc();
-        mTickCacheHead->newest = mTickCacheHead->newest->next;
-    }
-    mTickCacheHead->newest->next = NULL;
-    mTickCacheHead->newest->move = NULL;
-    mTickCacheHead->numEntry++;
-    return mTickCacheHead->newest;
+    // Add a new entry, creating the cache if needed
+    if (!mTickCache)
+        mTickCache = new TickCache;
+    return mTickCache->addCacheEntry();
 }
 
 void GameBase::ageTickCache(S32 numToAge, S32 len)
 {
-    AssertFatal(mTickCacheHead,"No tick cache head");
-    AssertFatal(mTickCacheHead->numEntry>=numToAge,"Too few entries!");
-    AssertFatal(mTickCacheHead->numEntry>numToAge,"Too few entries!");
-
-    while (numToAge--)
-        dropOldest();
-    while (mTickCacheHead->numEntry>len)
-        dropNextOldest();
-    while (mTickCacheHead->numEntry<len)
-        addTickCacheEntry();
+    AssertFatal(mTickCache, "No tick cache head");
+    mTickCache->ageCache(numToAge, len);
 }
 
 void GameBase::setTickCacheSize(int len)
 {
-    // grow cache to len size, adding to newest side of the list
-    while (!mTickCacheHead || mTickCacheHead->numEntry < len)
-        addTickCacheEntry();
-    // shrink tick cache down to given size, popping off oldest entries first
-    while (mTickCacheHead && mTickCacheHead->numEntry > len)
-        dropOldest();
-}
-
-void GameBase::dropOldest()
-{
-    AssertFatal(mTickCacheHead->oldest,"Popping off too many tick cache entries");
-    TickCacheEntry * oldest = mTickCacheHead->oldest;
-    mTickCacheHead->oldest = oldest->next;
-    if (oldest->move)
-        TickCacheEntry::freeMove(oldest->move);
-    TickCacheEntry::free(oldest);
-    mTickCacheHead->numEntry--;
-    if (mTickCacheHead->numEntry < 2)
-        mTickCacheHead->newest = mTickCacheHead->oldest;
-}
-
-void GameBase::dropNextOldest()
-{
-    AssertFatal(mTickCacheHead->oldest && mTickCacheHead->numEntry>1,"Popping off too many tick cache entries");
-    TickCacheEntry * oldest = mTickCacheHead->oldest;
-    TickCacheEntry * nextoldest = mTickCacheHead->oldest->next;
-    oldest->next = nextoldest->next;
-    if (nextoldest->move)
-        TickCacheEntry::freeMove(nextoldest->move);
-    TickCacheEntry::free(nextoldest);
-    mTickCacheHead->numEntry--;
-    if (mTickCacheHead->numEntry==1)
-        mTickCacheHead->newest = mTickCacheHead->oldest;
+    if (!mTickCache)
+        mTickCache = new TickCache;
+    mTickCache->setCacheSize(len);
 }
 
 
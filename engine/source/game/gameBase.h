@@ -17,7 +17,7 @@
 #endif
 
 struct TickCacheEntry;
-struct TickCacheHead;
+class TickCache;
 class NetConnection;
 class ProcessList;
 struct Move;
@@ -153,7 +153,7 @@ private:
 private:
     GameBaseData* mDataBlock;
     StringTableEntry  mNameTag;
-    TickCacheHead* mTickCacheHead;
+    TickCache* mTickCache;
 
     /// @}
 
@@ -284,8 +284,6 @@ public:
     TickCacheEntry* addTickCacheEntry();
     void ageTickCache(S32 numToAge, S32 len);
     void setTickCacheSize(int len);
-    void dropOldest();
-    void dropNextOldest();
 
     /// Processes a move event and updates object state once every 32 milliseconds.
     ///
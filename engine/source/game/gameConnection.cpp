@@ -9,6 +9,7 @@
 #include "console/simBase.h"
 #include "core/bitStream.h"
 #include "sim/pathManager.h"
+#include "sim/netSimulator.h"
 #include "sceneGraph/sceneGraph.h"
 #include "sceneGraph/sceneLighting.h"
 #include "sfx/sfxProfile.h"
@@ -976,6 +977,7 @@ void GameConnection::readPacket(BitStream* bstream)
             ourTicks -= mLastMoveAck - mLastClientMove;
             mLastClientMove = mLastMoveAck;
         }
+        NetSimulator::noteMovesAcked(this, mFirstMoveIndex, mLastMoveAck);
         while (mFirstMoveIndex < mLastMoveAck)
         {
             if (!mMoveList.empty())
@@ -1160,7 +1162,9 @@ void GameConnection::readPacket(BitStream* bstream)
             mLastClientMove = mLastMoveAck;
 
         PROFILE_START(ClientCatchup);
+        U32 catchupStart = Platform::getRealMilliseconds();
         getCurrentClientProcessList()->clientCatchup(this, totalCatchup);
+        NetSimulator::noteClientCatchup(totalCatchup, Platform::getRealMilliseconds() - catchupStart);
         PROFILE_END();
     }
 }
@@ -1688,6 +1692,8 @@ ConsoleMethod(GameConnection, delete, void, 2, 3, "(string reason=NULL) Disconne
 void GameConnection::consoleInit()
 {
     Con::addVariable("Pref::Net::LagThreshold", TypeS32, &mLagThresholdMS);
+    Con::addVariable("Pref::Net::CatchupBudget", TypeS32, &ProcessList::smCatchupBudget);
+    Con::addVariable("Net::logCatchup", TypeBool, &ProcessList::smLogCatchup);
     Con::addVariable("specialFog", TypeBool, &SceneGraph::useSpecial);
 }
 
@@ -46,6 +46,8 @@
 #include "materials/materialPropertyMap.h"
 #include "sim/netStringTable.h"
 #include "sim/pathManager.h"
+#include "sim/netSimulator.h"
+#include "platform/threadPool.h"
 #include "game/gameFunctions.h"
 #include "platform/platformRedBook.h"
 #include "game/demoGame.h"
@@ -70,9 +72,8 @@
 #include "discord/DiscordGame.h"
 //#include "../discord/discordGameSDK.h"
 
-#ifdef MB_CLIENT_PHYSICS_EVERY_FRAME
 #include "game/gameConnection.h"
-#endif
+#include "game/gameProcess.h"
 
 #ifndef BUILD_TOOLS
 DemoGame GameObject;
@@ -85,6 +86,7 @@ extern ResourceInstance* constructAtlasFileResource(Stream& stream);
 extern ResourceInstance* constructTerrainFile(Stream& stream);
 #endif
 extern ResourceInstance* constructTSShape(Stream&);
+extern ResourceInstance* constructTSShapeBaked(Stream&);
 
 ConsoleFunctionGroupBegin(Platform, "General platform functions.");
 
@@ -187,6 +189,7 @@ static bool initLibraries()
     ResourceManager->registerExtension(".ter", constructTerrainFile);
 #endif
     ResourceManager->registerExtension(".dts", constructTSShape);
+    ResourceManager->registerExtension(".dtb", constructTSShapeBaked);
     // ResourceManager->registerExtension(".dae", constructColladaShape);
     //   ResourceManager->registerExtension(".dml", constructMaterialList);
     ResourceManager->registerExtension(".map", constructInteriorMAP);
@@ -196,6 +199,7 @@ static bool initLibraries()
 
     Con::init();
     NetStringTable::create();
+    NetSimulator::init();
 
     TelnetConsole::create();
     TelnetDebugger::create();
@@ -203,6 +207,7 @@ static bool initLibraries()
     Processor::init();
     Math::init();
     Platform::init();    // platform specific initialization
+    ThreadPool::init();
     InteriorInstance::init();
     TSShapeInstance::init();
     RedBook::init();
@@ -234,10 +239,12 @@ static void shutdownLibraries()
 
     //TextureManager::preDestroy();
 
+    ThreadPool::shutdown();
     Platform::shutdown();
     TelnetDebugger::destroy();
     TelnetConsole::destroy();
 
+    NetSimulator::shutdown();
     NetStringTable::destroy();
     Con::shutdown();
 
@@ -752,6 +759,39 @@ void DemoGame::refreshWindow()
         Canvas->resetUpdateRegions();
 }
 
+/// Time until the next scheduled Sim event or, while anyone is connected,
+/// the next server tick.  Nothing else happens on a dedicated server
+/// without a packet arriving first.
+S32 DemoGame::getIdleTimeout()
+{
+    // A client has to keep rendering, journals must replay exactly, and a
+    // fixed $timeAdvance means time isn't real time anyway.
+    if (GameConnection::getConnectionToServer() || isJournalReading() || isJournalWriting() || gTimeAdvance)
+        return 0;
+
+    S32 timeout = -1;
+
+    SimTime eventTime;
+    if (Sim::getNextEventTime(&eventTime))
+    {
+        SimTime now = Sim::getCurrentTime();
+        timeout = eventTime > now ? S32(eventTime - now) : 0;
+    }
+
+    if (Sim::getClientGroup()->size() > 0)
+    {
+        S32 untilTick = TickMs - (getCurrentServerProcessList()->getLastTime() & TickMask);
+        if (timeout < 0 || untilTick < timeout)
+            timeout = untilTick;
+    }
+
+    // Timeouts are in game time, the wait is in real time.
+    if (timeout > 0 && gTimeScale > 0)
+        timeout = S32(timeout / gTimeScale);
+
+    return timeout;
+}
+
 /// Process a console event
 void DemoGame::processConsoleEvent(ConsoleEvent* event)
 {
@@ -26,6 +26,139 @@ static U32 sCameraCollisionMask = InteriorObjectType | StaticShapeObjectType;
 
 //----------------------------------------------------------------------------
 
+namespace {
+
+    /// Sweep and prune over the trigger and item volumes of one container,
+    /// shared by all the marbles in it, in place of a container query per
+    /// marble per step.
+    ///
+    /// The volumes are kept sorted on their minimum x.  Their boxes are
+    /// refreshed once per tick, which is noticed as a marble asking a
+    /// second time, and the list is only rebuilt when a trigger or item is
+    /// added to or removed from the container.  Volumes which move between
+    /// two marbles' steps in the same tick are picked up on the next tick.
+    class TriggerItemSweep
+    {
+        struct Entry
+        {
+            Box3F box;
+            SceneObject* obj;
+        };
+
+        Container* mContainer;
+        U32 mRevision;
+        U32 mGeneration;
+        F32 mMaxWidth;
+        Vector<Entry> mEntries;
+        Vector<SceneObject*> mGlobal;   ///< Global bounds volumes, in every query.
+
+        void rebuild()
+        {
+            static Vector<SceneObject*> objects;
+            objects.clear();
+            mContainer->collectObjects(sTriggerItemMask, objects);
+
+            mEntries.clear();
+            mGlobal.clear();
+            for (U32 i = 0; i < objects.size(); i++)
+            {
+                if (objects[i]->isGlobalBounds())
+                    mGlobal.push_back(objects[i]);
+                else
+                {
+                    mEntries.increment();
+                    mEntries.last().obj = objects[i];
+                }
+            }
+            mRevision = mContainer->getTypeRevision();
+        }
+
+        void refresh()
+        {
+            // Nearly always in order already, so an insertion sort is linear
+            mMaxWidth = 0.0f;
+            for (S32 i = 0; i < mEntries.size(); i++)
+            {
+                Entry entry = mEntries[i];
+                entry.box = entry.obj->getWorldBox();
+                mMaxWidth = getMax(mMaxWidth, entry.box.max.x - entry.box.min.x);
+
+                S32 j = i - 1;
+                for (; j >= 0 && mEntries[j].box.min.x > entry.box.min.x; j--)
+                    mEntries[j + 1] = mEntries[j];
+                mEntries[j + 1] = entry;
+            }
+            mGeneration++;
+        }
+
+    public:
+        TriggerItemSweep(Container* container)
+        {
+            VECTOR_SET_ASSOCIATION(mEntries);
+            VECTOR_SET_ASSOCIATION(mGlobal);
+
+            mContainer = container;
+            mRevision = 0;
+            mGeneration = 1;
+            mMaxWidth = 0.0f;
+
+            Container::smRevisionTypes |= sTriggerItemMask;
+            rebuild();
+            refresh();
+        }
+
+        Container* getContainer() const { return mContainer; }
+
+        /// The volumes overlapping box, in order of their minimum x.
+        void query(U32& marbleGeneration, const Box3F& box, Vector<SceneObject*>& list)
+        {
+            if (mRevision != mContainer->getTypeRevision())
+            {
+                rebuild();
+                refresh();
+            }
+            else if (marbleGeneration == mGeneration)
+                refresh();
+            marbleGeneration = mGeneration;
+
+            for (U32 i = 0; i < mGlobal.size(); i++)
+                list.push_back(mGlobal[i]);
+
+            // First entry which could reach box, then sweep until they
+            // start past it
+            F32 from = box.min.x - mMaxWidth;
+            S32 lo = 0, hi = mEntries.size();
+            while (lo < hi)
+            {
+                S32 mid = (lo + hi) >> 1;
+                if (mEntries[mid].box.min.x < from)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+
+            for (S32 i = lo; i < mEntries.size() && mEntries[i].box.min.x <= box.max.x; i++)
+                if (mEntries[i].box.isOverlapped(box))
+                    list.push_back(mEntries[i].obj);
+        }
+    };
+
+    Vector<TriggerItemSweep*> sgTriggerItemSweeps;
+
+    TriggerItemSweep* getTriggerItemSweep(Container* container)
+    {
+        for (U32 i = 0; i < sgTriggerItemSweeps.size(); i++)
+            if (sgTriggerItemSweeps[i]->getContainer() == container)
+                return sgTriggerItemSweeps[i];
+
+        sgTriggerItemSweeps.push_back(new TriggerItemSweep(container));
+        return sgTriggerItemSweeps.last();
+    }
+
+} // namespace {}
+
+//----------------------------------------------------------------------------
+
 IMPLEMENT_CO_NETOBJECT_V1(Marble);
 
 U32 Marble::smEndPadId = 0;
@@ -49,6 +182,7 @@ Marble::Marble()
     mTrailEmitter = NULL;
     mMudEmitter = NULL;
     mGrassEmitter = NULL;
+    mTriggerSweepGeneration = 0;
 
     mNetFlags.set(Ghostable | NetOrdered);
 
@@ -1976,17 +2110,28 @@ void Marble::processMoveTriggers(const Move * move)
 
 void Marble::processItemsAndTriggers(const Point3F& startPos, const Point3F& endPos)
 {
-    SimpleQueryList sql;
+    static Vector<SceneObject*> volumes;
+    volumes.clear();
 
     float expansion = this->mRadius + 0.2000000029802322;
     Point3F in_rMax(fmax(startPos.x, endPos.x) + expansion, fmax(startPos.y, endPos.y) + expansion, fmax(startPos.z, endPos.z) + expansion);
     Point3F in_rMin(fmin(startPos.x, endPos.x) - expansion, fmin(startPos.y, endPos.y) - expansion, fmin(startPos.z, endPos.z) - expansion);
     Box3F box(in_rMin, in_rMax);
-    
-    mContainer->findObjects(box, sTriggerItemMask, SimpleQueryList::insertionCallback, &sql);
-    for (int i = 0; i < sql.mList.size(); ++i)
+
+    if (!mContainer)
+        return;
+
+    getTriggerItemSweep(mContainer)->query(mTriggerSweepGeneration, box, volumes);
+    for (int i = 0; i < volumes.size(); ++i)
     {
-        auto& so = sql.mList[i];
+        SceneObject* so = volumes[i];
+
+        // The sweep's boxes are from the start of the tick, and an earlier
+        // volume's script may have hidden this one since
+        if (so->isHidden() || !so->isCollisionEnabled() ||
+            (!so->isGlobalBounds() && !so->getWorldBox().isOverlapped(box)))
+            continue;
+
         if ((so->getTypeMask() & TriggerObjectType) != 0)
         {
 #ifdef MB_ULTRA_PREVIEWS
@@ -217,6 +217,7 @@ private:
     bool mCameraInit;
     SceneObject* mPadPtr;
     bool mOnPad;
+    U32 mTriggerSweepGeneration;
     Marble::PowerUpState mPowerUpState[PowerUpData::MaxPowerUps];
     PowerUpData::ActiveParams mPowerUpParams;
     SimObjectPtr<ParticleEmitter> mTrailEmitter;
@@ -11,6 +11,7 @@
 #include "game/shapeBase.h"
 #include "core/bitStream.h"
 #include "sim/pathManager.h"
+#include "sim/netSimulator.h"
 #include "game/game.h"
 #include "sceneGraph/sceneGraph.h"
 #include "game/gameConnectionEvents.h"
@@ -599,6 +600,8 @@ void GameConnection::moveWritePacket(BitStream* bstream)
     Move* baseMove = NULL;
     for (int i = 0; i < count; i++)
     {
+        if (move[offset + i].sendCount == 0)
+            NetSimulator::noteMoveSent(this, start + i);
         move[offset + i].sendCount++;
         move[offset + i].pack(bstream, baseMove);
         bstream->writeInt(move[offset + i].checksum, Move::ChecksumBits);
@@ -1886,25 +1886,24 @@ MatrixF* Player::Death::fallToGround(F32 dt, const Point3F& loc, F32 curZ, F32 b
         // normal is within about 5 deg. of vertical.
         if (desNormal.z > 0.995)
         {
-            Point3F  corners[3], downpts[3];
+            Container::RayQuery corners[3];
+            RayInfo  hits[3];
+            Point3F  downpts[3];
             S32      c;
 
             for (c = 0; c < 3; c++) {    // Build 3 corners to cast down from-
-                corners[c].set(loc.x - boxRad, loc.y - boxRad, loc.z + 1.0);
+                corners[c].start.set(loc.x - boxRad, loc.y - boxRad, loc.z + 1.0);
                 if (c)      // add (0,boxWidth) and (boxWidth,0)
-                    corners[c][c - 1] += (boxRad * 2.0);
-                downpts[c].set(corners[c].x, corners[c].y, loc.z - sConformCheckDown);
+                    corners[c].start[c - 1] += (boxRad * 2.0);
+                corners[c].end.set(corners[c].start.x, corners[c].start.y, loc.z - sConformCheckDown);
             }
 
-            // Do the three casts-
-            for (S32 c = 0; c < 3; c++)
-                if (getCurrentClientContainer()->castRay(corners[c], downpts[c], sPlayerConformMask, &coll))
-                    downpts[c] = coll.point;
-                else
-                    break;
+            // Do the three casts together-
+            if (getCurrentClientContainer()->castRays(corners, 3, sPlayerConformMask, hits) == 3) {
+                for (c = 0; c < 3; c++)
+                    downpts[c] = hits[c].point;
 
-            // Do the math if everything hit below-
-            if (c == 3) {
+                // Do the math since everything hit below-
                 mCross(downpts[1] -= downpts[0], downpts[2] -= downpts[1], &desNormal);
                 AssertFatal(desNormal.z > 0, "Abnormality in Player::Death::fallToGround()");
                 desNormal.normalize();
@@ -2341,7 +2341,14 @@ void ShapeBase::advanceThreads(F32 dt)
     }
 
     if (anim)
-        mShapeInstance->animate();
+    {
+        // Client shapes are animated together once every object has
+        // advanced, see ProcessList::advanceTime.
+        if (isClientObject())
+            TSShapeInstance::queueAnimate(mShapeInstance);
+        else
+            mShapeInstance->animate();
+    }
 }
 
 
@@ -6,7 +6,315 @@
 #include "tickCache.h"
 
 #include "game/moveManager.h"
+#include "console/console.h"
 
-FreeListChunker<TickCacheEntry> TickCacheEntry::smTickCacheEntryStore;
 FreeListChunker<Move> TickCacheEntry::smMoveStore;
-FreeListChunker<TickCacheHead> TickCacheHead::smTickCacheHeadStore;
+
+U32 TickCache::smTotalMemory = 0;
+U32 TickCache::smTotalEntries = 0;
+U32 TickCache::smTotalCaches = 0;
+
+//----------------------------------------------------------------------------
+
+TickCache::TickCache()
+{
+    VECTOR_SET_ASSOCIATION(mSlots);
+    VECTOR_SET_ASSOCIATION(mData);
+
+    mOldest = 0;
+    mNumEntry = 0;
+    mNext = 0;
+    mDataUsed = 0;
+    mDataLive = 0;
+    mCodesSinceKey = 0;
+    mCurrent = -1;
+    mMemory = 0;
+    mEntry.move = NULL;
+    dMemset(mKey, 0, sizeof(mKey));
+
+    smTotalCaches++;
+    updateMemory();
+}
+
+TickCache::~TickCache()
+{
+    mCurrent = -1;
+    while (mNumEntry)
+        dropOldest();
+
+    smTotalCaches--;
+    smTotalMemory -= mMemory;
+}
+
+void TickCache::beginCacheList()
+{
+    flush();
+    mNext = 0;
+}
+
+TickCacheEntry* TickCache::incCacheList(bool addIfNeeded)
+{
+    flush();
+
+    if (mNext < mNumEntry)
+        mCurrent = mNext++;
+    else if (addIfNeeded)
+    {
+        // stays past the end, so the next one is added too
+        addEntry();
+        mCurrent = mNumEntry - 1;
+        mNext = mNumEntry;
+    }
+    else
+        return NULL;
+
+    return handOut(mCurrent);
+}
+
+TickCacheEntry* TickCache::addCacheEntry()
+{
+    flush();
+    addEntry();
+    return handOut(mNumEntry - 1);
+}
+
+void TickCache::ageCache(S32 numToAge, S32 len)
+{
+    AssertFatal(mNumEntry > U32(numToAge), "Too few entries!");
+
+    flush();
+    while (numToAge--)
+        dropOldest();
+    while (S32(mNumEntry) > len)
+        dropNextOldest();
+    while (S32(mNumEntry) < len)
+        addEntry();
+    updateMemory();
+}
+
+void TickCache::setCacheSize(S32 len)
+{
+    flush();
+
+    // grow cache to len size, adding to newest side of the list
+    while (S32(mNumEntry) < len)
+        addEntry();
+    // shrink tick cache down to given size, popping off oldest entries first
+    while (S32(mNumEntry) > len)
+        dropOldest();
+    updateMemory();
+}
+
+//----------------------------------------------------------------------------
+
+TickCacheEntry* TickCache::handOut(U32 index)
+{
+    const Slot& slot = getSlot(index);
+    decode(slot, mEntry.packetData);
+    dMemcpy(mEntryOriginal, mEntry.packetData, sizeof(mEntryOriginal));
+    mEntry.move = slot.move;
+    mCurrent = index;
+    return &mEntry;
+}
+
+void TickCache::flush()
+{
+    if (mCurrent < 0)
+        return;
+
+    Slot& slot = getSlot(mCurrent);
+    slot.move = mEntry.move;
+    mCurrent = -1;
+
+    if (dMemcmp(mEntry.packetData, mEntryOriginal, sizeof(mEntryOriginal)) == 0)
+        return;
+
+    encode(slot, mEntry.packetData);
+
+    // Once every entry has been coded against the key and they're still
+    // big on average, this entry makes a better key
+    if (mNumEntry > 1 && mCodesSinceKey >= mNumEntry &&
+        mDataLive > mNumEntry * TickCacheEntry::MaxPacketSize / 4)
+        rekey(mEntry.packetData);
+
+    updateMemory();
+}
+
+void TickCache::addEntry()
+{
+    if (mNumEntry == mSlots.size())
+    {
+        // Double the ring, unwrapping it so the oldest is first again
+        static Vector<Slot> slots;
+        slots.setSize(mNumEntry);
+        for (U32 i = 0; i < mNumEntry; i++)
+            slots[i] = getSlot(i);
+
+        mSlots.setSize(getMax(U32(mSlots.size()) * 2, U32(4)));
+        if (mNumEntry)
+            dMemcpy(mSlots.address(), slots.address(), mNumEntry * sizeof(Slot));
+        mOldest = 0;
+    }
+
+    // A new entry starts out as the key
+    Slot& slot = getSlot(mNumEntry);
+    slot.offset = 0;
+    slot.size = 0;
+    slot.move = NULL;
+
+    mNumEntry++;
+    smTotalEntries++;
+}
+
+void TickCache::dropOldest()
+{
+    AssertFatal(mNumEntry, "Popping off too many tick cache entries");
+
+    Slot& oldest = getSlot(0);
+    if (oldest.move)
+        TickCacheEntry::freeMove(oldest.move);
+    mDataLive -= oldest.size;
+
+    mOldest = (mOldest + 1) & (mSlots.size() - 1);
+    mNumEntry--;
+    smTotalEntries--;
+    if (!mNumEntry)
+        mDataUsed = mDataLive = 0;
+}
+
+void TickCache::dropNextOldest()
+{
+    AssertFatal(mNumEntry > 1, "Popping off too many tick cache entries");
+
+    Slot& next = getSlot(1);
+    if (next.move)
+        TickCacheEntry::freeMove(next.move);
+    mDataLive -= next.size;
+
+    // the oldest moves up into its place
+    next = getSlot(0);
+    mOldest = (mOldest + 1) & (mSlots.size() - 1);
+    mNumEntry--;
+    smTotalEntries--;
+}
+
+//----------------------------------------------------------------------------
+
+void TickCache::encode(Slot& slot, const U8* data)
+{
+    // Runs of (bytes same as the key, bytes which differ, the differing
+    // bytes XOR'd with the key).  Trailing sameness isn't stored.
+    U8 code[TickCacheEntry::MaxPacketSize * 2];
+    U32 size = 0;
+    U32 i = 0;
+    for (;;)
+    {
+        U32 same = 0;
+        while (i < TickCacheEntry::MaxPacketSize && data[i] == mKey[i] && same < 255)
+            i++, same++;
+        if (i == TickCacheEntry::MaxPacketSize)
+            break;
+
+        U32 start = i;
+        while (i < TickCacheEntry::MaxPacketSize && data[i] != mKey[i] && i - start < 255)
+            i++;
+
+        code[size++] = U8(same);
+        code[size++] = U8(i - start);
+        for (U32 j = start; j < i; j++)
+            code[size++] = data[j] ^ mKey[j];
+    }
+
+    mDataLive -= slot.size;
+    mCodesSinceKey++;
+
+    if (size > slot.size)
+    {
+        // Doesn't fit where it was.  Squeeze out the dead space if there's
+        // a lot of it, else grow.
+        slot.size = 0;
+        if (mDataUsed + size > mData.size() && mDataUsed - mDataLive > mDataUsed / 2)
+            compact();
+        if (mDataUsed + size > mData.size())
+            mData.setSize(getMax(U32(mData.size()) * 2, mDataUsed + size));
+
+        slot.offset = mDataUsed;
+        mDataUsed += size;
+    }
+
+    dMemcpy(mData.address() + slot.offset, code, size);
+    slot.size = size;
+    mDataLive += size;
+}
+
+void TickCache::decode(const Slot& slot, U8* data) const
+{
+    dMemcpy(data, mKey, TickCacheEntry::MaxPacketSize);
+
+    const U8* code = mData.address() + slot.offset;
+    const U8* end = code + slot.size;
+    U32 i = 0;
+    while (code < end)
+    {
+        i += *code++;
+        for (U32 count = *code++; count; count--)
+            data[i++] ^= *code++;
+    }
+}
+
+void TickCache::rekey(const U8* data)
+{
+    static Vector<U8> entries;
+    entries.setSize(mNumEntry * TickCacheEntry::MaxPacketSize);
+
+    U32 i;
+    for (i = 0; i < mNumEntry; i++)
+        decode(getSlot(i), entries.address() + i * TickCacheEntry::MaxPacketSize);
+
+    dMemcpy(mKey, data, sizeof(mKey));
+    mDataUsed = mDataLive = 0;
+    for (i = 0; i < mNumEntry; i++)
+        getSlot(i).size = 0;
+    for (i = 0; i < mNumEntry; i++)
+        encode(getSlot(i), entries.address() + i * TickCacheEntry::MaxPacketSize);
+
+    mCodesSinceKey = 0;
+}
+
+void TickCache::compact()
+{
+    static Vector<U8> live;
+    live.setSize(mDataLive);
+
+    U32 used = 0;
+    for (U32 i = 0; i < mNumEntry; i++)
+    {
+        Slot& slot = getSlot(i);
+        dMemcpy(live.address() + used, mData.address() + slot.offset, slot.size);
+        slot.offset = used;
+        used += slot.size;
+    }
+
+    if (used)
+        dMemcpy(mData.address(), live.address(), used);
+    mDataUsed = used;
+}
+
+void TickCache::updateMemory()
+{
+    U32 memory = sizeof(TickCache) + mSlots.size() * sizeof(Slot) + mData.size();
+    smTotalMemory += memory - mMemory;
+    mMemory = memory;
+}
+
+//----------------------------------------------------------------------------
+
+ConsoleFunction(tickCacheStats, void, 1, 1, "()"
+    "Print how much memory the hi fi objects' tick caches are using.")
+{
+    argc, argv;
+    U32 entries = TickCache::getTotalEntries();
+    Con::printf("Tick caches: %d objects, %d entries, %.1f KB (%.1f bytes per entry, %d uncompressed)",
+        TickCache::getTotalCaches(), entries, F32(TickCache::getTotalMemory()) / 1024.0f,
+        entries ? F32(TickCache::getTotalMemory()) / entries : 0.0f, U32(TickCacheEntry::MaxPacketSize));
+}
@@ -10,40 +10,113 @@
 #include "platform/platform.h"
 #endif
 #include "core/dataChunker.h"
+#include "core/tVector.h"
 
 struct Move;
 
+/// One tick of saved state, as handed out by TickCache.  It's a working copy:
+/// changes made to packetData are stored back the next time the cache is
+/// used, and the entry isn't valid after that.
 struct TickCacheEntry
 {
     enum { MaxPacketSize = 140 };
 
     U8 packetData[MaxPacketSize];
-    TickCacheEntry* next;
     Move* move;
 
-    static TickCacheEntry* alloc() { return smTickCacheEntryStore.alloc(); }
-    static void free(TickCacheEntry* entry) { smTickCacheEntryStore.free(entry); }
-
     // If you want to assign moves to tick cache for later playback, allocate them here
     static Move* allocMove() { return smMoveStore.alloc(); }
     static void freeMove(Move* move) { smMoveStore.free(move); }
 
-    static FreeListChunker<TickCacheEntry> smTickCacheEntryStore;
     static FreeListChunker<Move> smMoveStore;
-
 };
 
-struct TickCacheHead
+/// The last few ticks of packet data of a hi fi object, oldest to newest,
+/// for rolling it back and replaying it.
+///
+/// The entries sit in a ring which doubles when it runs out, so a longer
+/// window costs no allocation per tick.  Each is stored as its difference
+/// from a key snapshot: the bytes XOR'd with the key and run length coded,
+/// so state which barely changes from tick to tick takes a few bytes
+/// instead of MaxPacketSize.  The key is replaced by a recent entry when
+/// the entries have drifted too far from it.
+class TickCache
 {
-    TickCacheEntry* oldest;
-    TickCacheEntry* newest;
-    TickCacheEntry* next;
-    U32 numEntry;
+public:
+    TickCache();
+    ~TickCache();
+
+    /// Get ready to iterate from the oldest entry.
+    void beginCacheList();
+
+    /// The next entry, or a new newest entry past the end if addIfNeeded.
+    TickCacheEntry* incCacheList(bool addIfNeeded);
+
+    /// Add a newest entry, starting out as the key.
+    TickCacheEntry* addCacheEntry();
+
+    /// Drop numToAge of the oldest entries, then make it len long, keeping
+    /// the oldest entry and dropping or adding after it.
+    void ageCache(S32 numToAge, S32 len);
+
+    /// Grow on the newest side or shrink from the oldest side to len.
+    void setCacheSize(S32 len);
+
+    U32 getNumEntries() const { return mNumEntry; }
+
+    /// @name Memory
+    /// Bytes held by all tick caches, and what the same entries take
+    /// uncompressed.
+    /// @{
+    static U32 getTotalMemory() { return smTotalMemory; }
+    static U32 getTotalEntries() { return smTotalEntries; }
+    static U32 getTotalCaches() { return smTotalCaches; }
+    /// @}
+
+private:
+    struct Slot
+    {
+        U32 offset;     ///< Start of the coded bytes in mData.
+        U32 size;       ///< Coded size, 0 when it matches the key.
+        Move* move;
+    };
+
+    Vector<Slot> mSlots;    ///< Ring, size is a power of two.
+    U32 mOldest;
+    U32 mNumEntry;
+    U32 mNext;              ///< Iteration position, counted from the oldest.
+
+    Vector<U8> mData;       ///< Coded entries, appended.
+    U32 mDataUsed;          ///< End of the last append.
+    U32 mDataLive;          ///< Bytes still referenced by a slot.
+    U32 mCodesSinceKey;
+
+    U8 mKey[TickCacheEntry::MaxPacketSize];
+
+    /// What incCacheList last handed out, and which entry it was.
+    TickCacheEntry mEntry;
+    U8 mEntryOriginal[TickCacheEntry::MaxPacketSize];
+    S32 mCurrent;
+
+    U32 mMemory;
+
+    static U32 smTotalMemory;
+    static U32 smTotalEntries;
+    static U32 smTotalCaches;
+
+    Slot& getSlot(U32 index) { return mSlots[(mOldest + index) & (mSlots.size() - 1)]; }
 
-    static TickCacheHead* alloc() { return smTickCacheHeadStore.alloc(); }
-    static void free(TickCacheHead* head) { smTickCacheHeadStore.free(head); }
+    TickCacheEntry* handOut(U32 index);
+    void flush();
+    void addEntry();
+    void dropOldest();
+    void dropNextOldest();
 
-    static FreeListChunker<TickCacheHead> smTickCacheHeadStore;
+    void encode(Slot& slot, const U8* data);
+    void decode(const Slot& slot, U8* data) const;
+    void rekey(const U8* data);
+    void compact();
+    void updateMemory();
 };
 
-#endif // _TICKCACHE_H_
\ No newline at end of file
+#endif // _TICKCACHE_H_
@@ -6,6 +6,7 @@
 #include "gfx/Null/gfxNullDevice.h"
 #include "gfx/gfxCubemap.h"
 #include "gfx/screenshot.h"
+#include "core/stringTable.h"
 
 class GFXNullTextureObject : public GFXTextureObject 
 {
@@ -72,7 +73,7 @@ class GFXNullCubemap : public GFXCubemap
    friend class GFXDevice;
 private:
    // should only be called by GFXDevice
-   virtual void setToTexUnit( U32 tuNum ) override { };
+   virtual void setToTexUnit( U32 tuNum ) override { static_cast<GFXNullDevice*>(GFX)->getCounts().textureBinds++; };
 
 public:
    virtual void initStatic( GFXTexHandle *faces ) override { };
@@ -106,6 +107,10 @@ void GFXNullVertexBuffer::lock(U32 vertexStart, U32 vertexEnd, void **vertexPtr)
 {
    tempBuf = new unsigned char[(vertexEnd - vertexStart) * mVertexSize];
    *vertexPtr = (void*) tempBuf;
+
+   GFXNullCounts &counts = static_cast<GFXNullDevice*>(mDevice)->getCounts();
+   counts.vbLocks++;
+   counts.vbLockBytes += (vertexEnd - vertexStart) * mVertexSize;
    lockedVertexStart = vertexStart;
    lockedVertexEnd   = vertexEnd;
 }
@@ -140,6 +145,8 @@ void GFXNullPrimitiveBuffer::lock(U16 indexStart, U16 indexEnd, U16 **indexPtr)
 {
    temp = new U16[indexEnd - indexStart];
    *indexPtr = temp;
+
+   static_cast<GFXNullDevice*>(mDevice)->getCounts().pbLocks++;
 }
 
 void GFXNullPrimitiveBuffer::unlock() 
@@ -158,6 +165,12 @@ GFXNullDevice::GFXNullDevice()
    viewport.set(0, 0, 800, 600);
    clip.set(0, 0, 800, 800);
 
+   mSections[0].name = "(outside render bins)";
+   mNumSections = 1;
+   mSectionDepth = 0;
+   mCounts = &mSections[0].frame;
+   resetCounts();
+
    mTextureManager = new GFXNullTextureManager();
    gScreenShot = new ScreenShot();
 }
@@ -204,4 +217,169 @@ void GFXNullDevice::enumerateAdapters( Vector<GFXAdapter*> &adapterList )
 void GFXNullDevice::setLightInternal(U32 lightStage, const LightInfo light, bool lightEnable)
 {
 
-}
\ No newline at end of file
+}
+
+//-----------------------------------------------------------------------------
+// Counting
+//-----------------------------------------------------------------------------
+void GFXNullCounts::add(const GFXNullCounts &counts)
+{
+   // All U32s, so add them up as an array.
+   const U32 *src = (const U32*)&counts;
+   U32 *dst = (U32*)this;
+   for(U32 i = 0; i < sizeof(GFXNullCounts) / sizeof(U32); i++)
+      dst[i] += src[i];
+}
+
+bool GFXNullWindowTarget::present()
+{
+   mDevice->endFrame();
+   return true;
+}
+
+void GFXNullDevice::pushActiveRenderTarget()
+{
+   mTargetStack.push_back(mActiveTarget);
+}
+
+void GFXNullDevice::popActiveRenderTarget()
+{
+   AssertFatal(mTargetStack.size() > 0, "GFXNullDevice::popActiveRenderTarget - stack is empty!");
+   setActiveRenderTarget(mTargetStack.last());
+   mTargetStack.pop_back();
+}
+
+void GFXNullDevice::setActiveRenderTarget( GFXTarget *target )
+{
+   if(mActiveTarget.getPointer() != target)
+      mCounts->targetChanges++;
+   mActiveTarget = target;
+}
+
+U32 GFXNullDevice::findSection(const char *name)
+{
+   if(!name)
+      return 0;
+
+   for(U32 i = 1; i < mNumSections; i++)
+      if(mSections[i].name == name || !dStrcmp(mSections[i].name, name))
+         return i;
+
+   // Out of room, count it with the rest of the frame.
+   if(mNumSections == MaxSections)
+      return 0;
+
+   Section &section = mSections[mNumSections];
+   section.name = StringTable->insert(name);
+   section.frame.clear();
+   section.total.clear();
+   return mNumSections++;
+}
+
+void GFXNullDevice::enterDebugEvent(ColorI color, const char *name)
+{
+   U32 section = findSection(name);
+   if(mSectionDepth < MaxSectionDepth)
+      mSectionStack[mSectionDepth] = section;
+   mSectionDepth++;
+   mCounts = &mSections[section].frame;
+}
+
+void GFXNullDevice::leaveDebugEvent()
+{
+   AssertFatal(mSectionDepth > 0, "GFXNullDevice::leaveDebugEvent - no event to leave!");
+   mSectionDepth--;
+
+   U32 depth = getMin(mSectionDepth, U32(MaxSectionDepth));
+   mCounts = &mSections[depth ? mSectionStack[depth - 1] : 0].frame;
+}
+
+void GFXNullDevice::endFrame()
+{
+   mLastFrame.clear();
+   for(U32 i = 0; i < mNumSections; i++)
+   {
+      mLastFrame.add(mSections[i].frame);
+      mSections[i].total.add(mSections[i].frame);
+      mSections[i].frame.clear();
+   }
+   mTotal.add(mLastFrame);
+   mFrames++;
+}
+
+void GFXNullDevice::resetCounts()
+{
+   for(U32 i = 0; i < mNumSections; i++)
+   {
+      mSections[i].frame.clear();
+      mSections[i].total.clear();
+   }
+   mLastFrame.clear();
+   mTotal.clear();
+   mFrames = 0;
+}
+
+static void printCounts(const char *name, const GFXNullCounts &counts, U32 frames)
+{
+   F32 scale = 1.0f / (frames ? frames : 1);
+   Con::printf("   %8.1f %8.1f %8.1f %8.1f %8.1f %8.1f %8.1f %8.1f  %s",
+      counts.drawCalls * scale, counts.primitives * scale, counts.getStateChanges() * scale,
+      counts.textureBinds * scale, counts.matrices * scale, counts.vbLocks * scale,
+      counts.vbLockBytes * scale / 1024.0f, counts.pbLocks * scale, name);
+}
+
+void GFXNullDevice::dumpCounts()
+{
+   Con::printf("Null device counts, per frame over %d frames:", mFrames);
+   Con::printf("   %8s %8s %8s %8s %8s %8s %8s %8s  %s",
+      "draws", "prims", "states", "texbinds", "matrices", "vblocks", "vbKB", "pblocks", "section");
+
+   for(U32 i = 0; i < mNumSections; i++)
+      if(mSections[i].total.drawCalls || mSections[i].total.getStateChanges() || mSections[i].total.textureBinds)
+         printCounts(mSections[i].name, mSections[i].total, mFrames);
+
+   printCounts("total", mTotal, mFrames);
+   printCounts("last frame", mLastFrame, 1);
+   Con::printf("   %d clears and %d target changes in the last frame", mLastFrame.clears, mLastFrame.targetChanges);
+}
+
+//-----------------------------------------------------------------------------
+
+static GFXNullDevice *getNullDevice()
+{
+   if(!GFXDevice::devicePresent() || GFX->getAdapterType() != NullDevice)
+   {
+      Con::errorf("The Null device isn't the active device.");
+      return NULL;
+   }
+   return static_cast<GFXNullDevice*>(GFX);
+}
+
+ConsoleFunction(dumpNullGFXCounts, void, 1, 2, "(bool reset = true)"
+   "Print the draw calls, state changes, texture binds and buffer locks the Null "
+   "device was asked for, per frame and per render bin.")
+{
+   GFXNullDevice *device = getNullDevice();
+   if(!device)
+      return;
+
+   device->dumpCounts();
+   if(argc < 2 || dAtob(argv[1]))
+      device->resetCounts();
+}
+
+ConsoleFunction(getNullGFXFrameCounts, const char *, 1, 1, "()"
+   "Returns \"draws primitives stateChanges textureBinds vbLocks pbLocks\" for the "
+   "last frame drawn on the Null device.")
+{
+   argc, argv;
+   GFXNullDevice *device = getNullDevice();
+   if(!device)
+      return "";
+
+   const GFXNullCounts &counts = device->getLastFrameCounts();
+   char *ret = Con::getReturnBuffer(96);
+   dSprintf(ret, 96, "%d %d %d %d %d %d", counts.drawCalls, counts.primitives,
+      counts.getStateChanges(), counts.textureBinds, counts.vbLocks, counts.pbLocks);
+   return ret;
+}
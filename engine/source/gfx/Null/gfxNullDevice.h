@@ -14,15 +14,44 @@
 #include "gfx/gfxInit.h"
 #include "gfx/gfxFence.h"
 
+class GFXNullDevice;
+
+/// What the Null device was asked to do.  The Null device draws nothing, so
+/// these counts are the whole cost of a frame as far as the renderer goes,
+/// which makes them a steady number to compare batching changes against.
+struct GFXNullCounts
+{
+   U32 drawCalls;
+   U32 primitives;
+   U32 renderStates;
+   U32 textureStageStates;
+   U32 samplerStates;
+   U32 textureBinds;
+   U32 matrices;
+   U32 vbLocks;
+   U32 vbLockBytes;
+   U32 pbLocks;
+   U32 clears;
+   U32 targetChanges;
+
+   void clear() { dMemset(this, 0, sizeof(GFXNullCounts)); }
+   void add(const GFXNullCounts &counts);
+
+   /// Total of the state changes made by GFXDevice::updateStates.
+   U32 getStateChanges() const { return renderStates + textureStageStates + samplerStates; }
+};
+
 class GFXNullWindowTarget : public GFXWindowTarget
 {
    //PlatformWindow *mWindow;
+   GFXNullDevice *mDevice;
 
 public:
 
-   GFXNullWindowTarget()//PlatformWindow *win)
+   GFXNullWindowTarget(GFXNullDevice *device)//PlatformWindow *win)
    {
       //mWindow = win;
+      mDevice = device;
    }
 
 //   virtual PlatformWindow *getWindow()
@@ -30,10 +59,7 @@ public:
 //      return mWindow;
 //   }
 
-   virtual bool present()
-   {
-      return true;
-   }
+   virtual bool present();
 
    virtual const Point2I getSize()
    {
@@ -51,6 +77,29 @@ public:
 
 };
 
+class GFXNullTextureTarget : public GFXTextureTarget
+{
+   GFXTexHandle mColor;
+   Point2I mSize;
+
+public:
+
+   GFXNullTextureTarget(const Point2I &size) : mSize(size) { }
+
+   virtual const Point2I getSize() { return mColor.isNull() ? mSize : Point2I(mColor.getWidth(), mColor.getHeight()); }
+
+   virtual void attachTexture(RenderSlot slot, GFXTextureObject *tex, U32 mipLevel=0, U32 zOffset = 0)
+   {
+      if(slot == Color0)
+         mColor = tex;
+   }
+   virtual void attachTexture(RenderSlot slot, GFXCubemap *tex, U32 face, U32 mipLevel=0) { }
+   virtual void clearAttachments() { mColor = NULL; }
+
+   virtual void zombify() {};
+   virtual void resurrect() {};
+};
+
 class GFXNullDevice : public GFXDevice
 {
    typedef GFXDevice Parent;
@@ -58,6 +107,41 @@ class GFXNullDevice : public GFXDevice
 private:
    RectI viewport;
    RectI clip;
+
+   GFXTargetRef mActiveTarget;
+   Vector<GFXTargetRef> mTargetStack;
+
+public:
+   enum Constants
+   {
+      /// Distinct debug event names which get their own counts.
+      MaxSections = 32,
+      MaxSectionDepth = 16,
+   };
+
+   /// Counts made between one enterDebugEvent and its leaveDebugEvent.  The
+   /// render bins are each wrapped in one, so this breaks a frame down by bin.
+   struct Section
+   {
+      const char *name;
+      GFXNullCounts frame;
+      GFXNullCounts total;
+   };
+
+private:
+   /// Section 0 holds whatever was done outside any debug event.
+   Section mSections[MaxSections];
+   U32 mNumSections;
+   U32 mSectionStack[MaxSectionDepth];
+   U32 mSectionDepth;
+   GFXNullCounts *mCounts;
+
+   GFXNullCounts mLastFrame;
+   GFXNullCounts mTotal;
+   U32 mFrames;
+
+   U32 findSection(const char *name);
+
 public:
    GFXNullDevice();
    virtual ~GFXNullDevice();
@@ -74,8 +158,8 @@ public:
 
    /// @name Debug Methods
    /// @{
-   virtual void enterDebugEvent(ColorI color, const char *name) override { };
-   virtual void leaveDebugEvent() override { };
+   virtual void enterDebugEvent(ColorI color, const char *name) override;
+   virtual void leaveDebugEvent() override;
    virtual void setDebugMarker(ColorI color, const char *name) override { };
    /// @}
 
@@ -86,16 +170,16 @@ public:
    virtual void setVideoMode( const GFXVideoMode &mode ) override { };
 protected:
    /// Sets states which have to do with general rendering
-   virtual void setRenderState( U32 state, U32 value) override { };
+   virtual void setRenderState( U32 state, U32 value) override { mCounts->renderStates++; };
 
    /// Sets states which have to do with how textures are displayed
-   virtual void setTextureStageState( U32 stage, U32 state, U32 value ) override { };
+   virtual void setTextureStageState( U32 stage, U32 state, U32 value ) override { mCounts->textureStageStates++; };
 
    /// Sets states which have to do with texture sampling and addressing
-   virtual void setSamplerState( U32 stage, U32 type, U32 value ) override { };
+   virtual void setSamplerState( U32 stage, U32 type, U32 value ) override { mCounts->samplerStates++; };
    /// @}
 
-   virtual void setTextureInternal(U32 textureUnit, const GFXTextureObject*texture) override { };
+   virtual void setTextureInternal(U32 textureUnit, const GFXTextureObject*texture) override { mCounts->textureBinds++; };
 
    virtual void setLightInternal(U32 lightStage, const LightInfo light, bool lightEnable) override;
    virtual void setLightMaterialInternal(const GFXLightMaterial mat) override { };
@@ -108,7 +192,7 @@ protected:
    /// is created.
    virtual void initStates() override { };
 
-   virtual void setMatrix( GFXMatrixType mtype, const MatrixF &mat ) override { };
+   virtual void setMatrix( GFXMatrixType mtype, const MatrixF &mat ) override { mCounts->matrices++; };
 
    virtual GFXVertexBuffer *allocVertexBuffer( U32 numVerts, U32 vertFlags, U32 vertSize, GFXBufferType bufferType ) override;
    virtual GFXPrimitiveBuffer *allocPrimitiveBuffer( U32 numIndices, U32 numPrimitives, GFXBufferType bufferType ) override;
@@ -124,21 +208,21 @@ public:
 
    ///@}
 
-   virtual GFXTextureTarget *allocRenderToTextureTarget() override {return NULL;};
-   virtual GFXTextureTarget *allocRenderToTextureTarget(Point2I size, GFXFormat format) {return NULL;};
+   virtual GFXTextureTarget *allocRenderToTextureTarget() override { return new GFXNullTextureTarget(Point2I(1,1)); };
+   virtual GFXTextureTarget *allocRenderToTextureTarget(Point2I size, GFXFormat format) { return new GFXNullTextureTarget(size); };
    virtual GFXWindowTarget *allocWindowTarget(/*PlatformWindow *window*/) override
    {
-      GFXNullWindowTarget* target = new GFXNullWindowTarget();//window);
+      GFXNullWindowTarget* target = new GFXNullWindowTarget(this);//window);
 
       getDeviceEventSignal().trigger(deInit);
 
       return target;
    };
 
-   virtual void pushActiveRenderTarget() override {};
-   virtual void popActiveRenderTarget() override {};
-   virtual void setActiveRenderTarget( GFXTarget *target ) override {};
-   virtual GFXTarget *getActiveRenderTarget() override {return NULL;};
+   virtual void pushActiveRenderTarget() override;
+   virtual void popActiveRenderTarget() override;
+   virtual void setActiveRenderTarget( GFXTarget *target ) override;
+   virtual GFXTarget *getActiveRenderTarget() override { return mActiveTarget; };
 
    virtual F32 getPixelShaderVersion() const override { return 0.0f; };
    virtual void setPixelShaderVersion( F32 version ) override { };
@@ -151,12 +235,20 @@ public:
    virtual void flushProceduralShaders() override { };
 
 
-   virtual void clear( U32 flags, ColorI color, F32 z, U32 stencil ) override { };
+   virtual void clear( U32 flags, ColorI color, F32 z, U32 stencil ) override { mCounts->clears++; };
    virtual void beginSceneInternal() override { };
    virtual void endSceneInternal() override { };
 
-   virtual void drawPrimitive( GFXPrimitiveType primType, U32 vertexStart, U32 primitiveCount ) override { };
-   virtual void drawIndexedPrimitive( GFXPrimitiveType primType, U32 minIndex, U32 numVerts, U32 startIndex, U32 primitiveCount ) override { };
+   virtual void drawPrimitive( GFXPrimitiveType primType, U32 vertexStart, U32 primitiveCount ) override
+   {
+      mCounts->drawCalls++;
+      mCounts->primitives += primitiveCount;
+   };
+   virtual void drawIndexedPrimitive( GFXPrimitiveType primType, U32 minIndex, U32 numVerts, U32 startIndex, U32 primitiveCount ) override
+   {
+      mCounts->drawCalls++;
+      mCounts->primitives += primitiveCount;
+   };
 
    virtual void setViewport( const RectI &rect ) override { };
    virtual const RectI &getViewport() const override { return viewport; };
@@ -172,6 +264,25 @@ public:
 
    virtual GFXFormat selectSupportedFormat( GFXTextureProfile *profile, const Vector<GFXFormat> &formats, bool texture, bool mustblend ) override { return GFXFormatR8G8B8A8; };
    GFXFence *createFence() override { return new GFXGeneralFence( this ); }
+
+   /// @name Counting
+   /// @{
+
+   /// Counts for whatever section of the frame is being drawn now.
+   GFXNullCounts &getCounts() { return *mCounts; }
+
+   /// Called when the window target presents.  Folds this frame's counts
+   /// into the totals.
+   void endFrame();
+
+   /// Clear the totals and the frame count.
+   void resetCounts();
+
+   /// Print per frame averages since the last reset, by section.
+   void dumpCounts();
+
+   const GFXNullCounts &getLastFrameCounts() const { return mLastFrame; }
+   /// @}
 };
 
 #endif
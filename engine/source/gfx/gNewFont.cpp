@@ -405,6 +405,9 @@ GFont::GFont()
     for (U32 i = 0; i < (sizeof(mRemapTable) / sizeof(S32)); i++)
         mRemapTable[i] = -1;
 
+    for (U32 i = 0; i < MetricPageCount; i++)
+        mMetricPages[i] = NULL;
+
     mCurX = mCurY = mCurSheet = -1;
 
     mPlatformFont = NULL;
@@ -447,6 +450,7 @@ GFont::~GFont()
     }
 
     SAFE_DELETE(mPlatformFont);
+    flushGlyphMetrics();
 
     Mutex::destroyMutex(mMutex);
 }
@@ -601,6 +605,129 @@ const PlatformFont::CharInfo& GFont::getCharInfo(const UTF16 in_charIndex)
     return mCharInfoList[mRemapTable[in_charIndex]];
 }
 
+const GFont::GlyphMetrics& GFont::loadGlyphMetrics(const UTF16 in_charIndex)
+{
+    GlyphMetrics*& page = mMetricPages[in_charIndex >> MetricPageShift];
+    if (!page)
+    {
+        page = new GlyphMetrics[MetricPageSize];
+        dMemset(page, 0, sizeof(GlyphMetrics) * MetricPageSize);
+    }
+
+    GlyphMetrics& metrics = page[in_charIndex & (MetricPageSize - 1)];
+    if (in_charIndex && isValidChar(in_charIndex))
+    {
+        const PlatformFont::CharInfo& rChar = getCharInfo(in_charIndex);
+        metrics.advance = rChar.xIncrement;
+        metrics.width = rChar.width;
+        metrics.flags = GlyphMetrics::Known | GlyphMetrics::Valid;
+    }
+    else if (in_charIndex == dT('\t'))
+    {
+        // Same as the width functions have always done, a tab is as wide as
+        // a few spaces but has no glyph of its own.
+        metrics.advance = getCharInfo(dT(' ')).xIncrement * TabWidthInSpaces;
+        metrics.width = 0;
+        metrics.flags = GlyphMetrics::Known;
+    }
+    else
+    {
+        metrics.advance = 0;
+        metrics.width = 0;
+        metrics.flags = GlyphMetrics::Known;
+    }
+
+    return metrics;
+}
+
+void GFont::flushGlyphMetrics()
+{
+    for (U32 i = 0; i < MetricPageCount; i++)
+        SAFE_DELETE_ARRAY(mMetricPages[i]);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace {
+    /// True if the string is plain ASCII up to count bytes or its end,
+    /// whichever comes first.  Each of those bytes is then one UTF16
+    /// character, so it can be measured without converting it.
+    bool isAsciiRun(const UTF8* str, U32 count)
+    {
+        for (U32 i = 0; i < count && str[i]; i++)
+            if (U8(str[i]) & 0x80)
+                return false;
+        return true;
+    }
+
+    inline UTF16 toUTF16(const UTF8 c) { return U8(c); }
+    inline UTF16 toUTF16(const UTF16 c) { return c; }
+
+    /// Adds up the advance of up to count characters, stopping at a null.
+    /// charCount is left on the character it stopped at.
+    template<class T> U32 sumAdvance(GFont* font, const T* str, U32 count, U32& charCount)
+    {
+        U32 totWidth = 0;
+        for (charCount = 0; charCount < count; charCount++)
+        {
+            UTF16 curChar = toUTF16(str[charCount]);
+            if (curChar == NULL)
+                break;
+
+            totWidth += font->getGlyphMetrics(curChar).advance;
+        }
+        return totWidth;
+    }
+
+    template<class T> U32 findBreakPos(GFont* font, const T* str, U32 len, U32 width, bool breakOnWhitespace)
+    {
+        U32 ret = 0;
+        U32 lastws = 0;
+
+        for (U32 charCount = 0; charCount < len; charCount++)
+        {
+            UTF16 c = toUTF16(str[charCount]);
+            if (c == NULL)
+                break;
+
+            if (c == dT('\t'))
+                c = dT(' ');
+            const GFont::GlyphMetrics& rChar = font->getGlyphMetrics(c);
+            if (!(rChar.flags & GFont::GlyphMetrics::Valid))
+            {
+                ret++;
+                continue;
+            }
+            if (c == dT(' '))
+                lastws = ret + 1;
+            if (rChar.width > width || rChar.advance > width)
+            {
+                if (lastws && breakOnWhitespace)
+                    return lastws;
+                return ret;
+            }
+            width -= rChar.advance;
+
+            ret++;
+        }
+        return ret;
+    }
+
+    template<class T> U32 strNWidthPrecise(GFont* font, const T* str, U32 n)
+    {
+        U32 charCount;
+        U32 totWidth = sumAdvance(font, str, n, charCount);
+
+        UTF16 endChar = toUTF16(str[getMin(charCount, n - 1)]);
+
+        const GFont::GlyphMetrics& rChar = font->getGlyphMetrics(endChar);
+        if (rChar.width > rChar.advance)
+            totWidth += (rChar.width - rChar.advance);
+
+        return totWidth;
+    }
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 U32 GFont::getStrWidth(const UTF8* in_pString)
@@ -626,6 +753,16 @@ U32 GFont::getStrWidthPrecise(const UTF8* in_pString)
 //////////////////////////////////////////////////////////////////////////
 U32 GFont::getStrNWidth(const UTF8* str, U32 n)
 {
+    AssertFatal(str != NULL, "GFont::getStrNWidth: String is NULL");
+
+    if (str == NULL || str[0] == NULL || n == 0)
+        return 0;
+
+    // Most text is plain ASCII, which can be measured straight from the bytes.
+    U32 charCount;
+    if (isAsciiRun(str, n + 1))
+        return sumAdvance(this, str, n + 1, charCount);
+
     // UTF8 conversion is expensive. Avoid converting in a tight loop.
     FrameTemp<UTF16> str16(n + 1);
     convertUTF8toUTF16(str, str16, n + 1);
@@ -639,33 +776,20 @@ U32 GFont::getStrNWidth(const UTF16* str, U32 n)
     if (str == NULL || str[0] == NULL || n == 0)
         return 0;
 
-    U32 totWidth = 0;
-    UTF16 curChar;
     U32 charCount;
-
-    for (charCount = 0; charCount <= n; charCount++)
-    {
-        curChar = str[charCount];
-        if (curChar == NULL)
-            break;
-
-        if (isValidChar(curChar))
-        {
-            const PlatformFont::CharInfo& rChar = getCharInfo(curChar);
-            totWidth += rChar.xIncrement;
-        }
-        else if (curChar == dT('\t'))
-        {
-            const PlatformFont::CharInfo& rChar = getCharInfo(dT(' '));
-            totWidth += rChar.xIncrement * TabWidthInSpaces;
-        }
-    }
-
-    return(totWidth);
+    return sumAdvance(this, str, n + 1, charCount);
 }
 
 U32 GFont::getStrNWidthPrecise(const UTF8* str, U32 n)
 {
+    AssertFatal(str != NULL, "GFont::getStrNWidthPrecise: String is NULL");
+
+    if (str == NULL || str[0] == NULL || n == 0)
+        return(0);
+
+    if (isAsciiRun(str, n))
+        return strNWidthPrecise(this, str, n);
+
     FrameTemp<UTF16> str16(n + 1);
     convertUTF8toUTF16(str, str16, n);
     return getStrNWidthPrecise(str16, n);
@@ -678,38 +802,7 @@ U32 GFont::getStrNWidthPrecise(const UTF16* str, U32 n)
     if (str == NULL || str[0] == NULL || n == 0)
         return(0);
 
-    U32 totWidth = 0;
-    UTF16 curChar;
-    U32 charCount = 0;
-
-    for (charCount = 0; charCount < n; charCount++)
-    {
-        curChar = str[charCount];
-        if (curChar == NULL)
-            break;
-
-        if (isValidChar(curChar))
-        {
-            const PlatformFont::CharInfo& rChar = getCharInfo(curChar);
-            totWidth += rChar.xIncrement;
-        }
-        else if (curChar == dT('\t'))
-        {
-            const PlatformFont::CharInfo& rChar = getCharInfo(dT(' '));
-            totWidth += rChar.xIncrement * TabWidthInSpaces;
-        }
-    }
-
-    UTF16 endChar = str[getMin(charCount, n - 1)];
-
-    if (isValidChar(endChar))
-    {
-        const PlatformFont::CharInfo& rChar = getCharInfo(endChar);
-        if (rChar.width > rChar.xIncrement)
-            totWidth += (rChar.width - rChar.xIncrement);
-    }
-
-    return(totWidth);
+    return strNWidthPrecise(this, str, n);
 }
 
 U32 GFont::getBreakPos(const UTF8* string, U32 slen, U32 width, bool breakOnWhitespace)
@@ -718,42 +811,14 @@ U32 GFont::getBreakPos(const UTF8* string, U32 slen, U32 width, bool breakOnWhit
     if (slen == 0)
         return 0;
 
-    U32 ret = 0;
-    U32 lastws = 0;
-    UTF16 c;
-    U32 charCount = 0;
+    if (isAsciiRun(string, slen))
+        return findBreakPos(this, string, slen, width, breakOnWhitespace);
 
     // convert the buffer to utf16, converter will give us the length.
     FrameTemp<UTF16> str16(slen);
     U32 len16 = convertUTF8toUTF16(string, str16, slen);
 
-    for (charCount = 0; charCount < len16; charCount++)
-    {
-        c = str16[charCount];
-        if (c == NULL)
-            break;
-
-        if (c == dT('\t'))
-            c = dT(' ');
-        if (!isValidChar(c))
-        {
-            ret++;
-            continue;
-        }
-        if (c == dT(' '))
-            lastws = ret + 1;
-        const PlatformFont::CharInfo& rChar = getCharInfo(c);
-        if (rChar.width > width || rChar.xIncrement > width)
-        {
-            if (lastws && breakOnWhitespace)
-                return lastws;
-            return ret;
-        }
-        width -= rChar.xIncrement;
-
-        ret++;
-    }
-    return ret;
+    return findBreakPos(this, (const UTF16*)str16, len16, width, breakOnWhitespace);
 }
 
 void GFont::wrapString(const UTF8* txt, U32 lineWidth, Vector<U32>& startLineOffset, Vector<U32>& lineLen)
@@ -780,9 +845,10 @@ void GFont::wrapString(const UTF8* txt, U32 lineWidth, Vector<U32>& startLineOff
         U32 lineStrWidth = 0;
         for (; i < len; i++)
         {
-            if (isValidChar(txt[i]))
+            const GlyphMetrics& rChar = getGlyphMetrics(txt[i]);
+            if (rChar.flags & GlyphMetrics::Valid)
             {
-                lineStrWidth += getCharInfo(txt[i]).xIncrement;
+                lineStrWidth += rChar.advance;
                 if (txt[i] == '\n' || lineStrWidth > lineWidth)
                 {
                     needsNewLine = true;
@@ -916,6 +982,8 @@ bool GFont::read(Stream& io_rStream)
             mRemapTable[i] = convertBEndianToHost(mRemapTable[i]);
     }
 
+    flushGlyphMetrics();
+
     return (io_rStream.getStatus() == Stream::Ok);
 }
 
@@ -1130,6 +1198,9 @@ void GFont::importStrip(const char* fileName, U32 padding, U32 kerning)
         curWidth += ri.extent.x;
     }
 
+    // The kerning changed every advance.
+    flushGlyphMetrics();
+
     // Ok, we have a big list of glyphmaps now. So let's sort them, then pack them.
     dQsort(glyphList.address(), glyphList.size(), sizeof(GlyphMap), GlyphMapCompare);
 
@@ -73,6 +73,37 @@ private:
                                            //    be accessed through the getCharInfo(U32)
                                            //    function to account for remapping...
     S32             mRemapTable[65536];    // - Index remapping
+
+public:
+    /// What the width functions need to know about a character, kept in
+    /// pages of 256 characters so measuring a string doesn't go through
+    /// getCharInfo for every character.
+    struct GlyphMetrics
+    {
+        enum Flags
+        {
+            Known = BIT(0),   ///< Filled in from the char info.
+            Valid = BIT(1),   ///< isValidChar() was true.
+        };
+
+        S16 advance;    ///< xIncrement, or the width of a tab if the font has no tab glyph.
+        U8  width;
+        U8  flags;
+    };
+
+private:
+    enum
+    {
+        MetricPageShift = 8,
+        MetricPageSize = 1 << MetricPageShift,
+        MetricPageCount = 65536 / MetricPageSize,
+    };
+
+    GlyphMetrics* mMetricPages[MetricPageCount];
+
+    const GlyphMetrics& loadGlyphMetrics(const UTF16 in_charIndex);
+    void flushGlyphMetrics();
+
 public:
     GFont();
     virtual ~GFont();
@@ -101,6 +132,9 @@ public:
 
     bool isValidChar(const UTF16 in_charIndex);
 
+    /// Width info for a character, filled in the first time it's asked for.
+    const GlyphMetrics& getGlyphMetrics(const UTF16 in_charIndex);
+
     const U32 getHeight() const { return mHeight; }
     const U32 getBaseline() const { return mBaseline; }
     const U32 getAscent() const { return mAscent; }
@@ -155,6 +189,7 @@ public:
     void forcePlatformFont(PlatformFont* pf)
     {
         mPlatformFont = pf;
+        flushGlyphMetrics();
     }
 };
 
@@ -187,5 +222,14 @@ inline bool GFont::isValidChar(const UTF16 in_charIndex)
     return false;
 }
 
+inline const GFont::GlyphMetrics& GFont::getGlyphMetrics(const UTF16 in_charIndex)
+{
+    const GlyphMetrics* page = mMetricPages[in_charIndex >> MetricPageShift];
+    if (page && page[in_charIndex & (MetricPageSize - 1)].flags)
+        return page[in_charIndex & (MetricPageSize - 1)];
+
+    return loadGlyphMetrics(in_charIndex);
+}
+
 
 #endif //_GFONT_H_
@@ -25,6 +25,7 @@ bool Interior::smRenderEnvironmentMaps = true;
 bool Interior::smUseVertexLighting = false;
 bool Interior::smUseTexturedFog = false;
 bool Interior::smLockArrays = true;
+bool Interior::smUseCollisionTree = true;
 
 
 // These are setup by setupActivePolyList
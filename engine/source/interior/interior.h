@@ -251,7 +251,22 @@ public:
     bool getIntersectingHulls(const Box3F&, U16* hulls, U32* numHulls);
     bool getIntersectingVehicleHulls(const Box3F&, U16* hulls, U32* numHulls);
 
+    /// Gather the hull surfaces into the collision tree.  Done on read.
+    void buildCollisionTree();
+
+    /// When set, buildPolyList queries the collision tree instead of
+    /// walking the hulls.
+    static bool smUseCollisionTree;
+
 protected:
+    enum CollisionTreeConstants
+    {
+        CollisionLeafSize = 4,
+        CollisionTreeMaxDepth = 64,
+    };
+
+    U32  buildCollisionNode(U32 start, U32 count);
+    void emitCollisionPoly(AbstractPolyList* list, U32 surfaceIndex, const U32* points, U32 numPoints) const;
     bool castRay_r(const U16, const U16, const Point3F&, const Point3F&, RayInfo*);
     void buildPolyList_r(InteriorPolytope& polytope,
         SurfaceHash& hash);
@@ -317,6 +332,13 @@ public:
     bool readVehicleCollision(Stream& stream);
     bool writeVehicleCollision(Stream& stream) const;
 
+    /// Load cache counterparts of read and write, see InteriorResource.
+    /// The arrays go as raw blocks and the load time setup is stored,
+    /// so the cache only suits the build that wrote it.
+    bool readCache(Stream& stream);
+    bool writeCache(Stream& stream) const;
+    static U32 getCacheLayout();
+
     void readCompressedVector(Stream& stream, Vector<U32>& vec);
 
 private:
@@ -767,6 +789,30 @@ private:
     Vector<U16>             mCoordBinIndices;
     U32                     mCoordBinMode;
 
+    /// Bounding volume tree over the hull surfaces, each surface once.
+    ///
+    /// Nodes are stored depth first, so an inner node's first child
+    /// follows it and right is the index of the second.  A leaf has count
+    /// items starting at right.  The bounds are laid out so that min and
+    /// max each load as one SSE register.
+    struct CollisionNode
+    {
+        Point3F min;
+        U32     right;
+        Point3F max;
+        U32     count;
+    };
+    struct CollisionItem
+    {
+        Point3F min;
+        U32     surfaceIndex;  ///< as in mHullSurfaceIndices
+        Point3F max;
+        U32     fanStart;      ///< into mCollisionFans, a point count then the points
+    };
+    Vector<CollisionNode>   mCollisionNodes;
+    Vector<CollisionItem>   mCollisionItems;
+    Vector<U32>             mCollisionFans;
+
     Vector<ConvexHull>      mVehicleConvexHulls;
     Vector<U8>              mVehicleConvexHullEmitStrings;
     Vector<U32>             mVehicleHullIndices;
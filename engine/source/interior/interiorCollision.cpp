@@ -11,6 +11,10 @@
 #include "core/frameAllocator.h"
 #include "platform/profiler.h"
 
+#ifdef TORQUE_SUPPORTS_SSE
+#include <xmmintrin.h>
+#endif
+
 namespace {
 
     //--------------------------------------
@@ -22,6 +26,36 @@ namespace {
         return mFabs(dist) < 0.1;
     }
 
+    //--------------------------------------
+    // Collision tree helpers.  min and max are an x, y, z and a word
+    // that isn't looked at.
+#ifdef TORQUE_SUPPORTS_SSE
+    inline bool overlapsQuery(const Point3F& min, const Point3F& max, __m128 queryMin, __m128 queryMax)
+    {
+        __m128 out = _mm_or_ps(_mm_cmpgt_ps(_mm_loadu_ps(&min.x), queryMax),
+            _mm_cmplt_ps(_mm_loadu_ps(&max.x), queryMin));
+        return (_mm_movemask_ps(out) & 7) == 0;
+    }
+#else
+    inline bool overlapsQuery(const Point3F& min, const Point3F& max, const Box3F& query)
+    {
+        return min.x <= query.max.x && min.y <= query.max.y && min.z <= query.max.z &&
+            max.x >= query.min.x && max.y >= query.min.y && max.z >= query.min.z;
+    }
+#endif
+
+    U32 sgSortAxis;
+
+    template <class T>
+    S32 QSORT_CALLBACK centerCompare(const void* a, const void* b)
+    {
+        const T* t1 = (const T*)a;
+        const T* t2 = (const T*)b;
+        F32 c1 = (&t1->min.x)[sgSortAxis] + (&t1->max.x)[sgSortAxis];
+        F32 c2 = (&t2->min.x)[sgSortAxis] + (&t2->max.x)[sgSortAxis];
+        return c1 < c2 ? -1 : (c1 > c2 ? 1 : 0);
+    }
+
 } // namespace {}
 
 
@@ -739,6 +773,69 @@ bool Interior::buildPolyList(AbstractPolyList* list,
     interiorBox.max.y += yrad;
     interiorBox.max.z += zrad;
 
+    // we only want surfaces which intersect the oriented bounding box...
+    Point3F radii = testBox.max - testBox.min;
+    radii *= 0.5f;
+    radii.x *= invScalex;
+    radii.y *= invScaley;
+    radii.z *= invScalez;
+
+    // adjust toItr transform so that origin of source space is box center
+    // Note:  center of interior box will be = to transformed center of testBox
+    Point3F center = interiorBox.min + interiorBox.max;
+    center *= 0.5f;
+    toItr.setColumn(3, center); // (0,0,0) now goes where box center used to...
+
+    if (smUseCollisionTree && mCollisionNodes.size())
+    {
+        PROFILE_START(InteriorCollisionTree);
+
+#ifdef TORQUE_SUPPORTS_SSE
+        __m128 queryMin = _mm_setr_ps(interiorBox.min.x, interiorBox.min.y, interiorBox.min.z, 0.0f);
+        __m128 queryMax = _mm_setr_ps(interiorBox.max.x, interiorBox.max.y, interiorBox.max.z, 0.0f);
+#define QUERY queryMin, queryMax
+#else
+#define QUERY interiorBox
+#endif
+
+        U32 stack[CollisionTreeMaxDepth];
+        U32 depth = 0;
+        stack[depth++] = 0;
+        while (depth)
+        {
+            U32 nodeIndex = stack[--depth];
+            const CollisionNode& node = mCollisionNodes[nodeIndex];
+            if (!overlapsQuery(node.min, node.max, QUERY))
+                continue;
+
+            if (!node.count)
+            {
+                AssertFatal(depth + 2 <= CollisionTreeMaxDepth, "Interior::buildPolyList: collision tree too deep");
+                stack[depth++] = node.right;
+                stack[depth++] = nodeIndex + 1;
+                continue;
+            }
+
+            for (U32 i = node.right; i < node.right + node.count; i++)
+            {
+                const CollisionItem& item = mCollisionItems[i];
+                if (!overlapsQuery(item.min, item.max, QUERY))
+                    continue;
+
+                Box3F itemBox(item.min, item.max);
+                if (!itemBox.collideOrientedBox(radii, toItr))
+                    continue;
+
+                const U32* fan = &mCollisionFans[item.fanStart];
+                emitCollisionPoly(list, item.surfaceIndex, fan + 1, fan[0]);
+            }
+        }
+#undef QUERY
+
+        PROFILE_END();
+        return !list->isEmpty();
+    }
+
     U32 waterMark = FrameAllocator::getWaterMark();
 
     U16* hulls = (U16*)FrameAllocator::alloc(mConvexHulls.size() * sizeof(U16));
@@ -754,19 +851,6 @@ bool Interior::buildPolyList(AbstractPolyList* list,
 
     // we've found all the hulls that intersect the lists interior space bounding box...
     // now cull out those hulls which don't intersect the oriented bounding box...
-
-    Point3F radii = testBox.max - testBox.min;
-    radii *= 0.5f;
-    radii.x *= invScalex;
-    radii.y *= invScaley;
-    radii.z *= invScalez;
-
-    // adjust toItr transform so that origin of source space is box center
-    // Note:  center of interior box will be = to transformed center of testBox
-    Point3F center = interiorBox.min + interiorBox.max;
-    center *= 0.5f;
-    toItr.setColumn(3, center); // (0,0,0) now goes where box center used to...
-
     for (S32 i = 0; i < numHulls; i++)
     {
         const ConvexHull& hull = mConvexHulls[hulls[i]];
@@ -778,46 +862,160 @@ bool Interior::buildPolyList(AbstractPolyList* list,
         for (S32 j = 0; j < hull.surfaceCount; j++)
         {
             U32 surfaceIndex = mHullSurfaceIndices[j + hull.surfaceStart];
+            U32 points[32];
+            U32 numPoints;
             if (isNullSurfaceIndex(surfaceIndex))
             {
                 // Is a NULL surface
                 const Interior::NullSurface& rSurface = mNullSurfaces[getNullSurfaceIndex(surfaceIndex)];
-                U32 array[32];
+                for (numPoints = 0; numPoints < rSurface.windingCount; numPoints++)
+                    points[numPoints] = mWindings[rSurface.windingStart + numPoints];
+            }
+            else
+                collisionFanFromSurface(mSurfaces[surfaceIndex], points, &numPoints);
 
-                list->begin(0, rSurface.planeIndex);
-                for (U32 k = 0; k < rSurface.windingCount; k++)
-                {
-                    array[k] = list->addPoint(mPoints[mWindings[rSurface.windingStart + k]].point);
-                    list->vertex(array[k]);
-                }
+            emitCollisionPoly(list, surfaceIndex, points, numPoints);
+        }
+    }
+
+    FrameAllocator::setWaterMark(waterMark);
+    return !list->isEmpty();
+}
+
+void Interior::emitCollisionPoly(AbstractPolyList* list, U32 surfaceIndex, const U32* points, U32 numPoints) const
+{
+    U16 planeIndex;
+    if (isNullSurfaceIndex(surfaceIndex))
+    {
+        planeIndex = mNullSurfaces[getNullSurfaceIndex(surfaceIndex)].planeIndex;
+        list->begin(0, planeIndex);
+    }
+    else
+    {
+        // MarbleBlast: Texture index is needed for friction information
+        const Interior::Surface& rSurface = mSurfaces[surfaceIndex];
+        planeIndex = rSurface.planeIndex;
+        list->begin(rSurface.textureIndex, planeIndex);
+    }
+
+    for (U32 k = 0; k < numPoints; k++)
+        list->vertex(list->addPoint(mPoints[points[k]].point));
+
+    list->plane(getFlippedPlane(planeIndex));
+    list->end();
+}
+
+//--------------------------------------------------------------------------
+void Interior::buildCollisionTree()
+{
+    mCollisionNodes.clear();
+    mCollisionItems.clear();
+    mCollisionFans.clear();
+
+    if (mConvexHulls.empty())
+        return;
+
+    // Hulls share surfaces, the tree holds each one once.
+    Vector<U8> seen(__FILE__, __LINE__);
+    seen.setSize(mSurfaces.size() + mNullSurfaces.size());
+    dMemset(seen.address(), 0, seen.size());
 
-                list->plane(getFlippedPlane(rSurface.planeIndex));
-                list->end();
+    for (U32 i = 0; i < mConvexHulls.size(); i++)
+    {
+        const ConvexHull& hull = mConvexHulls[i];
+        for (U32 j = 0; j < hull.surfaceCount; j++)
+        {
+            U32 surfaceIndex = mHullSurfaceIndices[j + hull.surfaceStart];
+            U32 points[32];
+            U32 numPoints;
+            U32 slot;
+            if (isNullSurfaceIndex(surfaceIndex))
+            {
+                slot = mSurfaces.size() + getNullSurfaceIndex(surfaceIndex);
+                const NullSurface& rSurface = mNullSurfaces[getNullSurfaceIndex(surfaceIndex)];
+                for (numPoints = 0; numPoints < rSurface.windingCount; numPoints++)
+                    points[numPoints] = mWindings[rSurface.windingStart + numPoints];
             }
             else
             {
-                const Interior::Surface& rSurface = mSurfaces[surfaceIndex];
-                U32 array[32];
-                U32 fanVerts[32];
-                U32 numVerts;
+                slot = surfaceIndex;
+                collisionFanFromSurface(mSurfaces[surfaceIndex], points, &numPoints);
+            }
 
-                collisionFanFromSurface(rSurface, fanVerts, &numVerts);
+            if (seen[slot] || !numPoints)
+                continue;
+            seen[slot] = 1;
 
-                // MarbleBlast: Texture index is needed for friction information
-                list->begin(rSurface.textureIndex, rSurface.planeIndex);
-                for (U32 k = 0; k < numVerts; k++)
-                {
-                    array[k] = list->addPoint(mPoints[fanVerts[k]].point);
-                    list->vertex(array[k]);
-                }
-                list->plane(getFlippedPlane(rSurface.planeIndex));
-                list->end();
+            mCollisionItems.increment();
+            CollisionItem& item = mCollisionItems.last();
+            item.surfaceIndex = surfaceIndex;
+            item.fanStart = mCollisionFans.size();
+            item.min = item.max = mPoints[points[0]].point;
+
+            mCollisionFans.push_back(numPoints);
+            for (U32 k = 0; k < numPoints; k++)
+            {
+                mCollisionFans.push_back(points[k]);
+                item.min.setMin(mPoints[points[k]].point);
+                item.max.setMax(mPoints[points[k]].point);
             }
         }
     }
 
-    FrameAllocator::setWaterMark(waterMark);
-    return !list->isEmpty();
+    if (mCollisionItems.size())
+    {
+        mCollisionNodes.reserve(mCollisionItems.size() / CollisionLeafSize * 2 + 1);
+        buildCollisionNode(0, mCollisionItems.size());
+    }
+}
+
+U32 Interior::buildCollisionNode(U32 start, U32 count)
+{
+    U32 nodeIndex = mCollisionNodes.size();
+    mCollisionNodes.increment();
+
+    Point3F min = mCollisionItems[start].min;
+    Point3F max = mCollisionItems[start].max;
+    Point3F centerMin = (mCollisionItems[start].min + mCollisionItems[start].max) * 0.5f;
+    Point3F centerMax = centerMin;
+    for (U32 i = start + 1; i < start + count; i++)
+    {
+        const CollisionItem& item = mCollisionItems[i];
+        min.setMin(item.min);
+        max.setMax(item.max);
+
+        Point3F center = (item.min + item.max) * 0.5f;
+        centerMin.setMin(center);
+        centerMax.setMax(center);
+    }
+
+    mCollisionNodes[nodeIndex].min = min;
+    mCollisionNodes[nodeIndex].max = max;
+
+    if (count <= CollisionLeafSize)
+    {
+        mCollisionNodes[nodeIndex].right = start;
+        mCollisionNodes[nodeIndex].count = count;
+        return nodeIndex;
+    }
+
+    // Split at the median along the axis the centers spread furthest on,
+    // which keeps the tree balanced and its depth at log2 of the surfaces.
+    Point3F extent = centerMax - centerMin;
+    sgSortAxis = 0;
+    if (extent.y > extent.x)
+        sgSortAxis = 1;
+    if (extent.z > (&extent.x)[sgSortAxis])
+        sgSortAxis = 2;
+    dQsort(&mCollisionItems[start], count, sizeof(CollisionItem), centerCompare<CollisionItem>);
+
+    U32 half = count / 2;
+    buildCollisionNode(start, half);
+    U32 right = buildCollisionNode(start + half, count - half);
+
+    mCollisionNodes[nodeIndex].right = right;
+    mCollisionNodes[nodeIndex].count = 0;
+    return nodeIndex;
 }
 
 bool Interior::buildLightPolyList(U32* lightSurfaces,
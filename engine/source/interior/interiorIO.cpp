@@ -18,6 +18,37 @@ int QSORT_CALLBACK cmpU32(const void* p1, const void* p2)
     return S32(*((U32*)p1)) - S32(*((U32*)p2));
 }
 
+namespace {
+
+    // Load cache helpers.  Vectors of plain structs go as a count and
+    // one block, in host order.
+    template <class T>
+    void writeRawVector(Stream& stream, const Vector<T>& vec)
+    {
+        stream.write(U32(vec.size()));
+        stream.write(vec.size() * sizeof(T), vec.address());
+    }
+
+    /// Reads the number of items in a cache section, which has to fit in
+    /// what's left of the stream at itemSize bytes each.  A cache cut short
+    /// then fails here rather than allocating for a garbage count.
+    bool readCacheCount(Stream& stream, U32& count, U32 itemSize)
+    {
+        return stream.read(&count) && U64(count) * itemSize <= stream.getStreamSize() - stream.getPosition();
+    }
+
+    template <class T>
+    bool readRawVector(Stream& stream, Vector<T>& vec)
+    {
+        U32 size;
+        if (!readCacheCount(stream, size, sizeof(T)))
+            return false;
+        vec.setSize(size);
+        return stream.read(size * sizeof(T), vec.address());
+    }
+
+} // namespace {}
+
 //------------------------------------------------------------------------------
 //-------------------------------------- PERSISTENCE IMPLEMENTATION
 //
@@ -845,10 +876,249 @@ bool Interior::read(Stream& stream)
     setupZonePlanes();
     truncateZoneTree();
     buildSurfaceZones();
+    buildCollisionTree();
 
     return(stream.getStatus() == Stream::Ok);
 }
 
+//------------------------------------------------------------------------------
+U32 Interior::getCacheLayout()
+{
+    // A new file version or changes to any of the structs written raw make
+    // old caches unreadable.  The raw blocks are in host byte order, so a
+    // cache made on a machine of the other endianness is too.
+    const U32 byteOrder = 1;
+    U32 layout = smFileVersion;
+    layout = layout * 31 + *(const U8*)&byteOrder;
+    layout = layout * 31 + sizeof(void*);
+    layout = layout * 31 + sizeof(ItrPaddedPoint);
+    layout = layout * 31 + sizeof(IBSPNode);
+    layout = layout * 31 + sizeof(IBSPLeafSolid);
+    layout = layout * 31 + sizeof(Zone);
+    layout = layout * 31 + sizeof(Portal);
+    layout = layout * 31 + sizeof(Surface);
+    layout = layout * 31 + sizeof(NullSurface);
+    layout = layout * 31 + sizeof(Edge);
+    layout = layout * 31 + sizeof(TriFan);
+    layout = layout * 31 + sizeof(TexGenPlanes);
+    layout = layout * 31 + sizeof(TexMatrix);
+    layout = layout * 31 + sizeof(AnimatedLight);
+    layout = layout * 31 + sizeof(LightState);
+    layout = layout * 31 + sizeof(LightStateData);
+    layout = layout * 31 + sizeof(ConvexHull);
+    layout = layout * 31 + sizeof(CoordBin);
+    layout = layout * 31 + sizeof(CollisionNode);
+    layout = layout * 31 + sizeof(CollisionItem);
+    return layout;
+}
+
+bool Interior::writeCache(Stream& stream) const
+{
+    U32 i;
+
+    stream.write(mFileVersion);
+    stream.write(mDetailLevel);
+    stream.write(mMinPixels);
+    mathWrite(stream, mBoundingBox);
+    mathWrite(stream, mBoundingSphere);
+    stream.write(mHasAlarmState);
+    stream.write(mNumLightStateEntries);
+    stream.write(mNumTriggerableLights);
+    stream.write(mLightMapBorderSize);
+    stream.write(mBaseAmbient);
+    stream.write(mAlarmAmbient);
+    stream.write(mCoordBinMode);
+    stream.write(sizeof(mCoordBins), mCoordBins);
+
+    writeRawVector(stream, mPlanes);
+    writeRawVector(stream, mPoints);
+    writeRawVector(stream, mPointVisibility);
+    writeRawVector(stream, mTexGenEQs);
+    writeRawVector(stream, mBSPNodes);
+    writeRawVector(stream, mBSPSolidLeaves);
+    writeRawVector(stream, mWindings);
+    writeRawVector(stream, mWindingIndices);
+    writeRawVector(stream, mEdges);
+    writeRawVector(stream, mZones);
+    writeRawVector(stream, mZoneSurfaces);
+    writeRawVector(stream, mZoneStaticMeshes);
+    writeRawVector(stream, mZonePortalList);
+    writeRawVector(stream, mPortals);
+    writeRawVector(stream, mSurfaces);
+    writeRawVector(stream, mLMTexGenEQs);
+    writeRawVector(stream, mNormals);
+    writeRawVector(stream, mNormalIndices);
+    writeRawVector(stream, mTexMatrices);
+    writeRawVector(stream, mTexMatIndices);
+    writeRawVector(stream, mNormalLMapIndices);
+    writeRawVector(stream, mAlarmLMapIndices);
+    writeRawVector(stream, mNullSurfaces);
+    writeRawVector(stream, mSolidLeafSurfaces);
+    writeRawVector(stream, mAnimatedLights);
+    writeRawVector(stream, mLightStates);
+    writeRawVector(stream, mStateData);
+    writeRawVector(stream, mStateDataBuffer);
+    writeRawVector(stream, mNameBuffer);
+    writeRawVector(stream, mConvexHulls);
+    writeRawVector(stream, mConvexHullEmitStrings);
+    writeRawVector(stream, mHullIndices);
+    writeRawVector(stream, mHullPlaneIndices);
+    writeRawVector(stream, mHullEmitStringIndices);
+    writeRawVector(stream, mHullSurfaceIndices);
+    writeRawVector(stream, mPolyListPlanes);
+    writeRawVector(stream, mPolyListPoints);
+    writeRawVector(stream, mPolyListStrings);
+    writeRawVector(stream, mCoordBinIndices);
+
+    // What setupZonePlanes, truncateZoneTree (in mBSPNodes), buildSurfaceZones
+    // and buildCollisionTree worked out
+    writeRawVector(stream, mZonePlanes);
+    writeRawVector(stream, surfaceZones);
+    writeRawVector(stream, mCollisionNodes);
+    writeRawVector(stream, mCollisionItems);
+    writeRawVector(stream, mCollisionFans);
+
+    mMaterialList->write(stream);
+
+    // Lightmaps unpacked, so they don't go through the PNG decoder again
+    stream.write(mLightmaps.size());
+    for (i = 0; i < mLightmaps.size(); i++)
+    {
+        mLightmaps[i]->write(stream);
+        mLightDirMaps[i]->write(stream);
+    }
+    writeRawVector(stream, mLightmapKeep);
+
+    stream.write(mSubObjects.size());
+    for (i = 0; i < mSubObjects.size(); i++)
+        mSubObjects[i]->writeISO(stream);
+
+    stream.write(mStaticMeshes.size());
+    for (i = 0; i < mStaticMeshes.size(); i++)
+        mStaticMeshes[i]->write(stream);
+
+    return stream.getStatus() == Stream::Ok;
+}
+
+bool Interior::readCache(Stream& stream)
+{
+    U32 i, vectorSize;
+
+    stream.read(&mFileVersion);
+    stream.read(&mDetailLevel);
+    stream.read(&mMinPixels);
+    mathRead(stream, &mBoundingBox);
+    mathRead(stream, &mBoundingSphere);
+    stream.read(&mHasAlarmState);
+    stream.read(&mNumLightStateEntries);
+    stream.read(&mNumTriggerableLights);
+    stream.read(&mLightMapBorderSize);
+    stream.read(&mBaseAmbient);
+    stream.read(&mAlarmAmbient);
+    stream.read(&mCoordBinMode);
+    stream.read(sizeof(mCoordBins), mCoordBins);
+
+    if (!readRawVector(stream, mPlanes) ||
+        !readRawVector(stream, mPoints) ||
+        !readRawVector(stream, mPointVisibility) ||
+        !readRawVector(stream, mTexGenEQs) ||
+        !readRawVector(stream, mBSPNodes) ||
+        !readRawVector(stream, mBSPSolidLeaves) ||
+        !readRawVector(stream, mWindings) ||
+        !readRawVector(stream, mWindingIndices) ||
+        !readRawVector(stream, mEdges) ||
+        !readRawVector(stream, mZones) ||
+        !readRawVector(stream, mZoneSurfaces) ||
+        !readRawVector(stream, mZoneStaticMeshes) ||
+        !readRawVector(stream, mZonePortalList) ||
+        !readRawVector(stream, mPortals) ||
+        !readRawVector(stream, mSurfaces) ||
+        !readRawVector(stream, mLMTexGenEQs) ||
+        !readRawVector(stream, mNormals) ||
+        !readRawVector(stream, mNormalIndices) ||
+        !readRawVector(stream, mTexMatrices) ||
+        !readRawVector(stream, mTexMatIndices) ||
+        !readRawVector(stream, mNormalLMapIndices) ||
+        !readRawVector(stream, mAlarmLMapIndices) ||
+        !readRawVector(stream, mNullSurfaces) ||
+        !readRawVector(stream, mSolidLeafSurfaces) ||
+        !readRawVector(stream, mAnimatedLights) ||
+        !readRawVector(stream, mLightStates) ||
+        !readRawVector(stream, mStateData) ||
+        !readRawVector(stream, mStateDataBuffer) ||
+        !readRawVector(stream, mNameBuffer) ||
+        !readRawVector(stream, mConvexHulls) ||
+        !readRawVector(stream, mConvexHullEmitStrings) ||
+        !readRawVector(stream, mHullIndices) ||
+        !readRawVector(stream, mHullPlaneIndices) ||
+        !readRawVector(stream, mHullEmitStringIndices) ||
+        !readRawVector(stream, mHullSurfaceIndices) ||
+        !readRawVector(stream, mPolyListPlanes) ||
+        !readRawVector(stream, mPolyListPoints) ||
+        !readRawVector(stream, mPolyListStrings) ||
+        !readRawVector(stream, mCoordBinIndices) ||
+        !readRawVector(stream, mZonePlanes) ||
+        !readRawVector(stream, surfaceZones) ||
+        !readRawVector(stream, mCollisionNodes) ||
+        !readRawVector(stream, mCollisionItems) ||
+        !readRawVector(stream, mCollisionFans))
+        return false;
+
+    if (mMaterialList != NULL)
+        delete mMaterialList;
+    mMaterialList = new MaterialList;
+    mMaterialList->read(stream);
+
+    // Each item below starts with at least a U32
+    if (!readCacheCount(stream, vectorSize, sizeof(U32)))
+        return false;
+    mLightmaps.setSize(vectorSize);
+    mLightDirMaps.setSize(vectorSize);
+    for (i = 0; i < mLightmaps.size(); i++)
+        mLightmaps[i] = mLightDirMaps[i] = NULL;
+    for (i = 0; i < mLightmaps.size(); i++)
+    {
+        mLightmaps[i] = new GBitmap;
+        mLightDirMaps[i] = new GBitmap;
+        if (!mLightmaps[i]->read(stream) || !mLightDirMaps[i]->read(stream))
+            return false;
+    }
+    if (!readRawVector(stream, mLightmapKeep))
+        return false;
+
+    if (GFXDevice::devicePresent())
+    {
+        for (i = 0; i < mLightDirMaps.size(); i++)
+            mLightDirMapsTex.push_back(GFXTexHandle(mLightDirMaps[i], &GFXDefaultPersistentProfile, false));
+    }
+
+    if (!readCacheCount(stream, vectorSize, sizeof(U32)))
+        return false;
+    mSubObjects.setSize(vectorSize);
+    for (i = 0; i < mSubObjects.size(); i++)
+        mSubObjects[i] = NULL;
+    for (i = 0; i < mSubObjects.size(); i++)
+    {
+        mSubObjects[i] = InteriorSubObject::readISO(stream);
+        if (mSubObjects[i] == NULL)
+            return false;
+    }
+
+    if (!readCacheCount(stream, vectorSize, sizeof(U32)))
+        return false;
+    mStaticMeshes.setSize(vectorSize);
+    for (i = 0; i < mStaticMeshes.size(); i++)
+        mStaticMeshes[i] = NULL;
+    for (i = 0; i < mStaticMeshes.size(); i++)
+    {
+        mStaticMeshes[i] = new InteriorSimpleMesh;
+        if (!mStaticMeshes[i]->read(stream))
+            return false;
+    }
+
+    return stream.getStatus() == Stream::Ok;
+}
+
 bool Interior::write(Stream& stream) const
 {
     AssertFatal(stream.hasCapability(Stream::StreamWrite), "Interior::write: non-write capable stream passed");
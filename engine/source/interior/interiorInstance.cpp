@@ -286,6 +286,8 @@ void InteriorInstance::consoleInit()
     Con::addVariable("pref::Interior::VertexLighting", TypeBool, &Interior::smUseVertexLighting);
     Con::addVariable("pref::Interior::TexturedFog", TypeBool, &Interior::smUseTexturedFog);
     Con::addVariable("pref::Interior::lockArrays", TypeBool, &Interior::smLockArrays);
+    Con::addVariable("Interior::useCollisionTree", TypeBool, &Interior::smUseCollisionTree);
+    Con::addVariable("pref::Interior::useCache", TypeBool, &InteriorResource::smUseCache);
 
     Con::addVariable("pref::Interior::detailAdjust", TypeF32, &InteriorInstance::smDetailModification);
 
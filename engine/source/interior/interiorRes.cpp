@@ -5,6 +5,7 @@
 
 #include "console/console.h"
 #include "core/stream.h"
+#include "core/fileStream.h"
 #include "interior/interior.h"
 #include "interior/interiorResObjects.h"
 #include "gfx/gBitmap.h"
@@ -13,6 +14,26 @@
 #include "interior/interiorRes.h"
 
 const U32 InteriorResource::smFileVersion = 44;
+bool InteriorResource::smUseCache = true;
+
+namespace {
+    const U32 sgCacheMagic = makeFourCCTag('D', 'I', 'C', 'H');
+    const U32 sgCacheVersion = 1;
+
+    /// Reads the number of items in a section.  A .dif is trusted as it
+    /// always was, but a cache can be cut short, so there the count has to
+    /// be read and fit in what's left of the stream (every item takes at
+    /// least a byte).
+    bool readCount(Stream& stream, U32* count, bool cached)
+    {
+        *count = 0;
+        if (!stream.read(count))
+            return !cached;
+        return !cached || *count <= stream.getStreamSize() - stream.getPosition();
+    }
+}
+
+extern ResourceObject* curResourceObj;
 
 //--------------------------------------------------------------------------
 InteriorResource::InteriorResource()
@@ -49,7 +70,7 @@ InteriorResource::~InteriorResource()
     mPreviewBitmap = NULL;
 }
 
-bool InteriorResource::read(Stream& stream)
+bool InteriorResource::read(Stream& stream, bool cached)
 {
     AssertFatal(stream.hasCapability(Stream::StreamRead), "Interior::read: non-read capable stream passed");
     AssertFatal(stream.getStatus() == Stream::Ok, "Interior::read: Error, stream in inconsistent state");
@@ -74,14 +95,15 @@ bool InteriorResource::read(Stream& stream)
 
     // Details
     U32 numDetailLevels;
-    stream.read(&numDetailLevels);
+    if (!readCount(stream, &numDetailLevels, cached))
+        return false;
     mDetailLevels.setSize(numDetailLevels);
     for (i = 0; i < mDetailLevels.size(); i++)
         mDetailLevels[i] = NULL;
 
     for (i = 0; i < mDetailLevels.size(); i++) {
         mDetailLevels[i] = new Interior;
-        if (mDetailLevels[i]->read(stream) == false) {
+        if ((cached ? mDetailLevels[i]->readCache(stream) : mDetailLevels[i]->read(stream)) == false) {
             Con::errorf(ConsoleLogEntry::General, "Unable to read detail level %d in interior resource", i);
             return false;
         }
@@ -89,22 +111,25 @@ bool InteriorResource::read(Stream& stream)
 
     // Subobjects: mirrors, translucencies
     U32 numSubObjects;
-    stream.read(&numSubObjects);
+    if (!readCount(stream, &numSubObjects, cached))
+        return false;
     mSubObjects.setSize(numSubObjects);
     for (i = 0; i < mSubObjects.size(); i++)
         mSubObjects[i] = NULL;
 
     for (i = 0; i < mSubObjects.size(); i++) {
         mSubObjects[i] = new Interior;
-        if (mSubObjects[i]->read(stream) == false) {
-            AssertISV(false, avar("Unable to read subobject %d in interior resource", i));
+        if ((cached ? mSubObjects[i]->readCache(stream) : mSubObjects[i]->read(stream)) == false) {
+            if (!cached)
+                AssertISV(false, avar("Unable to read subobject %d in interior resource", i));
             return false;
         }
     }
 
     // Triggers
     U32 numTriggers;
-    stream.read(&numTriggers);
+    if (!readCount(stream, &numTriggers, cached))
+        return false;
     mTriggers.setSize(numTriggers);
     for (i = 0; i < mTriggers.size(); i++)
         mTriggers[i] = NULL;
@@ -112,13 +137,15 @@ bool InteriorResource::read(Stream& stream)
     for (i = 0; i < mTriggers.size(); i++) {
         mTriggers[i] = new InteriorResTrigger;
         if (mTriggers[i]->read(stream) == false) {
-            AssertISV(false, avar("Unable to read trigger %d in interior resource", i));
+            if (!cached)
+                AssertISV(false, avar("Unable to read trigger %d in interior resource", i));
             return false;
         }
     }
 
     U32 numChildren;
-    stream.read(&numChildren);
+    if (!readCount(stream, &numChildren, cached))
+        return false;
     mInteriorPathFollowers.setSize(numChildren);
     for (i = 0; i < mInteriorPathFollowers.size(); i++)
         mInteriorPathFollowers[i] = NULL;
@@ -126,13 +153,15 @@ bool InteriorResource::read(Stream& stream)
     for (i = 0; i < mInteriorPathFollowers.size(); i++) {
         mInteriorPathFollowers[i] = new InteriorPathFollower;
         if (mInteriorPathFollowers[i]->read(stream) == false) {
-            AssertISV(false, avar("Unable to read child %d in interior resource", i));
+            if (!cached)
+                AssertISV(false, avar("Unable to read child %d in interior resource", i));
             return false;
         }
     }
 
     U32 numFields;
-    stream.read(&numFields);
+    if (!readCount(stream, &numFields, cached))
+        return false;
     mForceFields.setSize(numFields);
     for (i = 0; i < mForceFields.size(); i++)
         mForceFields[i] = NULL;
@@ -140,13 +169,15 @@ bool InteriorResource::read(Stream& stream)
     for (i = 0; i < mForceFields.size(); i++) {
         mForceFields[i] = new ForceField;
         if (mForceFields[i]->read(stream) == false) {
-            AssertISV(false, avar("Unable to read field %d in interior resource", i));
+            if (!cached)
+                AssertISV(false, avar("Unable to read field %d in interior resource", i));
             return false;
         }
     }
 
     U32 numSpecNodes;
-    stream.read(&numSpecNodes);
+    if (!readCount(stream, &numSpecNodes, cached))
+        return false;
     mAISpecialNodes.setSize(numSpecNodes);
     for (i = 0; i < mAISpecialNodes.size(); i++)
         mAISpecialNodes[i] = NULL;
@@ -154,7 +185,8 @@ bool InteriorResource::read(Stream& stream)
     for (i = 0; i < mAISpecialNodes.size(); i++) {
         mAISpecialNodes[i] = new AISpecialNode;
         if (mAISpecialNodes[i]->read(stream) == false) {
-            AssertISV(false, avar("Unable to read SpecNode %d in interior resource", i));
+            if (!cached)
+                AssertISV(false, avar("Unable to read SpecNode %d in interior resource", i));
             return false;
         }
     }
@@ -172,14 +204,16 @@ bool InteriorResource::read(Stream& stream)
     if (dummyInt == 2)
     {
         U32 numGameEnts;
-        stream.read(&numGameEnts);
+        if (!readCount(stream, &numGameEnts, cached))
+            return false;
         mGameEntities.setSize(numGameEnts);
         for (i = 0; i < numGameEnts; i++)
             mGameEntities[i] = new ItrGameEntity;
 
         for (i = 0; i < numGameEnts; i++) {
             if (mGameEntities[i]->read(stream) == false) {
-                AssertISV(false, avar("Unable to read SpecNode %d in interior resource", i));
+                if (!cached)
+                    AssertISV(false, avar("Unable to read SpecNode %d in interior resource", i));
                 return false;
             }
         }
@@ -189,7 +223,7 @@ bool InteriorResource::read(Stream& stream)
     return (stream.getStatus() == Stream::Ok);
 }
 
-bool InteriorResource::write(Stream& stream) const
+bool InteriorResource::write(Stream& stream, bool cached) const
 {
     AssertFatal(stream.hasCapability(Stream::StreamWrite), "Interior::write: non-write capable stream passed");
     AssertFatal(stream.getStatus() == Stream::Ok, "Interior::write: Error, stream in inconsistent state");
@@ -199,7 +233,7 @@ bool InteriorResource::write(Stream& stream) const
 
     // Handle preview
     //
-    if (mPreviewBitmap != NULL) {
+    if (mPreviewBitmap != NULL && !cached) {
         stream.write(bool(true));
         mPreviewBitmap->writePNG(stream);
     }
@@ -211,16 +245,20 @@ bool InteriorResource::write(Stream& stream) const
     stream.write(mDetailLevels.size());
     U32 i;
     for (i = 0; i < mDetailLevels.size(); i++) {
-        if (mDetailLevels[i]->write(stream) == false) {
-            AssertISV(false, "Unable to write detail level to stream");
+        if ((cached ? mDetailLevels[i]->writeCache(stream) : mDetailLevels[i]->write(stream)) == false) {
+            // A cache that can't be written is just skipped
+            if (!cached)
+                AssertISV(false, "Unable to write detail level to stream");
             return false;
         }
     }
 
     stream.write(mSubObjects.size());
     for (i = 0; i < mSubObjects.size(); i++) {
-        if (mSubObjects[i]->write(stream) == false) {
-            AssertISV(false, "Unable to write subobject to stream");
+        if ((cached ? mSubObjects[i]->writeCache(stream) : mSubObjects[i]->write(stream)) == false) {
+            // A cache that can't be written is just skipped
+            if (!cached)
+                AssertISV(false, "Unable to write subobject to stream");
             return false;
         }
     }
@@ -279,6 +317,33 @@ bool InteriorResource::write(Stream& stream) const
     return (stream.getStatus() == Stream::Ok);
 }
 
+//--------------------------------------------------------------------------
+bool InteriorResource::readCache(Stream& stream, U32 sourceCRC)
+{
+    U32 magic, version, crc, layout;
+    stream.read(&magic);
+    stream.read(&version);
+    stream.read(&crc);
+    stream.read(&layout);
+
+    // A cache from another build or for an older .dif is just ignored
+    if (stream.getStatus() != Stream::Ok || magic != sgCacheMagic || version != sgCacheVersion ||
+        crc != sourceCRC || layout != Interior::getCacheLayout())
+        return false;
+
+    return read(stream, true);
+}
+
+bool InteriorResource::writeCache(Stream& stream, U32 sourceCRC) const
+{
+    stream.write(sgCacheMagic);
+    stream.write(sgCacheVersion);
+    stream.write(sourceCRC);
+    stream.write(Interior::getCacheLayout());
+
+    return write(stream, true);
+}
+
 GBitmap* InteriorResource::extractPreview(Stream& stream)
 {
     AssertFatal(stream.hasCapability(Stream::StreamRead), "Interior::read: non-read capable stream passed");
@@ -310,10 +375,67 @@ GBitmap* InteriorResource::extractPreview(Stream& stream)
 //-------------------------------------- Interior Resource constructor
 ResourceInstance* constructInteriorDIF(Stream& stream)
 {
+    // Prefer the load cache next to the .dif, if it was made from this one
+    ResourceObject* obj = curResourceObj;
+    char cacheName[1024];
+    cacheName[0] = '\0';
+    if (obj && obj->path && obj->name)
+    {
+        dSprintf(cacheName, sizeof(cacheName), "%s/%s", obj->path, obj->name);
+        char* ext = dStrrchr(cacheName, '.');
+        if (ext && dStricmp(ext, ".dif") == 0)
+            dStrcpy(ext, ".dic");
+        else
+            cacheName[0] = '\0';
+    }
+
+    if (InteriorResource::smUseCache && cacheName[0])
+    {
+        ResourceObject* cacheObj = ResourceManager->find(cacheName, ResourceObject::File);
+        if (!cacheObj)
+            cacheObj = ResourceManager->find(cacheName, ResourceObject::VolumeBlock);
+
+        Stream* cacheStream = cacheObj ? ResourceManager->openStream(cacheObj) : NULL;
+        if (cacheStream)
+        {
+            InteriorResource* pCached = new InteriorResource;
+            bool ok = pCached->readCache(*cacheStream, obj->crc);
+            ResourceManager->closeStream(cacheStream);
+            if (ok)
+                return pCached;
+            delete pCached;
+        }
+    }
+
     InteriorResource* pResource = new InteriorResource;
 
     if (pResource->read(stream) == true)
+    {
+        // Write a fresh cache for next time.  Read only installs simply
+        // don't get one.
+        if (InteriorResource::smUseCache && cacheName[0])
+        {
+            // Written under another name and moved into place when complete,
+            // so a full disk or an interrupted write never leaves a partial
+            // cache behind.
+            char tempName[1024];
+            dSprintf(tempName, sizeof(tempName), "%s.tmp", cacheName);
+
+            FileStream cacheStream;
+            if (ResourceManager->isValidWriteFileName(tempName) && cacheStream.open(tempName, FileStream::Write))
+            {
+                bool ok = pResource->writeCache(cacheStream, obj->crc) && cacheStream.flush();
+                cacheStream.close();
+
+                if (!ok || !dFileRename(tempName, cacheName))
+                {
+                    Con::warnf("Unable to write interior cache %s", cacheName);
+                    dFileDelete(tempName);
+                }
+            }
+        }
         return pResource;
+    }
     else {
         delete pResource;
         return NULL;
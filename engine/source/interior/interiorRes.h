@@ -40,10 +40,20 @@ public:
     InteriorResource();
     ~InteriorResource();
 
-    bool            read(Stream& stream);
-    bool            write(Stream& stream) const;
+    bool            read(Stream& stream, bool cached = false);
+    bool            write(Stream& stream, bool cached = false) const;
     static GBitmap* extractPreview(Stream&);
 
+    /// The load cache is a .dic file next to the .dif, written the first
+    /// time the .dif is loaded.  It has everything the .dif does bar the
+    /// preview, with the arrays stored as raw blocks, the lightmaps
+    /// unpacked and the zone and collision setup already done.  It's only
+    /// used while its CRC matches the .dif's.
+    bool            readCache(Stream& stream, U32 sourceCRC);
+    bool            writeCache(Stream& stream, U32 sourceCRC) const;
+
+    static bool     smUseCache;
+
     S32       getNumDetailLevels() const;
     S32       getNumSubObjects() const;
     S32       getNumTriggers() const;
@@ -96,6 +96,7 @@ PathedInterior::PathedInterior()
     mPathKey = Path::NoPathIndex;
     mAdvanceTime = 0.0;
     mStopTime = 1000.0;
+    mStepCache.valid = false;
     mSustainHandle = 0;
     mLMHandle = 0xFFFFFFFF;
 
@@ -608,58 +609,90 @@ void PathedInterior::computeNextPathStep(F64 timeDelta)
     {
         mExtrudedBox = getWorldBox();
         mCurrentVelocity.set(0, 0, 0);
+        return;
+    }
+
+    Point3F curPoint;
+    MatrixF mat = getTransform();
+    mat.getColumn(3, &curPoint);
+
+    const Box3F& worldBox = getWorldBox();
+    if (mStepCache.valid &&
+        mStepCache.pathKey == mPathKey &&
+        mStepCache.pathRevision == getPathManager()->getRevision() &&
+        mStepCache.timeDelta == timeDelta &&
+        mStepCache.fromPosition == mCurrentPosition &&
+        mStepCache.targetPos == mTargetPosition &&
+        mStepCache.worldPosition == curPoint &&
+        mStepCache.offset == mOffset &&
+        mStepCache.worldBox.min == worldBox.min &&
+        mStepCache.worldBox.max == worldBox.max)
+    {
+        mCurrentPosition = mStepCache.toPosition;
+        mExtrudedBox = mStepCache.extrudedBox;
+        mCurrentVelocity = mStepCache.velocity;
+        return;
+    }
+
+    mStepCache.valid = true;
+    mStepCache.pathKey = mPathKey;
+    mStepCache.pathRevision = getPathManager()->getRevision();
+    mStepCache.timeDelta = timeDelta;
+    mStepCache.fromPosition = mCurrentPosition;
+    mStepCache.targetPos = mTargetPosition;
+    mStepCache.worldPosition = curPoint;
+    mStepCache.offset = mOffset;
+    mStepCache.worldBox = worldBox;
+
+    F64 delta;
+    if (mTargetPosition < 0)
+    {
+        if (mTargetPosition == -1)
+            delta = timeDelta;
+        else if (mTargetPosition == -2)
+            delta = -timeDelta;
+        mCurrentPosition += delta;
+        U32 totalTime = getPathManager()->getPathTotalTime(mPathKey);
+        while (mCurrentPosition >= totalTime)
+            mCurrentPosition -= totalTime;
+        while (mCurrentPosition < 0)
+            mCurrentPosition += totalTime;
     }
     else
     {
-        F64 delta;
-        if (mTargetPosition < 0)
-        {
-            if (mTargetPosition == -1)
-                delta = timeDelta;
-            else if (mTargetPosition == -2)
-                delta = -timeDelta;
-            mCurrentPosition += delta;
-            U32 totalTime = getPathManager()->getPathTotalTime(mPathKey);
-            while (mCurrentPosition >= totalTime)
-                mCurrentPosition -= totalTime;
-            while (mCurrentPosition < 0)
-                mCurrentPosition += totalTime;
-        }
-        else
-        {
-            delta = mTargetPosition - mCurrentPosition;
-            if (delta < -timeDelta)
-                delta = -timeDelta;
-            else if (delta > timeDelta)
-                delta = timeDelta;
-            mCurrentPosition += delta;
-        }
+        delta = mTargetPosition - mCurrentPosition;
+        if (delta < -timeDelta)
+            delta = -timeDelta;
+        else if (delta > timeDelta)
+            delta = timeDelta;
+        mCurrentPosition += delta;
+    }
 
-        Point3F curPoint;
-        Point3F newPoint(0.0, 0.0, 0.0);
-        MatrixF mat = getTransform();
-        mat.getColumn(3, &curPoint);
-        getPathManager()->getPathPosition(mPathKey, mCurrentPosition, newPoint);
-        newPoint += mOffset;
+    Point3F newPoint(0.0, 0.0, 0.0);
+    getPathManager()->getPathPosition(mPathKey, mCurrentPosition, newPoint);
+    newPoint += mOffset;
 
-        Point3F displaceDelta = newPoint - curPoint;
-        mExtrudedBox = getWorldBox();
+    Point3F displaceDelta = newPoint - curPoint;
+    mExtrudedBox = worldBox;
 
-        if (displaceDelta.x < 0)
-            mExtrudedBox.min.x += displaceDelta.x;
-        else
-            mExtrudedBox.max.x += displaceDelta.x;
-        if (displaceDelta.y < 0)
-            mExtrudedBox.min.y += displaceDelta.y;
-        else
-            mExtrudedBox.max.y += displaceDelta.y;
-        if (displaceDelta.z < 0)
-            mExtrudedBox.min.z += displaceDelta.z;
-        else
-            mExtrudedBox.max.z += displaceDelta.z;
+    if (displaceDelta.x < 0)
+        mExtrudedBox.min.x += displaceDelta.x;
+    else
+        mExtrudedBox.max.x += displaceDelta.x;
+    if (displaceDelta.y < 0)
+        mExtrudedBox.min.y += displaceDelta.y;
+    else
+        mExtrudedBox.max.y += displaceDelta.y;
+    if (displaceDelta.z < 0)
+        mExtrudedBox.min.z += displaceDelta.z;
+    else
+        mExtrudedBox.max.z += displaceDelta.z;
 
-        mCurrentVelocity = displaceDelta * 1000 / F32(timeDelta);
-    }
+    mCurrentVelocity = displaceDelta * 1000 / F32(timeDelta);
+
+    mStepCache.toPosition = mCurrentPosition;
+    mStepCache.extrudedBox = mExtrudedBox;
+    mStepCache.velocity = mCurrentVelocity;
 }
 
 Point3F PathedInterior::getVelocity() const
@@ -71,6 +71,27 @@ public:
         F64 stopTime;
     };
 
+    /// The inputs and result of the last computeNextPathStep.  The step is
+    /// worked out by the platform's own tick and again by every marble
+    /// near it, nearly always from the same state, so the repeats are
+    /// answered from here.
+    struct StepCache
+    {
+        bool valid;
+        U32 pathKey;
+        U32 pathRevision;
+        F64 timeDelta;
+        F64 fromPosition;
+        S32 targetPos;
+        Point3F worldPosition;
+        Point3F offset;
+        Box3F worldBox;
+
+        F64 toPosition;
+        Box3F extrudedBox;
+        Point3F velocity;
+    };
+
 private:
 
     U32 getPathKey();                            // only used on the server
@@ -78,6 +99,7 @@ private:
     // Persist fields
 protected:
     PathedInterior::TickState mSavedState;
+    PathedInterior::StepCache mStepCache;
     StringTableEntry         mName;
     S32                      mPathIndex;
     Vector<StringTableEntry> mTriggers;
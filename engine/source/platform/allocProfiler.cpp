@@ -0,0 +1,307 @@
+//-----------------------------------------------------------------------------
+// Torque Game Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#include "platform/allocProfiler.h"
+
+#ifdef TORQUE_ALLOC_PROFILER
+
+#include "platform/profiler.h"
+#include "platform/platformSpinLock.h"
+#include "console/console.h"
+
+bool AllocProfiler::smEnabled = false;
+
+namespace {
+    struct Entry
+    {
+        const char* fileName;
+        U32 line;
+        ProfilerRootData* zone;
+        U64 bytes;
+        U64 count;
+    };
+
+    /// Open addressed on file, line and zone.  Made on first enable with
+    /// dRealMalloc, so it never goes through the allocators being watched.
+    Entry* sgTable = NULL;
+    U32 sgUsed = 0;
+    Entry sgOverflow;
+
+    U32 sgFrames = 0;
+    U64 sgFrameBytes = 0;
+    U64 sgFrameCount = 0;
+    U64 sgLastFrameBytes = 0;
+    U64 sgLastFrameCount = 0;
+    U64 sgPeakFrameBytes = 0;
+
+    SpinLock sgLock;
+
+    inline U32 hashKey(const char* fileName, U32 line, ProfilerRootData* zone)
+    {
+        U64 h = U64(dsize_t(fileName)) * 0x9E3779B97F4A7C15ULL;
+        h ^= U64(dsize_t(zone)) * 0xC2B2AE3D27D4EB4FULL;
+        h ^= line * 0x165667B19E3779F9ULL;
+        return U32(h ^ (h >> 32));
+    }
+
+    void clearCounts()
+    {
+        if (sgTable)
+            dMemset(sgTable, 0, sizeof(Entry) * AllocProfiler::TableSize);
+        dMemset(&sgOverflow, 0, sizeof(sgOverflow));
+        sgOverflow.fileName = "(table full)";
+        sgUsed = 0;
+
+        sgFrames = 0;
+        sgFrameBytes = sgFrameCount = 0;
+        sgLastFrameBytes = sgLastFrameCount = 0;
+        sgPeakFrameBytes = 0;
+    }
+
+    /// Path names from __FILE__ can be long, the last part is plenty.
+    const char* shortFileName(const char* fileName)
+    {
+        if (!fileName)
+            return "(unknown)";
+
+        const char* name = fileName;
+        for (const char* walk = fileName; *walk; walk++)
+            if (*walk == '/' || *walk == '\\')
+                name = walk + 1;
+        return name;
+    }
+
+    S32 QSORT_CALLBACK siteCompare(const void* a, const void* b)
+    {
+        const Entry* e1 = (const Entry*)a;
+        const Entry* e2 = (const Entry*)b;
+        if (e1->line != e2->line)
+            return e1->line < e2->line ? -1 : 1;
+        if (e1->fileName == e2->fileName)
+            return 0;
+        if (!e1->fileName || !e2->fileName)
+            return e1->fileName ? 1 : -1;
+        return dStrcmp(e1->fileName, e2->fileName);
+    }
+
+    S32 QSORT_CALLBACK zoneCompare(const void* a, const void* b)
+    {
+        const Entry* e1 = (const Entry*)a;
+        const Entry* e2 = (const Entry*)b;
+        if (e1->zone == e2->zone)
+            return 0;
+        return dsize_t(e1->zone) < dsize_t(e2->zone) ? -1 : 1;
+    }
+
+    S32 QSORT_CALLBACK bytesCompare(const void* a, const void* b)
+    {
+        const Entry* e1 = (const Entry*)a;
+        const Entry* e2 = (const Entry*)b;
+        if (e1->bytes != e2->bytes)
+            return e1->bytes > e2->bytes ? -1 : 1;
+        return e1->count > e2->count ? -1 : (e1->count < e2->count ? 1 : 0);
+    }
+
+    /// Sort on the key and fold entries with equal keys together.  Returns
+    /// the number of entries left, sorted busiest first.
+    U32 mergeEntries(Entry* entries, U32 count, S32(QSORT_CALLBACK* keyCompare)(const void*, const void*))
+    {
+        if (!count)
+            return 0;
+
+        dQsort(entries, count, sizeof(Entry), keyCompare);
+
+        U32 out = 0;
+        for (U32 i = 1; i < count; i++)
+        {
+            if (keyCompare(&entries[out], &entries[i]) == 0)
+            {
+                entries[out].bytes += entries[i].bytes;
+                entries[out].count += entries[i].count;
+            }
+            else
+                entries[++out] = entries[i];
+        }
+        out++;
+
+        dQsort(entries, out, sizeof(Entry), bytesCompare);
+        return out;
+    }
+
+} // namespace {}
+
+//--------------------------------------
+void AllocProfiler::enable(bool enabled)
+{
+    SpinLockHandle handle(sgLock);
+
+    if (enabled && !sgTable)
+    {
+        sgTable = (Entry*)dRealMalloc(sizeof(Entry) * TableSize);
+        clearCounts();
+    }
+    smEnabled = enabled;
+}
+
+void AllocProfiler::reset()
+{
+    SpinLockHandle handle(sgLock);
+    clearCounts();
+}
+
+void AllocProfiler::record(dsize_t size, const char* fileName, U32 line)
+{
+    // Asking the profiler is safe from any thread, only the main thread
+    // gets a zone back.
+    ProfilerRootData* zone = gProfiler ? gProfiler->getCurrentZone() : NULL;
+    U32 index = hashKey(fileName, line, zone) & (TableSize - 1);
+
+    SpinLockHandle handle(sgLock);
+    if (!sgTable)
+        return;
+
+    sgFrameBytes += size;
+    sgFrameCount++;
+
+    // Keep the table no more than three quarters full so probes stay short.
+    Entry* entry = &sgOverflow;
+    for (;;)
+    {
+        Entry& walk = sgTable[index];
+        if (walk.fileName == fileName && walk.line == line && walk.zone == zone && walk.count)
+        {
+            entry = &walk;
+            break;
+        }
+        if (!walk.count)
+        {
+            if (sgUsed < TableSize / 4 * 3)
+            {
+                walk.fileName = fileName;
+                walk.line = line;
+                walk.zone = zone;
+                sgUsed++;
+                entry = &walk;
+            }
+            break;
+        }
+        index = (index + 1) & (TableSize - 1);
+    }
+
+    entry->bytes += size;
+    entry->count++;
+}
+
+void AllocProfiler::endFrame()
+{
+    if (!smEnabled)
+        return;
+
+    SpinLockHandle handle(sgLock);
+    sgFrames++;
+    sgLastFrameBytes = sgFrameBytes;
+    sgLastFrameCount = sgFrameCount;
+    if (sgFrameBytes > sgPeakFrameBytes)
+        sgPeakFrameBytes = sgFrameBytes;
+    sgFrameBytes = sgFrameCount = 0;
+}
+
+void AllocProfiler::dump(U32 count)
+{
+    // Copy the counts out and let go of the lock before printing, since the
+    // console allocates too.
+    Entry* sites = NULL;
+    U32 numSites = 0;
+    U32 frames;
+    U64 lastBytes, lastCount, peakBytes;
+    {
+        SpinLockHandle handle(sgLock);
+        if (sgTable)
+        {
+            sites = (Entry*)dRealMalloc(sizeof(Entry) * (sgUsed + 1));
+            for (U32 i = 0; i < TableSize; i++)
+                if (sgTable[i].count)
+                    sites[numSites++] = sgTable[i];
+            if (sgOverflow.count)
+                sites[numSites++] = sgOverflow;
+        }
+        frames = sgFrames;
+        lastBytes = sgLastFrameBytes;
+        lastCount = sgLastFrameCount;
+        peakBytes = sgPeakFrameBytes;
+    }
+
+    if (!sites)
+    {
+        Con::printf("Allocation profiler has not been enabled.");
+        return;
+    }
+
+    U64 totalBytes = 0, totalCount = 0;
+    for (U32 i = 0; i < numSites; i++)
+    {
+        totalBytes += sites[i].bytes;
+        totalCount += sites[i].count;
+    }
+
+    // Rates are over the whole frames counted, and at least one frame so a
+    // dump straight after enabling still shows something.
+    F64 perFrame = 1.0 / (frames ? frames : 1);
+
+    Con::printf("Allocation profile over %d frames%s:", frames, smEnabled ? "" : " (disabled)");
+    Con::printf("   %.1f KB and %.1f allocs per frame, last frame %.1f KB and %d allocs, peak frame %.1f KB",
+        F64(totalBytes) * perFrame / 1024.0, F64(totalCount) * perFrame,
+        F64(lastBytes) / 1024.0, U32(lastCount), F64(peakBytes) / 1024.0);
+
+    Entry* zones = (Entry*)dRealMalloc(sizeof(Entry) * (numSites ? numSites : 1));
+    dMemcpy(zones, sites, sizeof(Entry) * numSites);
+
+    U32 numZones = mergeEntries(zones, numSites, zoneCompare);
+    numSites = mergeEntries(sites, numSites, siteCompare);
+
+    Con::printf("   By call site:");
+    Con::printf("   %12s %12s %8s  %s", "KB/frame", "allocs/frame", "bytes/op", "site");
+    for (U32 i = 0; i < numSites && i < count; i++)
+    {
+        const Entry& e = sites[i];
+        Con::printf("   %12.2f %12.2f %8d  %s(%d)", F64(e.bytes) * perFrame / 1024.0,
+            F64(e.count) * perFrame, U32(e.bytes / e.count), shortFileName(e.fileName), e.line);
+    }
+
+    Con::printf("   By profiler zone:");
+    Con::printf("   %12s %12s %8s  %s", "KB/frame", "allocs/frame", "bytes/op", "zone");
+    for (U32 i = 0; i < numZones && i < count; i++)
+    {
+        const Entry& e = zones[i];
+        Con::printf("   %12.2f %12.2f %8d  %s", F64(e.bytes) * perFrame / 1024.0,
+            F64(e.count) * perFrame, U32(e.bytes / e.count), e.zone ? e.zone->mName : "(no zone)");
+    }
+
+    dRealFree(zones);
+    dRealFree(sites);
+}
+
+//--------------------------------------
+ConsoleFunction(allocProfilerEnable, void, 2, 2, "(bool enable)"
+    "Start or stop counting allocations by call site and profiler zone.")
+{
+    argc;
+    AllocProfiler::enable(dAtob(argv[1]));
+}
+
+ConsoleFunction(allocProfilerReset, void, 1, 1, "()"
+    "Clear the allocation profiler's counts.")
+{
+    argc, argv;
+    AllocProfiler::reset();
+}
+
+ConsoleFunction(allocProfilerDump, void, 1, 2, "(int count = 20)"
+    "Print the call sites and profiler zones which allocate the most, per frame.")
+{
+    AllocProfiler::dump(argc > 1 ? dAtoi(argv[1]) : 20);
+}
+
+#endif // TORQUE_ALLOC_PROFILER
@@ -0,0 +1,74 @@
+//-----------------------------------------------------------------------------
+// Torque Game Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#ifndef _ALLOCPROFILER_H_
+#define _ALLOCPROFILER_H_
+
+#ifndef _PLATFORM_H_
+#include "platform/platform.h"
+#endif
+
+#ifdef TORQUE_ALLOC_PROFILER
+
+/// Counts heap allocations against the call site that made them and the
+/// profiler zone they were made in.  See TORQUE_ALLOC_PROFILER in
+/// torqueConfig.h.
+///
+/// The memory functions call track() for every allocation.  It does nothing
+/// until the profiler is turned on, then every allocation is counted in a
+/// table keyed on file, line and the innermost PROFILE_START zone of the
+/// main thread.  Allocations from other threads are counted under their
+/// call site with no zone.  dRealloc isn't given a call site, so growing
+/// Vectors and the like show up as "dRealloc" under the zone they grew in.
+///
+/// A frame ends whenever the outermost profiler zone is popped, which is
+/// once per pass of the main loop, so the report can give the rates per
+/// frame.  From script:
+/// @code
+/// allocProfilerEnable(true);   // start counting
+/// allocProfilerDump(20);       // print the 20 busiest call sites and zones
+/// allocProfilerReset();        // clear the counts and the frame count
+/// @endcode
+///
+/// The table lives outside the allocators it watches, so counting never
+/// allocates.
+class AllocProfiler
+{
+public:
+    enum Constants
+    {
+        /// Distinct file, line and zone combinations which can be counted.
+        /// Anything past this is lumped into one overflow entry.
+        TableSize = 8192,
+    };
+
+    /// Count an allocation, if the profiler is on.
+    static inline void track(dsize_t size, const char* fileName, U32 line)
+    {
+        if (smEnabled)
+            record(size, fileName, line);
+    }
+
+    static void enable(bool enabled);
+    static bool isEnabled() { return smEnabled; }
+
+    /// Called by the profiler at the end of every main loop pass.
+    static void endFrame();
+
+    /// Clear all the counts.
+    static void reset();
+
+    /// Print the busiest call sites and zones.
+    static void dump(U32 count);
+
+private:
+    static bool smEnabled;
+
+    static void record(dsize_t size, const char* fileName, U32 line);
+};
+
+#endif // TORQUE_ALLOC_PROFILER
+
+#endif // _ALLOCPROFILER_H_
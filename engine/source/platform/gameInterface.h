@@ -30,6 +30,11 @@ public:
     virtual void refreshWindow();
 
     virtual void postEvent(Event& event);
+
+    /// How long the platform can block waiting for input before the game
+    /// has work due, in milliseconds of game time.  0 means don't block, -1
+    /// means nothing is due at all.  Used by idle dedicated servers.
+    virtual S32 getIdleTimeout();
     /// @}
 
     /// @name Event Handlers
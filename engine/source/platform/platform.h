@@ -375,6 +375,9 @@ public:
     static U32  getTime();
     static U32  getVirtualMilliseconds();
     static U32  getRealMilliseconds();
+    /// Microseconds on a clock which only ever goes forward, from some
+    /// unspecified start.  Use it for measuring, not for the time of day.
+    static U64  getRealMicroseconds();
     static void advanceTime(U32 delta);
 
     static S32 getBackgroundSleepTime();
@@ -713,6 +716,7 @@ enum DFILE_STATUS
 };
 
 extern bool dFileDelete(const char* name);
+extern bool dFileRename(const char* oldName, const char* newName);   ///< Replaces newName if it exists.
 extern bool dFileTouch(const char* name);
 
 extern FILE_HANDLE dOpenFileRead(const char* name, DFILE_STATUS& error);
@@ -8,7 +8,14 @@
 #include "console/console.h"
 #include "platform/profiler.h"
 #include "platform/platformMutex.h"
+#include "platform/sizeClassAllocator.h"
+#include "platform/allocProfiler.h"
 
+#ifdef TORQUE_ALLOC_PROFILER
+#define TRACK_ALLOC(size, fileName, line) AllocProfiler::track(size, fileName, line)
+#else
+#define TRACK_ALLOC(size, fileName, line)
+#endif
 
 #ifdef TORQUE_MULTITHREAD
 void* gMemMutex = NULL;
@@ -1362,11 +1369,13 @@ void setMinimumAllocUnit(U32 allocUnit)
 
 void* FN_CDECL operator new(dsize_t size, const char* fileName, const U32 line)
 {
+    TRACK_ALLOC(size, fileName, line);
     return Memory::alloc(size, false, fileName, line);
 }
 
 void* FN_CDECL operator new[](dsize_t size, const char* fileName, const U32 line)
 {
+    TRACK_ALLOC(size, fileName, line);
     return Memory::alloc(size, true, fileName, line);
 }
 
@@ -1392,6 +1401,7 @@ void FN_CDECL operator delete[](void* mem)
 
 void* dMalloc_r(dsize_t in_size, const char* fileName, const dsize_t line)
 {
+    TRACK_ALLOC(in_size, fileName, line);
     return Memory::alloc(in_size, false, fileName, line);
 }
 
@@ -1402,15 +1412,38 @@ void dFree(void* in_pFree)
 
 void* dRealloc(void* in_pResize, dsize_t in_size)
 {
+    TRACK_ALLOC(in_size, "dRealloc", 0);
     return Memory::realloc(in_pResize, in_size);
 }
 
+#elif defined(TORQUE_SIZE_CLASS_ALLOCATOR)
+
+// Size class allocator for dMalloc and friends, the system handles new
+
+void* dMalloc_r(dsize_t in_size, const char* fileName, const dsize_t line)
+{
+    TRACK_ALLOC(in_size, fileName, line);
+    return SizeClassAllocator::alloc(in_size);
+}
+
+void dFree(void* in_pFree)
+{
+    SizeClassAllocator::free(in_pFree);
+}
+
+void* dRealloc(void* in_pResize, dsize_t in_size)
+{
+    TRACK_ALLOC(in_size, "dRealloc", 0);
+    return SizeClassAllocator::realloc(in_pResize, in_size);
+}
+
 #else
 
 // Don't manage our own memory
 
 void* dMalloc_r(dsize_t in_size, const char* fileName, const dsize_t line)
 {
+    TRACK_ALLOC(in_size, fileName, line);
     return malloc(in_size);
 }
 
@@ -1421,6 +1454,7 @@ void dFree(void* in_pFree)
 
 void* dRealloc(void* in_pResize, dsize_t in_size)
 {
+    TRACK_ALLOC(in_size, "dRealloc", 0);
     return realloc(in_pResize, in_size);
 }
 
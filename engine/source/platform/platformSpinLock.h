@@ -0,0 +1,40 @@
+//-----------------------------------------------------------------------------
+// Torque Game Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#ifndef _PLATFORMSPINLOCK_H_
+#define _PLATFORMSPINLOCK_H_
+
+#include <atomic>
+#include <thread>
+
+/// Lock for data which is only held for a few instructions at a time.
+///
+/// Unlike the Mutex functions it needs no construction or destruction, so
+/// it can guard data used from inside the memory allocator, or during
+/// static construction and destruction.
+struct SpinLock
+{
+    std::atomic_flag flag = ATOMIC_FLAG_INIT;
+
+    void lock()
+    {
+        while (flag.test_and_set(std::memory_order_acquire))
+            std::this_thread::yield();
+    }
+
+    void unlock() { flag.clear(std::memory_order_release); }
+};
+
+/// Holds a SpinLock for the life of the object.
+class SpinLockHandle
+{
+    SpinLock& mLock;
+
+public:
+    SpinLockHandle(SpinLock& lock) : mLock(lock) { mLock.lock(); }
+    ~SpinLockHandle() { mLock.unlock(); }
+};
+
+#endif // _PLATFORMSPINLOCK_H_
@@ -12,6 +12,8 @@
 #include "core/fileStream.h"
 #include "platform/platformThread.h"
 #include "core/frameAllocator.h"
+#include "platform/allocProfiler.h"
+#include "platform/profilerTimeline.h"
 
 #ifdef TORQUE_ENABLE_PROFILER
 ProfilerRootData* ProfilerRootData::sRootList = NULL;
@@ -276,6 +278,9 @@ const char* Profiler::constructProfilePath(ProfilerData* pd)
 #endif
 void Profiler::hashPush(ProfilerRootData* root)
 {
+    // The timeline keeps every thread's zones, so it goes first.
+    ProfilerTimeline::beginZone(root);
+
 #ifdef TORQUE_MULTITHREAD
     // Ignore non-main-thread profiler activity.
     if (Thread::getCurrentThreadId() != gMainThread)
@@ -285,6 +290,7 @@ void Profiler::hashPush(ProfilerRootData* root)
     mStackDepth++;
     AssertFatal(mStackDepth <= mMaxStackDepth,
         "Stack overflow in profiler.  You may have mismatched PROFILE_START and PROFILE_ENDs");
+    mZoneStack[mStackDepth] = root;
     if (!mEnabled)
         return;
 
@@ -348,6 +354,15 @@ void Profiler::hashPush(ProfilerRootData* root)
     mCurrentProfilerData = nextProfiler;
 }
 
+ProfilerRootData* Profiler::getCurrentZone()
+{
+#ifdef TORQUE_MULTITHREAD
+    if (Thread::getCurrentThreadId() != gMainThread)
+        return NULL;
+#endif
+    return mStackDepth > 0 ? mZoneStack[mStackDepth] : NULL;
+}
+
 void Profiler::enable(bool enabled)
 {
     mNextEnable = enabled;
@@ -370,6 +385,8 @@ void Profiler::dumpToFile(const char* fileName)
 
 void Profiler::hashPop()
 {
+    ProfilerTimeline::endZone();
+
 #ifdef TORQUE_MULTITHREAD
     // Ignore non-main-thread profiler activity.
     if (Thread::getCurrentThreadId() != gMainThread)
@@ -395,6 +412,10 @@ void Profiler::hashPop()
     }
     if (mStackDepth == 0)
     {
+        ProfilerTimeline::endFrame();
+#ifdef TORQUE_ALLOC_PROFILER
+        AllocProfiler::endFrame();
+#endif
         // apply the next enable...
         if (mDumpToConsole || mDumpToFile)
         {
@@ -63,6 +63,7 @@ class Profiler
 
     bool mEnabled;
     S32 mStackDepth;
+    ProfilerRootData* mZoneStack[MaxStackDepth + 1]; ///< Zones pushed, enabled or not
     bool mNextEnable;
     U32 mMaxStackDepth;
     bool mDumpToConsole;
@@ -90,6 +91,9 @@ public:
     void hashPop();
     /// Enable a profiler marker
     void enableMarker(const char* marker, bool enabled);
+    /// Innermost zone the main thread is in, whether or not the profiler is
+    /// enabled.  NULL outside of any zone, or when called from another thread.
+    ProfilerRootData* getCurrentZone();
 #ifdef TORQUE_ENABLE_PROFILE_PATH
     /// Get current profile path
     const char* getProfilePath();
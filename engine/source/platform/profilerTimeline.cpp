@@ -0,0 +1,389 @@
+//-----------------------------------------------------------------------------
+// Torque Game Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#include "platform/profilerTimeline.h"
+
+#ifdef TORQUE_ENABLE_PROFILER
+
+#include "platform/profiler.h"
+#include "platform/platformThread.h"
+#include "platform/platformSpinLock.h"
+#include "console/console.h"
+#include "core/fileStream.h"
+#include "core/tVector.h"
+
+#include <atomic>
+#include <chrono>
+
+bool ProfilerTimeline::smEnabled = false;
+
+namespace {
+    struct TimelineEvent
+    {
+        U64 time;                ///< Nanoseconds on the steady clock
+        ProfilerRootData* root;  ///< Zone, for ZoneBegin only
+        U32 type;
+    };
+
+    /// One thread's events.  Only the owning thread writes to it; the
+    /// writer fills in an event, then moves mHead past it.
+    struct ThreadBuffer
+    {
+        U32 mThreadId;
+        std::atomic<U64> mHead;      ///< Events ever written
+        std::atomic<U64> mClearedAt; ///< Events before this were cleared
+        ThreadBuffer* mNext;
+        TimelineEvent mEvents[ProfilerTimeline::BufferSize];
+    };
+
+    /// Buffers are never freed, threads come and go rarely enough that the
+    /// few left behind don't matter, and it means the writer never has to
+    /// worry about the reader.
+    ThreadBuffer* sgBufferList = NULL;
+    SpinLock sgListLock;
+
+    thread_local ThreadBuffer* tBuffer = NULL;
+
+    inline U64 getTime()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    ThreadBuffer* createBuffer()
+    {
+        ThreadBuffer* buffer = new ThreadBuffer;
+        buffer->mThreadId = Thread::getCurrentThreadId();
+        buffer->mHead.store(0, std::memory_order_relaxed);
+        buffer->mClearedAt.store(0, std::memory_order_relaxed);
+
+        SpinLockHandle handle(sgListLock);
+        buffer->mNext = sgBufferList;
+        sgBufferList = buffer;
+        return buffer;
+    }
+
+    /// Append the events the writer can't be overwriting.
+    void snapshot(ThreadBuffer* buffer, Vector<TimelineEvent>& events)
+    {
+        const U64 size = ProfilerTimeline::BufferSize;
+
+        U64 head = buffer->mHead.load(std::memory_order_acquire);
+        U64 first = head > size ? head - size : 0;
+        U64 cleared = buffer->mClearedAt.load(std::memory_order_relaxed);
+        if (first < cleared)
+            first = cleared;
+
+        U32 start = events.size();
+        events.setSize(start + U32(head - first));
+        for (U64 i = first; i < head; i++)
+            events[start + U32(i - first)] = buffer->mEvents[i & (size - 1)];
+
+        // Anything the writer has got back round to while we copied is
+        // garbage.  The slot for the event it may be writing now counts.
+        U64 newHead = buffer->mHead.load(std::memory_order_acquire);
+        U64 safe = newHead >= size ? newHead - size + 1 : 0;
+        if (safe > first)
+        {
+            U32 kept = safe < head ? U32(head - safe) : 0;
+            if (kept)
+                dMemmove(&events[start], &events[events.size() - kept], kept * sizeof(TimelineEvent));
+            events.setSize(start + kept);
+        }
+    }
+
+    struct Span
+    {
+        U64 start;
+        U64 end;
+        ProfilerRootData* root;
+        U32 depth;
+    };
+
+    struct SpanWriter
+    {
+        FileStream& stream;
+        U64 base;
+        bool first;
+
+        SpanWriter(FileStream& s, U64 b) : stream(s), base(b), first(true) {}
+
+        void write(const char* line)
+        {
+            if (!first)
+                stream.write(2, ",\n");
+            first = false;
+            stream.write(dStrlen(line), line);
+        }
+
+        void threadName(U32 tid, const char* name)
+        {
+            char buffer[256];
+            dSprintf(buffer, sizeof(buffer),
+                "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                tid, name);
+            write(buffer);
+        }
+
+        void span(U32 tid, const char* name, U64 start, U64 end)
+        {
+            char buffer[256];
+            dSprintf(buffer, sizeof(buffer),
+                "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                name, tid, F64(start - base) / 1000.0, F64(end - start) / 1000.0);
+            write(buffer);
+        }
+    };
+
+    const U32 FrameTrackId = 0;
+
+    void printSlowFrames(const Vector<Span>& frames, const Vector<Span>& zones, U64 base, U32 count)
+    {
+        Vector<U32> order;
+        for (U32 i = 0; i < frames.size(); i++)
+            order.push_back(i);
+
+        count = getMin(count, U32(order.size()));
+        for (U32 i = 0; i < count; i++)
+        {
+            // Only the top few are wanted, a partial selection sort will do.
+            U32 best = i;
+            for (U32 j = i + 1; j < order.size(); j++)
+                if (frames[order[j]].end - frames[order[j]].start > frames[order[best]].end - frames[order[best]].start)
+                    best = j;
+            U32 temp = order[i];
+            order[i] = order[best];
+            order[best] = temp;
+        }
+
+        if (count)
+            Con::printf("Slowest frames (ms, start ms, biggest zones):");
+
+        for (U32 i = 0; i < count; i++)
+        {
+            const Span& frame = frames[order[i]];
+
+            // Time per zone directly under the main loop, in this frame.
+            enum { MaxZones = 32, ZonesShown = 3 };
+            ProfilerRootData* roots[MaxZones];
+            U64 times[MaxZones];
+            U32 numRoots = 0;
+            for (U32 j = 0; j < zones.size(); j++)
+            {
+                const Span& zone = zones[j];
+                if (zone.depth != 1 || zone.start < frame.start || zone.end > frame.end)
+                    continue;
+
+                U32 k = 0;
+                while (k < numRoots && roots[k] != zone.root)
+                    k++;
+                if (k == numRoots)
+                {
+                    if (numRoots == MaxZones)
+                        continue;
+                    roots[numRoots] = zone.root;
+                    times[numRoots++] = 0;
+                }
+                times[k] += zone.end - zone.start;
+            }
+
+            char line[512];
+            S32 len = dSprintf(line, sizeof(line), "   %8.2f %10.2f ",
+                F64(frame.end - frame.start) / 1000000.0, F64(frame.start - base) / 1000000.0);
+            for (U32 shown = 0; shown < ZonesShown && numRoots; shown++)
+            {
+                U32 best = 0;
+                for (U32 k = 1; k < numRoots; k++)
+                    if (times[k] > times[best])
+                        best = k;
+
+                len += dSprintf(line + len, sizeof(line) - len, " %s %.2f", roots[best]->mName, F64(times[best]) / 1000000.0);
+                roots[best] = roots[--numRoots];
+                times[best] = times[numRoots];
+            }
+            Con::printf("%s", line);
+        }
+    }
+
+} // namespace {}
+
+//--------------------------------------
+void ProfilerTimeline::record(EventType type, ProfilerRootData* root)
+{
+    ThreadBuffer* buffer = tBuffer;
+    if (!buffer)
+        buffer = tBuffer = createBuffer();
+
+    U64 head = buffer->mHead.load(std::memory_order_relaxed);
+    TimelineEvent& event = buffer->mEvents[head & (BufferSize - 1)];
+    event.time = getTime();
+    event.root = root;
+    event.type = type;
+    buffer->mHead.store(head + 1, std::memory_order_release);
+}
+
+void ProfilerTimeline::enable(bool enabled)
+{
+    smEnabled = enabled;
+}
+
+void ProfilerTimeline::clear()
+{
+    SpinLockHandle handle(sgListLock);
+    for (ThreadBuffer* walk = sgBufferList; walk; walk = walk->mNext)
+        walk->mClearedAt.store(walk->mHead.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
+
+bool ProfilerTimeline::writeTrace(const char* fileName, U32 slowFrames)
+{
+    // Copy everything out first so the timestamps can be made relative to
+    // the earliest one.  Thread t's events start at threadStart[t].
+    Vector<TimelineEvent> allEvents;
+    Vector<U32> threadIds;
+    Vector<U32> threadStart;
+    {
+        SpinLockHandle handle(sgListLock);
+        for (ThreadBuffer* walk = sgBufferList; walk; walk = walk->mNext)
+        {
+            threadIds.push_back(walk->mThreadId);
+            threadStart.push_back(allEvents.size());
+            snapshot(walk, allEvents);
+        }
+    }
+    threadStart.push_back(allEvents.size());
+
+    U64 base = U64(-1);
+    for (U32 i = 0; i < allEvents.size(); i++)
+        if (allEvents[i].time < base)
+            base = allEvents[i].time;
+
+    if (base == U64(-1))
+    {
+        Con::errorf("ProfilerTimeline: nothing recorded, use profilerTimelineEnable(true) first.");
+        return false;
+    }
+
+    FileStream stream;
+    if (!stream.open(fileName, FileStream::Write))
+    {
+        Con::errorf("ProfilerTimeline: could not open %s for writing.", fileName);
+        return false;
+    }
+
+    const char* header = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    stream.write(dStrlen(header), header);
+
+    SpanWriter writer(stream, base);
+    writer.threadName(FrameTrackId, "Frames");
+
+    Vector<Span> frames;
+    Vector<Span> mainZones;
+    Vector<Span> stack;
+
+    for (U32 t = 0; t < threadIds.size(); t++)
+    {
+        const TimelineEvent* events = &allEvents[threadStart[t]];
+        U32 numEvents = threadStart[t + 1] - threadStart[t];
+        U32 tid = threadIds[t];
+
+        // Frame ends only come from the main thread.
+        bool isMain = false;
+        for (U32 i = 0; i < numEvents && !isMain; i++)
+            isMain = events[i].type == FrameEnd;
+
+        char name[64];
+        if (isMain)
+            dStrcpy(name, "Main thread");
+        else
+            dSprintf(name, sizeof(name), "Thread %u", tid);
+        writer.threadName(tid, name);
+
+        // Zones are matched up with a stack.  The buffer may have wrapped
+        // in the middle of a zone, so an end with nothing open is dropped.
+        stack.clear();
+        U64 lastFrame = 0;
+        for (U32 i = 0; i < numEvents; i++)
+        {
+            const TimelineEvent& event = events[i];
+            if (event.type == ZoneBegin)
+            {
+                Span span;
+                span.start = event.time;
+                span.end = event.time;
+                span.root = event.root;
+                span.depth = stack.size();
+                stack.push_back(span);
+            }
+            else if (event.type == ZoneEnd)
+            {
+                if (stack.empty())
+                    continue;
+                Span span = stack.last();
+                stack.pop_back();
+                span.end = event.time;
+                writer.span(tid, span.root->mName, span.start, span.end);
+                if (isMain && span.depth == 1)
+                    mainZones.push_back(span);
+            }
+            else
+            {
+                if (lastFrame)
+                {
+                    Span frame;
+                    frame.start = lastFrame;
+                    frame.end = event.time;
+                    frame.root = NULL;
+                    frame.depth = 0;
+                    frames.push_back(frame);
+
+                    dSprintf(name, sizeof(name), "Frame %d", frames.size());
+                    writer.span(FrameTrackId, name, frame.start, frame.end);
+                }
+                lastFrame = event.time;
+            }
+        }
+
+        // Close anything still open at the last thing seen on the thread.
+        U64 lastTime = numEvents ? events[numEvents - 1].time : base;
+        while (!stack.empty())
+        {
+            writer.span(tid, stack.last().root->mName, stack.last().start, lastTime);
+            stack.pop_back();
+        }
+    }
+
+    const char* footer = "\n]}\n";
+    stream.write(dStrlen(footer), footer);
+    stream.close();
+
+    Con::printf("ProfilerTimeline: wrote %d events from %d threads, %d frames, to %s",
+        allEvents.size(), threadIds.size(), frames.size(), fileName);
+    printSlowFrames(frames, mainZones, base, slowFrames);
+    return true;
+}
+
+//--------------------------------------
+ConsoleFunction(profilerTimelineEnable, void, 2, 2, "(bool enable)"
+    "Start or stop recording every profiler zone on every thread.")
+{
+    argc;
+    ProfilerTimeline::enable(dAtob(argv[1]));
+}
+
+ConsoleFunction(profilerTimelineClear, void, 1, 1, "()"
+    "Throw away the profiler zones recorded so far.")
+{
+    argc, argv;
+    ProfilerTimeline::clear();
+}
+
+ConsoleFunction(profilerTimelineDump, bool, 2, 3, "(string fileName, int slowFrames = 5)"
+    "Write the recorded profiler zones to a Chrome trace file, for chrome://tracing "
+    "or ui.perfetto.dev, and print the slowest frames.")
+{
+    return ProfilerTimeline::writeTrace(argv[1], argc > 2 ? dAtoi(argv[2]) : 5);
+}
+
+#endif // TORQUE_ENABLE_PROFILER
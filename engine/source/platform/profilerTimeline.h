@@ -0,0 +1,91 @@
+//-----------------------------------------------------------------------------
+// Torque Game Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#ifndef _PROFILERTIMELINE_H_
+#define _PROFILERTIMELINE_H_
+
+#ifndef _PLATFORM_H_
+#include "platform/platform.h"
+#endif
+
+#ifdef TORQUE_ENABLE_PROFILER
+
+struct ProfilerRootData;
+
+/// Records every PROFILE_START and PROFILE_END as a timestamped event, so
+/// single frames can be looked at instead of the averages the Profiler
+/// prints.
+///
+/// Each thread writes its events into its own ring buffer, which only that
+/// thread ever writes, so recording takes no lock.  When the buffer is full
+/// the oldest events are overwritten, so the trace always holds the last
+/// few seconds.  Unlike the Profiler, zones on threads other than the main
+/// thread are recorded too.
+///
+/// The trace is written out in the Chrome trace event format, which can
+/// be opened in chrome://tracing or ui.perfetto.dev.  The main thread also
+/// gets a track with one span per frame, and the slowest frames and the
+/// zones that took the most of them are printed to the console.
+/// @code
+/// profilerTimelineEnable(true);
+/// // ... play until it hitches ...
+/// profilerTimelineDump("timeline.json");
+/// @endcode
+///
+/// When it's off, the cost is a test of one flag per zone.
+class ProfilerTimeline
+{
+public:
+    enum Constants
+    {
+        /// Events kept per thread, must be a power of two.
+        BufferSize = 1 << 16,
+    };
+
+    enum EventType
+    {
+        ZoneBegin,
+        ZoneEnd,
+        FrameEnd,
+    };
+
+    static inline void beginZone(ProfilerRootData* root)
+    {
+        if (smEnabled)
+            record(ZoneBegin, root);
+    }
+
+    static inline void endZone()
+    {
+        if (smEnabled)
+            record(ZoneEnd, NULL);
+    }
+
+    /// Called by the profiler when the main loop finishes a pass.
+    static inline void endFrame()
+    {
+        if (smEnabled)
+            record(FrameEnd, NULL);
+    }
+
+    static void enable(bool enabled);
+    static bool isEnabled() { return smEnabled; }
+
+    /// Throw away everything recorded so far.
+    static void clear();
+
+    /// Write what's in the buffers to a Chrome trace file, and print the
+    /// slowest frames in it.
+    static bool writeTrace(const char* fileName, U32 slowFrames);
+
+private:
+    static bool smEnabled;
+
+    static void record(EventType type, ProfilerRootData* root);
+};
+
+#endif // TORQUE_ENABLE_PROFILER
+
+#endif // _PROFILERTIMELINE_H_
@@ -0,0 +1,490 @@
+//-----------------------------------------------------------------------------
+// Torque Game Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#include "platform/sizeClassAllocator.h"
+#include "platform/threadPool.h"
+#include "console/console.h"
+#include "platform/platformSpinLock.h"
+#include "math/mRandom.h"
+
+#include <stdlib.h>
+
+namespace
+{
+    enum
+    {
+        BlockMagic = 0x5A11C0DE,
+
+        /// Class index of blocks which came straight from the system.
+        LargeClass = 0xFFFFFFFF,
+
+        /// Bytes moved between a thread's list and the shared list at once.
+        BatchBytes = 16 * 1024,
+    };
+
+    struct BlockHeader
+    {
+        U32 magic;
+        U32 sizeClass;
+
+        /// Bytes the caller asked for.
+        U64 size;
+    };
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    /// Shared free list for one size class.  The lock is only held long
+    /// enough to move a batch.
+    struct CentralList
+    {
+        SpinLock lock;
+        FreeBlock* head;
+        U32 count;
+        U32 spans;
+    };
+
+    CentralList sgCentral[SizeClassAllocator::NumClasses];
+    std::atomic<U64> sgSystemBytes(0);
+
+    U32 getBatchCount(U32 index)
+    {
+        U32 count = BatchBytes / SizeClassAllocator::getClassSize(index);
+        return getMax(U32(4), getMin(count, U32(128)));
+    }
+
+    /// Pop up to count blocks off a class's shared list, carving a new span
+    /// if it is empty.  Returns the chain and the number in it.
+    FreeBlock* fetchBatch(U32 index, U32 count, U32* numFetched)
+    {
+        CentralList& central = sgCentral[index];
+        SpinLockHandle guard(central.lock);
+
+        if (!central.head)
+        {
+            U32 blockSize = SizeClassAllocator::getClassSize(index);
+            U32 numBlocks = SizeClassAllocator::SpanSize / blockSize;
+
+            U8* span = (U8*)dRealMalloc(SizeClassAllocator::SpanSize);
+            if (!span)
+            {
+                *numFetched = 0;
+                return NULL;
+            }
+            sgSystemBytes += SizeClassAllocator::SpanSize;
+            central.spans++;
+
+            // Link back to front so the list hands out ascending addresses
+            for (S32 i = numBlocks - 1; i >= 0; i--)
+            {
+                FreeBlock* block = (FreeBlock*)(span + i * blockSize);
+                block->next = central.head;
+                central.head = block;
+            }
+            central.count += numBlocks;
+        }
+
+        FreeBlock* first = central.head;
+        FreeBlock* last = first;
+        U32 n = 1;
+        while (n < count && last->next)
+        {
+            last = last->next;
+            n++;
+        }
+
+        central.head = last->next;
+        central.count -= n;
+        last->next = NULL;
+
+        *numFetched = n;
+        return first;
+    }
+
+    void releaseBatch(U32 index, FreeBlock* first, FreeBlock* last, U32 count)
+    {
+        CentralList& central = sgCentral[index];
+        SpinLockHandle guard(central.lock);
+
+        last->next = central.head;
+        central.head = first;
+        central.count += count;
+    }
+
+    /// Per thread free lists.  Blocks freed by a thread go on its own
+    /// lists whichever thread allocated them.
+    struct ThreadCache
+    {
+        FreeBlock* head[SizeClassAllocator::NumClasses];
+        U32 count[SizeClassAllocator::NumClasses];
+
+        /// Cleared once the thread's destructors have run, after which
+        /// this thread goes straight to the shared lists.
+        bool alive;
+
+        ThreadCache()
+        {
+            for (U32 i = 0; i < SizeClassAllocator::NumClasses; i++)
+            {
+                head[i] = NULL;
+                count[i] = 0;
+            }
+            alive = true;
+        }
+
+        ~ThreadCache()
+        {
+            // Hand everything back so other threads can use it
+            for (U32 i = 0; i < SizeClassAllocator::NumClasses; i++)
+            {
+                if (!head[i])
+                    continue;
+
+                FreeBlock* last = head[i];
+                while (last->next)
+                    last = last->next;
+                releaseBatch(i, head[i], last, count[i]);
+
+                head[i] = NULL;
+                count[i] = 0;
+            }
+            alive = false;
+        }
+    };
+
+    thread_local ThreadCache tCache;
+
+    void* allocBlock(U32 index)
+    {
+        ThreadCache& cache = tCache;
+        if (!cache.alive)
+        {
+            U32 n;
+            return fetchBatch(index, 1, &n);
+        }
+
+        FreeBlock* block = cache.head[index];
+        if (!block)
+        {
+            U32 n;
+            block = fetchBatch(index, getBatchCount(index), &n);
+            if (!block)
+                return NULL;
+            cache.count[index] = n;
+        }
+
+        cache.head[index] = block->next;
+        cache.count[index]--;
+        return block;
+    }
+
+    void freeBlock(U32 index, void* mem)
+    {
+        FreeBlock* block = (FreeBlock*)mem;
+
+        ThreadCache& cache = tCache;
+        if (!cache.alive)
+        {
+            releaseBatch(index, block, block, 1);
+            return;
+        }
+
+        block->next = cache.head[index];
+        cache.head[index] = block;
+
+        // Keep one batch around for the next allocations, give the rest
+        // back so memory freed on one thread can be used by the others.
+        U32 batch = getBatchCount(index);
+        if (++cache.count[index] >= batch * 2)
+        {
+            FreeBlock* last = block;
+            for (U32 i = 1; i < batch; i++)
+                last = last->next;
+
+            cache.head[index] = last->next;
+            cache.count[index] -= batch;
+            releaseBatch(index, block, last, batch);
+        }
+    }
+
+    inline BlockHeader* getHeader(void* mem)
+    {
+        return (BlockHeader*)((U8*)mem - SizeClassAllocator::HeaderSize);
+    }
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+U32 SizeClassAllocator::getClassIndex(dsize_t blockSize)
+{
+    AssertFatal(blockSize > 0 && blockSize <= MaxClassSize, "SizeClassAllocator::getClassIndex - size out of range");
+
+    // 16 byte steps up to 128, then four steps per power of two
+    U32 size = U32(blockSize) - 1;
+    if (size < 128)
+        return size >> 4;
+
+    U32 log = getFastBinLog2(size);
+    return 8 + (log - 7) * 4 + ((size >> (log - 2)) & 3);
+}
+
+U32 SizeClassAllocator::getClassSize(U32 index)
+{
+    if (index < 8)
+        return (index + 1) * 16;
+
+    U32 log = 7 + (index - 8) / 4;
+    U32 step = (index - 8) % 4;
+    return (1 << log) + (step + 1) * (1 << (log - 2));
+}
+
+void* SizeClassAllocator::alloc(dsize_t size)
+{
+    dsize_t blockSize = size + HeaderSize;
+
+    BlockHeader* header;
+    if (blockSize <= MaxClassSize)
+    {
+        U32 index = getClassIndex(blockSize);
+        header = (BlockHeader*)allocBlock(index);
+        if (!header)
+            return NULL;
+        header->sizeClass = index;
+    }
+    else
+    {
+        header = (BlockHeader*)dRealMalloc(blockSize);
+        if (!header)
+            return NULL;
+        header->sizeClass = LargeClass;
+        sgSystemBytes += blockSize;
+    }
+
+    header->magic = BlockMagic;
+    header->size = size;
+    return (U8*)header + HeaderSize;
+}
+
+void SizeClassAllocator::free(void* mem)
+{
+    if (!mem)
+        return;
+
+    BlockHeader* header = getHeader(mem);
+    if (header->magic != BlockMagic)
+    {
+        // Not one of ours.  Some code frees system memory through dFree,
+        // which was fine before this allocator, so keep it working.
+        AssertFatal(false, "SizeClassAllocator::free - block wasn't allocated with dMalloc");
+        ::free(mem);
+        return;
+    }
+
+    // Catches double frees
+    header->magic = 0;
+
+    if (header->sizeClass == LargeClass)
+    {
+        sgSystemBytes -= header->size + HeaderSize;
+        dRealFree(header);
+    }
+    else
+        freeBlock(header->sizeClass, header);
+}
+
+void* SizeClassAllocator::realloc(void* mem, dsize_t size)
+{
+    if (!mem)
+        return alloc(size);
+
+    if (!size)
+    {
+        free(mem);
+        return NULL;
+    }
+
+    BlockHeader* header = getHeader(mem);
+    if (header->magic != BlockMagic)
+    {
+        AssertFatal(false, "SizeClassAllocator::realloc - block wasn't allocated with dMalloc");
+        return ::realloc(mem, size);
+    }
+
+    // Stay put if the block is big enough and not wastefully so
+    dsize_t usable = getUsableSize(mem);
+    if (size <= usable && (header->sizeClass == LargeClass || size + HeaderSize > usable / 2))
+    {
+        if (header->sizeClass != LargeClass)
+            header->size = size;
+        return mem;
+    }
+
+    void* ret = alloc(size);
+    if (ret)
+    {
+        dMemcpy(ret, mem, header->size < size ? dsize_t(header->size) : size);
+        free(mem);
+    }
+    return ret;
+}
+
+dsize_t SizeClassAllocator::getUsableSize(void* mem)
+{
+    BlockHeader* header = getHeader(mem);
+    if (header->sizeClass == LargeClass)
+        return header->size;
+    return getClassSize(header->sizeClass) - HeaderSize;
+}
+
+dsize_t SizeClassAllocator::getSystemBytes()
+{
+    return dsize_t(sgSystemBytes.load());
+}
+
+void SizeClassAllocator::dumpStats()
+{
+    Con::printf("Size class allocator: %d KB from the system", U32(getSystemBytes() / 1024));
+    for (U32 i = 0; i < NumClasses; i++)
+    {
+        CentralList& central = sgCentral[i];
+        SpinLockHandle guard(central.lock);
+        if (central.spans == 0)
+            continue;
+
+        Con::printf("   %5d bytes: %3d spans, %6d blocks free in the shared list",
+            getClassSize(i), central.spans, central.count);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Microbenchmark.  Runs the same allocation patterns through dMalloc and
+// the system allocator, on the main thread and then on every thread of the
+// ThreadPool at once.
+
+namespace
+{
+    enum
+    {
+        BenchSlots = 1024,
+        BenchOps = 200000,
+    };
+
+    typedef void* (*BenchAllocFn)(dsize_t);
+    typedef void (*BenchFreeFn)(void*);
+    typedef void* (*BenchReallocFn)(void*, dsize_t);
+
+    struct BenchAllocator
+    {
+        BenchAllocFn alloc;
+        BenchFreeFn free;
+        BenchReallocFn realloc;
+    };
+
+    void* benchDMalloc(dsize_t size) { return dMalloc(size); }
+    void* benchSysMalloc(dsize_t size) { return ::malloc(size); }
+    void benchSysFree(void* mem) { ::free(mem); }
+    void* benchSysRealloc(void* mem, dsize_t size) { return ::realloc(mem, size); }
+
+    const BenchAllocator sgBenchEngine = { benchDMalloc, dFree, dRealloc };
+    const BenchAllocator sgBenchSystem = { benchSysMalloc, benchSysFree, benchSysRealloc };
+
+    /// Random sizes, mostly small, freed in random order.  Roughly what
+    /// SimObjects, strings and small Vectors look like.
+    void benchChurn(const BenchAllocator& a, U32 seed)
+    {
+        MRandomLCG random(seed);
+        void* slots[BenchSlots];
+        dMemset(slots, 0, sizeof(slots));
+
+        for (U32 i = 0; i < BenchOps; i++)
+        {
+            U32 slot = random.randI(0, BenchSlots - 1);
+            if (slots[slot])
+                a.free(slots[slot]);
+
+            // Three in four are under 128 bytes
+            U32 size = random.randI(0, 3) ? random.randI(1, 128) : random.randI(129, 4096);
+            slots[slot] = a.alloc(size);
+        }
+
+        for (U32 i = 0; i < BenchSlots; i++)
+            a.free(slots[i]);
+    }
+
+    /// Vectors growing by doubling, then freed.
+    void benchGrowth(const BenchAllocator& a, U32 seed)
+    {
+        for (U32 i = 0; i < BenchOps / 16; i++)
+        {
+            void* mem = NULL;
+            for (U32 size = 16; size <= 2048; size *= 2)
+                mem = a.realloc(mem, size);
+            a.free(mem);
+        }
+    }
+
+    const BenchAllocator* sgBenchJobAllocator;
+    void (*sgBenchJobPattern)(const BenchAllocator&, U32);
+
+    void benchJob(void*, U32 index)
+    {
+        sgBenchJobPattern(*sgBenchJobAllocator, index + 1);
+    }
+
+    U32 timeBench(const BenchAllocator& a, void (*pattern)(const BenchAllocator&, U32), bool threaded)
+    {
+        U32 start = Platform::getRealMilliseconds();
+        if (threaded)
+        {
+            sgBenchJobAllocator = &a;
+            sgBenchJobPattern = pattern;
+            ThreadPool::run(benchJob, NULL, ThreadPool::getNumThreads());
+        }
+        else
+            pattern(a, 1);
+        return Platform::getRealMilliseconds() - start;
+    }
+
+} // namespace
+
+ConsoleFunction(memoryBenchmark, void, 1, 1, "Time dMalloc against the system allocator.")
+{
+    U32 threads = ThreadPool::getNumThreads();
+    Con::printf("Allocation benchmark, %d ops per pattern (engine / system):", BenchOps);
+
+    struct { const char* name; void (*fn)(const BenchAllocator&, U32); } patterns[] =
+    {
+        { "churn", benchChurn },
+        { "growth", benchGrowth },
+    };
+
+    for (U32 i = 0; i < sizeof(patterns) / sizeof(patterns[0]); i++)
+    {
+        U32 engine = timeBench(sgBenchEngine, patterns[i].fn, false);
+        U32 system = timeBench(sgBenchSystem, patterns[i].fn, false);
+        Con::printf("   %-8s 1 thread:  %5d ms / %5d ms", patterns[i].name, engine, system);
+
+        if (threads > 1)
+        {
+            engine = timeBench(sgBenchEngine, patterns[i].fn, true);
+            system = timeBench(sgBenchSystem, patterns[i].fn, true);
+            Con::printf("   %-8s %d threads: %5d ms / %5d ms", patterns[i].name, threads, engine, system);
+        }
+    }
+
+#ifdef TORQUE_SIZE_CLASS_ALLOCATOR
+    SizeClassAllocator::dumpStats();
+#else
+    Con::printf("   (dMalloc isn't using the size class allocator in this build)");
+#endif
+}
+
+ConsoleFunction(dumpSizeClassAllocator, void, 1, 1, "Print span use of the size class allocator.")
+{
+    SizeClassAllocator::dumpStats();
+}
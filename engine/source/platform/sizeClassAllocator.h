@@ -0,0 +1,67 @@
+//-----------------------------------------------------------------------------
+// Torque Game Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#ifndef _SIZECLASSALLOCATOR_H_
+#define _SIZECLASSALLOCATOR_H_
+
+#ifndef _PLATFORM_H_
+#include "platform/platform.h"
+#endif
+
+/// General purpose allocator behind dMalloc, dFree and dRealloc in release
+/// builds.  See TORQUE_SIZE_CLASS_ALLOCATOR in torqueConfig.h.
+///
+/// Small requests are rounded up to one of a few dozen size classes, four
+/// per power of two, and served from a free list for that class.  Every
+/// thread keeps its own short list per class, so most allocations and
+/// frees touch no lock at all and cost a handful of instructions.  When a
+/// thread's list runs dry or grows too long, a batch of blocks is moved
+/// to or from a shared list for the class, under that class's lock.  The
+/// shared lists are refilled by carving up large spans from the system.
+///
+/// Requests too big for the largest class go straight to the system.
+///
+/// Every block starts with a small header recording its class, so a free
+/// is a single push and needs no lookup.  Like the Torque memory manager,
+/// spans are never given back to the system, they are just reused.
+class SizeClassAllocator
+{
+public:
+    enum Constants
+    {
+        /// Size classes 16, 32, .. 128, then four steps per power of two.
+        NumClasses = 40,
+
+        /// Largest block, header included, served from a class.
+        MaxClassSize = 32768,
+
+        /// Memory taken from the system at a time to carve into blocks.
+        SpanSize = 256 * 1024,
+
+        /// Bytes in front of every block.  Keeps blocks 16 byte aligned.
+        HeaderSize = 16,
+    };
+
+    static void* alloc(dsize_t size);
+    static void  free(void* mem);
+    static void* realloc(void* mem, dsize_t size);
+
+    /// Bytes that can be used in a block, at least what was asked for.
+    static dsize_t getUsableSize(void* mem);
+
+    /// Bytes taken from the system so far, spans and large blocks.
+    static dsize_t getSystemBytes();
+
+    /// Print span use and the shared free lists for every class.
+    static void dumpStats();
+
+    /// @name Size classes
+    /// @{
+    static U32 getClassIndex(dsize_t blockSize);
+    static U32 getClassSize(U32 index);
+    /// @}
+};
+
+#endif // _SIZECLASSALLOCATOR_H_
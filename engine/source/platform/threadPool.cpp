@@ -0,0 +1,145 @@
+//-----------------------------------------------------------------------------
+// Torque Game Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#include "platform/threadPool.h"
+#include "platform/platformThread.h"
+#include "platform/platformSemaphore.h"
+#include "console/console.h"
+#include "console/consoleTypes.h"
+#include "core/frameAllocator.h"
+
+#include <thread>
+
+Thread* ThreadPool::smWorkers[MaxWorkers];
+U32 ThreadPool::smNumWorkers = 0;
+bool ThreadPool::smEnabled = true;
+
+void* ThreadPool::smWakeSemaphore = NULL;
+void* ThreadPool::smDoneSemaphore = NULL;
+bool ThreadPool::smShutdown = false;
+
+ThreadPool::JobFunction ThreadPool::smJobFunc = NULL;
+void* ThreadPool::smJobData = NULL;
+U32 ThreadPool::smJobCount = 0;
+std::atomic<U32> ThreadPool::smNextJob(0);
+std::atomic<U32> ThreadPool::smActiveWorkers(0);
+
+//-----------------------------------------------------------------------------
+
+void ThreadPool::init(S32 numWorkers)
+{
+    AssertFatal(smNumWorkers == 0, "ThreadPool::init - already initialized");
+
+    if (numWorkers < 0)
+    {
+        U32 hardwareThreads = std::thread::hardware_concurrency();
+        numWorkers = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+    smNumWorkers = getMin(U32(numWorkers), U32(MaxWorkers));
+
+    Con::addVariable("ThreadPool::enabled", TypeBool, &smEnabled);
+    Con::addVariable("ThreadPool::numWorkers", TypeS32, &smNumWorkers);
+
+    if (smNumWorkers == 0)
+        return;
+
+    smShutdown = false;
+    smWakeSemaphore = Semaphore::createSemaphore(0);
+    smDoneSemaphore = Semaphore::createSemaphore(0);
+
+    for (U32 i = 0; i < smNumWorkers; i++)
+        smWorkers[i] = new Thread(workerMain, (void*)dsize_t(i), true);
+
+    Con::printf("Thread pool: %d worker threads", smNumWorkers);
+}
+
+void ThreadPool::shutdown()
+{
+    if (smNumWorkers == 0)
+        return;
+
+    smShutdown = true;
+    for (U32 i = 0; i < smNumWorkers; i++)
+        Semaphore::releaseSemaphore(smWakeSemaphore);
+
+    // Thread's destructor joins
+    for (U32 i = 0; i < smNumWorkers; i++)
+    {
+        delete smWorkers[i];
+        smWorkers[i] = NULL;
+    }
+    smNumWorkers = 0;
+
+    Semaphore::destroySemaphore(smWakeSemaphore);
+    Semaphore::destroySemaphore(smDoneSemaphore);
+    smWakeSemaphore = smDoneSemaphore = NULL;
+}
+
+//-----------------------------------------------------------------------------
+
+void ThreadPool::runJobs()
+{
+    U32 index;
+    while ((index = smNextJob.fetch_add(1)) < smJobCount)
+        smJobFunc(smJobData, index);
+}
+
+void ThreadPool::workerMain(void* arg)
+{
+    // Jobs get scratch memory of their own, the main thread's
+    // FrameAllocator isn't safe to touch from here.
+    char name[32];
+    dSprintf(name, sizeof(name), "ThreadPool worker %d", U32(dsize_t(arg)));
+    FrameAllocator::initThread(TORQUE_THREAD_FRAME_SIZE, name);
+
+    for (;;)
+    {
+        Semaphore::acquireSemaphore(smWakeSemaphore);
+        if (smShutdown)
+            break;
+
+        runJobs();
+
+        // The last worker out tells run() the batch is finished.  Workers
+        // that weren't woken for this batch never touch it, so run() can
+        // set up the next one as soon as this is signalled.
+        if (smActiveWorkers.fetch_sub(1) == 1)
+            Semaphore::releaseSemaphore(smDoneSemaphore);
+    }
+
+    FrameAllocator::destroyThread();
+}
+
+void ThreadPool::run(JobFunction func, void* data, U32 count)
+{
+    if (count == 0)
+        return;
+
+    if (!smEnabled || smNumWorkers == 0 || count == 1)
+    {
+        for (U32 i = 0; i < count; i++)
+            func(data, i);
+        return;
+    }
+
+    AssertFatal(smJobFunc == NULL, "ThreadPool::run - batches can't be nested");
+
+    smJobFunc = func;
+    smJobData = data;
+    smJobCount = count;
+    smNextJob = 0;
+
+    // No point waking more workers than there are jobs left for them
+    U32 numWake = getMin(smNumWorkers, count - 1);
+    smActiveWorkers = numWake;
+    for (U32 i = 0; i < numWake; i++)
+        Semaphore::releaseSemaphore(smWakeSemaphore);
+
+    runJobs();
+    Semaphore::acquireSemaphore(smDoneSemaphore);
+
+    smJobFunc = NULL;
+    smJobData = NULL;
+}
@@ -0,0 +1,84 @@
+//-----------------------------------------------------------------------------
+// Torque Game Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#ifndef _THREADPOOL_H_
+#define _THREADPOOL_H_
+
+#ifndef _PLATFORM_H_
+#include "platform/platform.h"
+#endif
+
+#include <atomic>
+
+class Thread;
+
+/// Small pool of worker threads for splitting per-frame work.
+///
+/// Work is handed out as a batch of numbered jobs that all run the same
+/// function.  The calling thread works on the batch too and run() only
+/// returns once every job is finished, so jobs can write straight into the
+/// caller's data as long as each one touches its own part of it:
+///
+/// @code
+/// static void skinJob(void* data, U32 index)
+/// {
+///    SkinBatch* batch = (SkinBatch*)data;
+///    batch->skin(index * 64, 64);
+/// }
+///
+/// ThreadPool::run(skinJob, &batch, numChunks);
+/// @endcode
+///
+/// Only the main thread may start batches, and jobs may not start batches
+/// of their own.
+class ThreadPool
+{
+public:
+    typedef void (*JobFunction)(void* data, U32 index);
+
+private:
+    enum Constants
+    {
+        MaxWorkers = 7,
+    };
+
+    static Thread* smWorkers[MaxWorkers];
+    static U32 smNumWorkers;
+    static bool smEnabled;
+
+    static void* smWakeSemaphore;
+    static void* smDoneSemaphore;
+    static bool smShutdown;
+
+    /// @name Current batch
+    /// Only written by the main thread while no worker is looking.
+    /// @{
+    static JobFunction smJobFunc;
+    static void* smJobData;
+    static U32 smJobCount;
+    static std::atomic<U32> smNextJob;
+    static std::atomic<U32> smActiveWorkers;
+    /// @}
+
+    static void workerMain(void* arg);
+    static void runJobs();
+
+public:
+    /// Start the workers.  With numWorkers < 0 one worker is started per
+    /// extra hardware thread, up to MaxWorkers.
+    static void init(S32 numWorkers = -1);
+    static void shutdown();
+
+    /// Number of threads that take part in a batch, counting the caller.
+    static U32 getNumThreads() { return smEnabled ? smNumWorkers + 1 : 1; }
+
+    /// Run func(data, i) for every i in [0, count), and wait for all of them.
+    ///
+    /// With the pool disabled ($ThreadPool::enabled) or a single job,
+    /// everything runs on the calling thread, in order.
+    static void run(JobFunction func, void* data, U32 count);
+};
+
+#endif // _THREADPOOL_H_
@@ -79,6 +79,12 @@ static const F32 F32_MAX = F32(3.402823466e+38F);                 ///< Constant
 #  error "Unknown Compiler"
 #endif
 
+//--------------------------------------
+// SSE intrinsics (xmmintrin.h) are available on every x86 target we build for
+#if defined(TORQUE_CPU_X86) || defined(TORQUE_CPU_X64)
+#  define TORQUE_SUPPORTS_SSE
+#endif
+
 //--------------------------------------
 // Enable Asserts in all debug builds -- AFTER compiler types include.
 //#if defined(TORQUE_DEBUG)
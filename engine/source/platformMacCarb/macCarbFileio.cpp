@@ -47,6 +47,16 @@ bool dFileDelete(const char * name)
 }
 
 
+//-----------------------------------------------------------------------------
+bool dFileRename(const char *oldName, const char *newName)
+{
+   if(!oldName || !newName)
+      return(false);
+
+   return(rename(oldName, newName) == 0); // rename returns 0 on success
+}
+
+
 //-----------------------------------------------------------------------------
 bool dFileTouch(const char *path)
 {
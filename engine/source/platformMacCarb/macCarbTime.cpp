@@ -43,6 +43,13 @@ U32 Platform::getRealMilliseconds()
    return (time.hi*0x100000000LL)/1000 + (time.lo/1000);
 }   
 
+U64 Platform::getRealMicroseconds()
+{
+   UnsignedWide time;
+   Microseconds(&time);
+   return (U64(time.hi) << 32) | time.lo;
+}
+
 U32 Platform::getVirtualMilliseconds()
 {
    return platState.currentTime;   
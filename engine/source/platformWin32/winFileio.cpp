@@ -56,6 +56,14 @@ bool dFileDelete(const char* name)
     return(remove(name) == 0);
 }
 
+bool dFileRename(const char* oldName, const char* newName)
+{
+    if (!oldName || !newName || (dStrlen(oldName) >= MAX_PATH) || (dStrlen(newName) >= MAX_PATH))
+        return(false);
+    // rename() won't replace an existing file here.
+    return(MoveFileExA(oldName, newName, MOVEFILE_REPLACE_EXISTING) != 0);
+}
+
 bool dFileTouch(const char* name)
 {
     // change the modified time to the current time (0byte WriteFile fails!)
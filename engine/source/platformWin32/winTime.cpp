@@ -81,6 +81,20 @@ U32 Platform::getRealMilliseconds()
     return GetTickCount();
 }
 
+U64 Platform::getRealMicroseconds()
+{
+    static LARGE_INTEGER sFrequency = { 0 };
+    if (sFrequency.QuadPart == 0)
+        QueryPerformanceFrequency(&sFrequency);
+
+    // Split the division so the multiply can't overflow.
+    LARGE_INTEGER count;
+    QueryPerformanceCounter(&count);
+    U64 secs = count.QuadPart / sFrequency.QuadPart;
+    U64 rest = count.QuadPart % sFrequency.QuadPart;
+    return secs * 1000000 + rest * 1000000 / sFrequency.QuadPart;
+}
+
 U32 Platform::getVirtualMilliseconds()
 {
     return winState.currentTime;
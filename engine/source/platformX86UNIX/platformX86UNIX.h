@@ -36,6 +36,10 @@ void ImmediateShutdown(S32 exitCode, S32 signalNum = 0);
 void ProcessControlInit();
 bool AcquireProcessMutex(const char *mutexName);
 
+// Block until network input arrives, there's input on extraFd (if not -1)
+// or timeoutMs goes by.
+void x86UNIXNetWait(S32 timeoutMs, int extraFd);
+
 // Utility functions
 // Convert a string to lowercase in place
 char *strtolwr(char* str);
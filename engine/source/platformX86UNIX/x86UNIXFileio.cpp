@@ -373,6 +373,25 @@ bool dFileDelete(const char * name)
    return ModifyFile(name, DELETE);
 }
 
+//-----------------------------------------------------------------------------
+bool dFileRename(const char * oldName, const char * newName)
+{
+   if(!oldName || !newName || (dStrlen(oldName) >= MAX_PATH) || (dStrlen(newName) >= MAX_PATH) ||
+      dStrstr(oldName, "../") != NULL || dStrstr(newName, "../") != NULL)
+      return(false);
+
+   // same rules as ModifyFile, only files in the home directory
+   if (oldName[0]=='/' || oldName[0]=='\\' || newName[0]=='/' || newName[0]=='\\')
+      return(false);
+
+   char prefOldName[MaxPath];
+   char prefNewName[MaxPath];
+   MungePath(prefOldName, MaxPath, oldName, GetPrefDir());
+   MungePath(prefNewName, MaxPath, newName, GetPrefDir());
+
+   return(rename(prefOldName, prefNewName) == 0);
+}
+
 //-----------------------------------------------------------------------------
 bool dFileTouch(const char * name)
 {
@@ -19,6 +19,7 @@
 #include <netdb.h>
 #include <netinet/in.h>
 #include <errno.h>
+#include <fcntl.h>
 
 /* for PROTO_IPX */
 #if defined(__linux__)
@@ -35,8 +36,10 @@
 
 #include "console/console.h"
 #include "platform/gameInterface.h"
+#include "platform/platformThread.h"
 #include "core/fileStream.h"
 #include "core/tVector.h"
+#include "core/tSPSCQueue.h"
 
 static Net::Error getLastError();
 static S32 defaultPort = 28000;
@@ -139,15 +142,10 @@ static void IPSocketToNetAddress(const struct sockaddr_in *sockAddr, NetAddress
 {
    address->type = NetAddress::IPAddress;
    address->port = htons(sockAddr->sin_port);
-   char *tAddr;
-   tAddr = inet_ntoa(sockAddr->sin_addr);
-//fprintf(stdout,"IPSocketToNetAddress(): %s\n",tAddr);fflush(NULL);
-   U8 nets[4];
-   nets[0] = atoi(strtok(tAddr, "."));
-   nets[1] = atoi(strtok(NULL, "."));
-   nets[2] = atoi(strtok(NULL, "."));
-   nets[3] = atoi(strtok(NULL, "."));
-//fprintf(stdout,"0 = %d, 1 = %d, 2 = %d, 3 = %d\n", nets[0], nets[1], nets[2], nets[3]);
+   // sin_addr is already in network byte order, which is the order netNum
+   // wants.  Don't go through inet_ntoa/strtok here, this is also called
+   // from the network thread.
+   const U8 *nets = (const U8 *) &sockAddr->sin_addr.s_addr;
    address->netNum[0] = nets[0];
    address->netNum[1] = nets[1];
    address->netNum[2] = nets[2];
@@ -317,8 +315,16 @@ Net::Error Net::sendtoSocket(NetSocket socket, const U8 *buffer, int bufferSize)
    return e;
 }
 
+static void startNetThread();
+static void stopNetThread();
+static bool netThreadRunning();
+static bool queueNetThreadSend(const NetAddress *address, const U8 *buffer, S32 bufferSize);
+static void processNetThreadReceives();
+
 bool Net::openPort(S32 port)
 {
+   stopNetThread();
+
    if(udpSocket != InvalidSocket)
       close(udpSocket);
    if(ipxSocket != InvalidSocket)
@@ -372,22 +378,25 @@ bool Net::openPort(S32 port)
       }
    }
    netPort = port;
-   return ipxSocket != InvalidSocket || udpSocket != InvalidSocket;
+
+   bool opened = ipxSocket != InvalidSocket || udpSocket != InvalidSocket;
+   if(opened && Con::getBoolVariable("$pref::Net::NetworkThread"))
+      startNetThread();
+   return opened;
 }
 
 void Net::closePort()
 {
+   stopNetThread();
+
    if(ipxSocket != InvalidSocket)
       close(ipxSocket);
    if(udpSocket != InvalidSocket)
       close(udpSocket);
 }
 
-Net::Error Net::sendto(const NetAddress *address, const U8 *buffer, S32 bufferSize)
+static Net::Error sendPacketTo(const NetAddress *address, const U8 *buffer, S32 bufferSize)
 {
-   if(Game->isJournalReading())
-      return NoError;
-
    if(address->type == NetAddress::IPXAddress)
    {
       sockaddr_ipx ipxAddr;
@@ -396,7 +405,7 @@ Net::Error Net::sendto(const NetAddress *address, const U8 *buffer, S32 bufferSi
                   (sockaddr *) &ipxAddr, sizeof(sockaddr_ipx)) == -1)
          return getLastError();
       else
-         return NoError;
+         return Net::NoError;
    }
    else
    {
@@ -406,49 +415,78 @@ Net::Error Net::sendto(const NetAddress *address, const U8 *buffer, S32 bufferSi
                   (sockaddr *) &ipAddr, sizeof(sockaddr_in)) == -1)
          return getLastError();
       else
-         return NoError;
+         return Net::NoError;
    }
 }
 
-void Net::process()
+Net::Error Net::sendto(const NetAddress *address, const U8 *buffer, S32 bufferSize)
+{
+   if(Game->isJournalReading())
+      return NoError;
+
+   if(netThreadRunning() && queueNetThreadSend(address, buffer, bufferSize))
+      return NoError;
+
+   return sendPacketTo(address, buffer, bufferSize);
+}
+
+/// Read one packet from the UDP or IPX socket.
+///
+/// Returns the packet size, 0 if a packet was read but should be ignored, or
+/// -1 if there was nothing to read.  Safe to call from the network thread.
+static S32 receivePacket(NetAddress *address, U8 *buffer)
 {
    sockaddr sa;
+   socklen_t addrLen = sizeof(sa);
+   S32 bytesRead = -1;
+   if(udpSocket != InvalidSocket)
+      bytesRead = recvfrom(udpSocket, (char *) buffer, MaxPacketDataSize, 0, &sa, &addrLen);
+   if(bytesRead == -1 && ipxSocket != InvalidSocket)
+   {
+      addrLen = sizeof(sa);
+      bytesRead = recvfrom(ipxSocket, (char *) buffer, MaxPacketDataSize, 0, &sa, &addrLen);
+   }
+
+   if(bytesRead == -1)
+      return -1;
+
+   if(sa.sa_family == AF_INET)
+      IPSocketToNetAddress((sockaddr_in *) &sa, address);
+   else if(sa.sa_family == AF_IPX)
+      IPXSocketToNetAddress((sockaddr_ipx *) &sa, address);
+   else
+      return 0;
+
+   // ignore our own broadcasts
+   if(address->type == NetAddress::IPAddress &&
+      address->netNum[0] == 127 &&
+      address->netNum[1] == 0 &&
+      address->netNum[2] == 0 &&
+      address->netNum[3] == 1 &&
+      address->port == netPort)
+      return 0;
+   if(bytesRead <= 0)
+      return 0;
+   return bytesRead;
+}
 
+void Net::process()
+{
    PacketReceiveEvent receiveEvent;
-   for(;;)
+   if(netThreadRunning())
+      processNetThreadReceives();
+   else
    {
-      U32 addrLen = sizeof(sa);
-      S32 bytesRead = -1;
-      if(udpSocket != InvalidSocket)
-         bytesRead = recvfrom(udpSocket, (char *) receiveEvent.data, MaxPacketDataSize, 0, &sa, &addrLen);
-      if(bytesRead == -1 && ipxSocket != InvalidSocket)
+      for(;;)
       {
-         addrLen = sizeof(sa);
-         bytesRead = recvfrom(ipxSocket, (char *) receiveEvent.data, MaxPacketDataSize, 0, &sa, &addrLen);
+         S32 bytesRead = receivePacket(&receiveEvent.sourceAddress, receiveEvent.data);
+         if(bytesRead == -1)
+            break;
+         if(bytesRead == 0)
+            continue;
+         receiveEvent.size = PacketReceiveEventHeaderSize + bytesRead;
+         Game->postEvent(receiveEvent);
       }
-      
-      if(bytesRead == -1)
-         break;
-      
-      if(sa.sa_family == AF_INET)
-         IPSocketToNetAddress((sockaddr_in *) &sa, &receiveEvent.sourceAddress);
-      else if(sa.sa_family == AF_IPX)
-         IPXSocketToNetAddress((sockaddr_ipx *) &sa, &receiveEvent.sourceAddress);
-      else
-         continue;
-         
-      NetAddress &na = receiveEvent.sourceAddress;
-      if(na.type == NetAddress::IPAddress &&
-         na.netNum[0] == 127 &&
-         na.netNum[1] == 0 &&
-         na.netNum[2] == 0 &&
-         na.netNum[3] == 1 &&
-         na.port == netPort)
-         continue;
-      if(bytesRead <= 0)
-         continue;
-      receiveEvent.size = PacketReceiveEventHeaderSize + bytesRead;
-      Game->postEvent(receiveEvent);
    }
 
    // process the polled sockets.  This blob of code performs functions
@@ -906,3 +944,334 @@ Net::Error getLastError()
    return Net::UnknownError;
 }
 
+
+//-----------------------------------------------------------------------------
+// Network thread
+//
+// With $pref::Net::NetworkThread set, the UDP/IPX sockets are serviced by a
+// dedicated thread.  It receives and validates incoming packets into a
+// lock-free queue that Net::process() drains into packet events, and sends
+// the buffers that Net::sendto() queued from the main thread.  That keeps
+// socket syscalls off the simulation thread on busy servers.
+//
+// Each queue has exactly one producer and one consumer: the network thread
+// produces receives and consumes sends, the main thread does the opposite.
+
+struct NetThreadPacket
+{
+   NetAddress address;
+   S32 size;
+   U8 data[MaxPacketDataSize];
+};
+
+enum NetThreadConstants
+{
+   NetThreadQueueSize = 256,     ///< Packets per direction, must be a power of two.
+   NetThreadPollTimeout = 250,   ///< ms; only matters for noticing shutdown.
+};
+
+static Thread *gNetThread = NULL;
+static std::atomic<bool> gNetThreadRunning(false);
+static SPSCQueue<NetThreadPacket> *gNetRecvQueue = NULL;
+static SPSCQueue<NetThreadPacket> *gNetSendQueue = NULL;
+static int gNetWakePipe[2] = { -1, -1 };
+static std::atomic<bool> gNetThreadWakePending(false);
+static std::atomic<U32> gNetThreadRecvDropped(0);
+static U32 gNetThreadSendOverflow = 0;
+
+// Written by the network thread when it queues packets while the main
+// thread is blocked in x86UNIXNetWait().
+static int gMainWakePipe[2] = { -1, -1 };
+static std::atomic<bool> gMainWaiting(false);
+
+static void wakeNetThread()
+{
+   char c = 0;
+   if(::write(gNetWakePipe[1], &c, 1) == -1 && errno != EAGAIN)
+      Con::errorf("Net thread: unable to wake - %s", strerror(errno));
+}
+
+static void netThreadSend()
+{
+   while(NetThreadPacket *packet = gNetSendQueue->front())
+   {
+      sendPacketTo(&packet->address, packet->data, packet->size);
+      gNetSendQueue->pop();
+   }
+}
+
+static void netThreadReceive()
+{
+   NetThreadPacket overflow;
+   bool received = false;
+   for(;;)
+   {
+      // if the main thread has fallen behind, keep reading so the socket
+      // buffer doesn't back up, but throw the packets away.
+      NetThreadPacket *packet = gNetRecvQueue->beginPush();
+      if(!packet)
+         packet = &overflow;
+
+      S32 bytesRead = receivePacket(&packet->address, packet->data);
+      if(bytesRead == -1)
+         break;
+      if(bytesRead == 0)
+         continue;
+
+      if(packet == &overflow)
+      {
+         gNetThreadRecvDropped++;
+         continue;
+      }
+      packet->size = bytesRead;
+      gNetRecvQueue->endPush();
+      received = true;
+   }
+
+   if(received && gMainWaiting.exchange(false))
+   {
+      char c = 0;
+      if(::write(gMainWakePipe[1], &c, 1) == -1 && errno != EAGAIN)
+         Con::errorf("Net thread: unable to wake main thread - %s", strerror(errno));
+   }
+}
+
+static void netThreadRun(void *)
+{
+   while(gNetThreadRunning)
+   {
+      pollfd fds[3];
+      S32 count = 0;
+
+      fds[count].fd = gNetWakePipe[0];
+      fds[count++].events = POLLIN;
+      if(udpSocket != InvalidSocket)
+      {
+         fds[count].fd = udpSocket;
+         fds[count++].events = POLLIN;
+      }
+      if(ipxSocket != InvalidSocket)
+      {
+         fds[count].fd = ipxSocket;
+         fds[count++].events = POLLIN;
+      }
+
+      if(poll(fds, count, NetThreadPollTimeout) == -1 && errno != EINTR)
+         break;
+
+      if(fds[0].revents & POLLIN)
+      {
+         char drain[64];
+         while(::read(gNetWakePipe[0], drain, sizeof(drain)) > 0)
+            ;
+      }
+
+      gNetThreadWakePending = false;
+      netThreadSend();
+      netThreadReceive();
+   }
+
+   // flush anything still queued before the sockets go away
+   netThreadSend();
+}
+
+static bool netThreadRunning()
+{
+   return gNetThread != NULL;
+}
+
+static void startNetThread()
+{
+   if(gNetThread)
+      return;
+
+   // journals need the packets to come in on the main thread
+   if(Game->isJournalReading() || Game->isJournalWriting())
+      return;
+
+   if(pipe(gNetWakePipe) == -1)
+   {
+      Con::errorf("Net thread: unable to create wake pipe - %s", strerror(errno));
+      return;
+   }
+   if(pipe(gMainWakePipe) == -1)
+   {
+      Con::errorf("Net thread: unable to create wake pipe - %s", strerror(errno));
+      close(gNetWakePipe[0]);
+      close(gNetWakePipe[1]);
+      gNetWakePipe[0] = gNetWakePipe[1] = -1;
+      return;
+   }
+   fcntl(gNetWakePipe[0], F_SETFL, O_NONBLOCK);
+   fcntl(gNetWakePipe[1], F_SETFL, O_NONBLOCK);
+   fcntl(gMainWakePipe[0], F_SETFL, O_NONBLOCK);
+   fcntl(gMainWakePipe[1], F_SETFL, O_NONBLOCK);
+   gMainWaiting = false;
+
+   gNetRecvQueue = new SPSCQueue<NetThreadPacket>(NetThreadQueueSize);
+   gNetSendQueue = new SPSCQueue<NetThreadPacket>(NetThreadQueueSize);
+   gNetThreadRecvDropped = 0;
+   gNetThreadSendOverflow = 0;
+   gNetThreadWakePending = false;
+
+   gNetThreadRunning = true;
+   gNetThread = new Thread(netThreadRun, NULL, true);
+   Con::printf("Network thread started");
+}
+
+static void stopNetThread()
+{
+   if(!gNetThread)
+      return;
+
+   gNetThreadRunning = false;
+   wakeNetThread();
+   delete gNetThread; // joins
+   gNetThread = NULL;
+
+   // hand over anything the thread received but we never processed
+   processNetThreadReceives();
+
+   delete gNetRecvQueue;
+   delete gNetSendQueue;
+   gNetRecvQueue = NULL;
+   gNetSendQueue = NULL;
+
+   close(gNetWakePipe[0]);
+   close(gNetWakePipe[1]);
+   gNetWakePipe[0] = gNetWakePipe[1] = -1;
+   close(gMainWakePipe[0]);
+   close(gMainWakePipe[1]);
+   gMainWakePipe[0] = gMainWakePipe[1] = -1;
+
+   Con::printf("Network thread stopped (%d packets dropped on receive, %d sends done on main thread)",
+               U32(gNetThreadRecvDropped), gNetThreadSendOverflow);
+}
+
+static bool queueNetThreadSend(const NetAddress *address, const U8 *buffer, S32 bufferSize)
+{
+   if(bufferSize > MaxPacketDataSize)
+      return false;
+
+   NetThreadPacket *packet = gNetSendQueue->beginPush();
+   if(!packet)
+   {
+      gNetThreadSendOverflow++;
+      return false;
+   }
+
+   packet->address = *address;
+   packet->size = bufferSize;
+   dMemcpy(packet->data, buffer, bufferSize);
+   gNetSendQueue->endPush();
+
+   // only one wakeup is needed per drain of the send queue.  The thread
+   // clears the flag before it drains, so a packet pushed while the flag
+   // is still set is guaranteed to be seen by that drain.
+   if(!gNetThreadWakePending.exchange(true))
+      wakeNetThread();
+   return true;
+}
+
+static void processNetThreadReceives()
+{
+   PacketReceiveEvent receiveEvent;
+   while(NetThreadPacket *packet = gNetRecvQueue->front())
+   {
+      receiveEvent.sourceAddress = packet->address;
+      dMemcpy(receiveEvent.data, packet->data, packet->size);
+      receiveEvent.size = PacketReceiveEventHeaderSize + packet->size;
+      gNetRecvQueue->pop();
+
+      Game->postEvent(receiveEvent);
+   }
+}
+
+//-----------------------------------------------------------------------------
+// Idle wait
+//
+// Lets an idle dedicated server sleep until something arrives instead of
+// waking every millisecond to poll.  Anything that shows up on the game
+// port, a polled TCP socket or extraFd ends the wait early.
+
+void x86UNIXNetWait(S32 timeoutMs, int extraFd)
+{
+   static Vector<pollfd> fds(__FILE__, __LINE__);
+   fds.clear();
+
+   pollfd pfd;
+   pfd.revents = 0;
+
+   bool netThread = netThreadRunning();
+   if(netThread)
+   {
+      // Flag that we're waiting before looking at the queue, so a packet
+      // queued in between still gets us woken.
+      gMainWaiting = true;
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if(!gNetRecvQueue->empty())
+      {
+         gMainWaiting = false;
+         return;
+      }
+      pfd.fd = gMainWakePipe[0];
+      pfd.events = POLLIN;
+      fds.push_back(pfd);
+   }
+   else
+   {
+      pfd.events = POLLIN;
+      if(udpSocket != InvalidSocket)
+      {
+         pfd.fd = udpSocket;
+         fds.push_back(pfd);
+      }
+      if(ipxSocket != InvalidSocket)
+      {
+         pfd.fd = ipxSocket;
+         fds.push_back(pfd);
+      }
+   }
+
+   for(S32 i = 0; i < gPolledSockets.size(); i++)
+   {
+      Socket *sock = gPolledSockets[i];
+      switch(sock->state)
+      {
+         case Connected:
+         case Listening:
+            pfd.fd = sock->fd;
+            pfd.events = POLLIN;
+            fds.push_back(pfd);
+            break;
+         case ConnectionPending:
+            pfd.fd = sock->fd;
+            pfd.events = POLLOUT;
+            fds.push_back(pfd);
+            break;
+         default:
+            // name lookups finish on another thread without telling us,
+            // so keep checking on them
+            timeoutMs = getMin(timeoutMs, 10);
+            break;
+      }
+   }
+
+   if(extraFd >= 0)
+   {
+      pfd.fd = extraFd;
+      pfd.events = POLLIN;
+      fds.push_back(pfd);
+   }
+
+   if(poll(fds.address(), fds.size(), timeoutMs) == -1 && errno != EINTR)
+      Con::errorf("x86UNIXNetWait: poll failed - %s", strerror(errno));
+
+   if(netThread)
+   {
+      gMainWaiting = false;
+      char drain[64];
+      while(::read(gMainWakePipe[0], drain, sizeof(drain)) > 0)
+         ;
+   }
+}
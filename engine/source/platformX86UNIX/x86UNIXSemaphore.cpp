@@ -8,6 +8,7 @@
 #include "platformX86UNIX/platformX86UNIX.h"
 #include "platform/platformSemaphore.h"
 #include <fcntl.h>
+#include <errno.h>
 
 #if defined(__linux__)
 #include <semaphore.h>
@@ -18,9 +19,13 @@
 void * Semaphore::createSemaphore(U32 initialCount)
 {
 #if defined(__linux__)
-   sem_t *semaphore;
-   /* hell, I want an elite semaphore, OK?! - rjp */
-   semaphore = sem_open("/tmp/eliteQueue.31337", O_CREAT, 0664, initialCount);
+   // Unnamed, process private semaphore.  Every caller needs its own.
+   sem_t *semaphore = new sem_t;
+   if(sem_init(semaphore, 0, initialCount) != 0)
+   {
+      delete semaphore;
+      return(NULL);
+   }
    return(semaphore);
 #elif defined(__OpenBSD__)
    key_t mykey;
@@ -34,7 +39,8 @@ void Semaphore::destroySemaphore(void * semaphore)
 {
    AssertFatal(semaphore, "Semaphore::destroySemaphore: invalid semaphore");
 #if defined(__linux__)
-   sem_close((sem_t *)semaphore);
+   sem_destroy((sem_t *)semaphore);
+   delete (sem_t *)semaphore;
 #elif defined(__OpenBSD__)
    semctl((*(int *)semaphore), 0, IPC_RMID, 0);
 #endif
@@ -47,7 +53,9 @@ bool Semaphore::acquireSemaphore(void * semaphore, bool block)
    {
       /* must wait */
 #if defined(__linux__)
-      sem_wait((sem_t *)semaphore);
+      while(sem_wait((sem_t *)semaphore) != 0)
+         if(errno != EINTR)
+            return(false);
       return(true);
 #elif defined(__OpenBSD__)
       struct sembuf sem_lock = { 0, -1, IPC_NOWAIT };
@@ -75,7 +83,7 @@ void Semaphore::releaseSemaphore(void * semaphore)
 {
    AssertFatal(semaphore, "Semaphore::releaseSemaphore: invalid semaphore");
 #if defined(__linux__)
-   sem_unlink("/tmp/eliteQueue.31337");
+   sem_post((sem_t *)semaphore);
 #elif defined(__OpenBSD__)
    struct sembuf sem_unlock = { 0, 1, IPC_NOWAIT};
    semop(*(int *)semaphore, &sem_unlock, 1);
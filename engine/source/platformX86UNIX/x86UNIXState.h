@@ -47,6 +47,8 @@ class x86UNIXPlatformState
       bool                 mDedicated;
       bool                 mCDAudioEnabled;
       bool                 mDSleep;
+      bool                 mTickPace;
+      bool                 mIdleWait;
       bool                 mUseRedirect;
 
       // Access to the display* needs to be controlled because the SDL event
@@ -136,6 +138,12 @@ class x86UNIXPlatformState
       bool getDSleep() { return mDSleep; }
       void setDSleep(bool enabled) { mDSleep = enabled; }
 
+      bool getTickPace() { return mTickPace; }
+      void setTickPace(bool enabled) { mTickPace = enabled; }
+
+      bool getIdleWait() { return mIdleWait; }
+      void setIdleWait(bool enabled) { mIdleWait = enabled; }
+
       bool getUseRedirect() { return mUseRedirect; }
       void setUseRedirect(bool enabled) { mUseRedirect = enabled; }
 
@@ -152,6 +160,8 @@ class x86UNIXPlatformState
          mDedicated = false;
          mCDAudioEnabled = false;
          mDSleep = false;
+         mTickPace = false;
+         mIdleWait = true;
 #ifdef USE_FILE_REDIRECT
          mUseRedirect = true;
 #else
@@ -51,6 +51,8 @@ public:
    static void create();
    static void destroy();
    static bool isEnabled();
+   /// Descriptor to watch for typed input, or -1 if none is being read.
+   int getInputFd() { return (stdConsoleEnabled && !inBackground) ? stdIn : -1; }
    void resetTerminal();
 };
 
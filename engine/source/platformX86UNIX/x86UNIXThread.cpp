@@ -69,6 +69,7 @@ void Thread::start()
 
    pthread_t threadID;
    pthread_create(&threadID, NULL, ThreadRunHandler, mData);
+   pthread_detach(threadID);
 }
 
 bool Thread::join()
@@ -76,8 +77,13 @@ bool Thread::join()
    if(!isAlive())
       return(false);
 
+   // Wait for the thread to signal it's done, then put the signal back so
+   // isAlive() and later joins still see it as finished.
    x86UNIXThreadData * threadData = reinterpret_cast<x86UNIXThreadData*>(mData);
-   return(Semaphore::acquireSemaphore(threadData->mSemaphore));
+   if(!Semaphore::acquireSemaphore(threadData->mSemaphore))
+      return(false);
+   Semaphore::releaseSemaphore(threadData->mSemaphore);
+   return(true);
 }
 
 void Thread::run(void* arg)
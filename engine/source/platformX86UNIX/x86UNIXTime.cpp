@@ -14,7 +14,6 @@
 #include <sys/resource.h>
 #include <unistd.h>
 
-U32 x86UNIXGetTickCount();
 //--------------------------------------
 void Platform::getLocalTime(LocalTime &lt)
 {
@@ -44,53 +43,35 @@ U32 Platform::getTime()
 
 U32 Platform::getRealMilliseconds()
 {
-//   struct rusage usageStats;
-//   getrusage(RUSAGE_SELF, &usageStats);
-//   return usageStats.ru_utime.tv_usec;
-   return x86UNIXGetTickCount();
+   return U32(getRealMicroseconds() / 1000);
 }
 
-U32 Platform::getVirtualMilliseconds()
+static U64 x86UNIXMonotonicMicroseconds()
 {
-   return x86UNIXState->currentTime;
+   // Monotonic, so setting the clock or NTP stepping it can't make the game
+   // time jump.
+   timespec t;
+   clock_gettime(CLOCK_MONOTONIC, &t);
+   return U64(t.tv_sec) * 1000000 + t.tv_nsec / 1000;
 }
 
-void Platform::advanceTime(U32 delta)
+U64 Platform::getRealMicroseconds()
 {
-   x86UNIXState->currentTime += delta;
+   // Counted from the first call so the U32 millisecond timer doesn't wrap
+   // for 49 days.
+   static const U64 sStart = x86UNIXMonotonicMicroseconds();
+   return x86UNIXMonotonicMicroseconds() - sStart;
 }
 
-
-
-//------------------------------------------------------------------------------
-//-------------------------------------- x86UNIX Implementation
-//
-//
-static bool   sg_initialized = false;
-static U32 sg_secsOffset  = 0;
-//--------------------------------------
-U32 x86UNIXGetTickCount()
+U32 Platform::getVirtualMilliseconds()
 {
-   // TODO: What happens when crossing a day boundary?
-   //
-   timeval t;
-
-   if (sg_initialized == false) {
-      sg_initialized = true;
-
-      gettimeofday(&t, NULL);
-      sg_secsOffset = t.tv_sec;
-   }
-
-   gettimeofday(&t, NULL);
-
-   U32 secs  = t.tv_sec - sg_secsOffset;
-   U32 uSecs = t.tv_usec;
-
-   // Make granularity 1 ms
-   return (secs * 1000) + (uSecs / 1000);
+   return x86UNIXState->currentTime;
 }
 
+void Platform::advanceTime(U32 delta)
+{
+   x86UNIXState->currentTime += delta;
+}
 
 void Platform::sleep(U32 ms)
 {
@@ -22,6 +22,7 @@
 #include "platform/platformInput.h"
 #include "platform/platformVideo.h"
 #include "platform/profiler.h"
+#include "sim/processList.h"
 #include "platformX86UNIX/platformGL.h"
 #include "platformX86UNIX/x86UNIXOGLVideo.h"
 #include "platformX86UNIX/x86UNIXState.h"
@@ -35,7 +36,7 @@
 #include <signal.h>
 #include <stdlib.h>
 #include <unistd.h> // fork, execvp, chdir
-#include <time.h> // nanosleep
+#include <time.h> // nanosleep, clock_nanosleep
 
 #ifndef DEDICATED
 #include <X11/Xlib.h>
@@ -96,6 +97,16 @@ static S32 ParseCommandLine(S32 argc, const char **argv,
          x86UNIXState->setDSleep(true);
          continue;
       }
+      if (dStrcmp(argv[i], "-tickpace") == 0)
+      {
+         x86UNIXState->setTickPace(true);
+         continue;
+      }
+      if (dStrcmp(argv[i], "-noidlewait") == 0)
+      {
+         x86UNIXState->setIdleWait(false);
+         continue;
+      }
       if (dStrcmp(argv[i], "-nohomedir") == 0)
       {
          x86UNIXState->setUseRedirect(false);
@@ -412,6 +423,153 @@ static inline void Sleep(int secs, int nanoSecs)
    nanosleep(&sleeptime, NULL);
 }
 
+//------------------------------------------------------------------------------
+// Dedicated server tick pacing (-tickpace).  Instead of polling with short
+// sleeps, the server sleeps until the next tick boundary.  The deadlines
+// are absolute and step by exactly one tick, so a late wake doesn't push
+// the following ones back and the ticks don't drift.
+//
+// How late each wake is gets logged, since uneven ticks on the server are
+// what players see as rubber banding.
+namespace
+{
+   const S64 PaceTickNs = S64(TickMs) * 1000000;
+   const U32 JitterReportTicks = 60 * 1000 / TickMs;
+
+   struct TickJitterStats
+   {
+      U32 ticks;
+      U32 missed;     ///< Tick boundaries skipped because a frame overran
+      U32 slips;      ///< Wakes more than a millisecond late
+      S64 minLateUs;
+      S64 maxLateUs;
+      F64 sumLateUs;
+      F64 sumSqLateUs;
+
+      void reset()
+      {
+         ticks = missed = slips = 0;
+         minLateUs = maxLateUs = 0;
+         sumLateUs = sumSqLateUs = 0;
+      }
+
+      void add(S64 lateUs)
+      {
+         if (!ticks || lateUs < minLateUs)
+            minLateUs = lateUs;
+         if (!ticks || lateUs > maxLateUs)
+            maxLateUs = lateUs;
+         if (lateUs > 1000)
+            slips++;
+         sumLateUs += lateUs;
+         sumSqLateUs += F64(lateUs) * lateUs;
+         ticks++;
+      }
+
+      void report()
+      {
+         if (!ticks)
+         {
+            Con::printf("Tick pacing: no ticks paced yet.");
+            return;
+         }
+
+         F64 mean = sumLateUs / ticks;
+         F64 var = sumSqLateUs / ticks - mean * mean;
+         Con::printf("Tick pacing: %u ticks, wake late by %.3fms avg, %.3fms std dev, %.3f..%.3fms, "
+            "%u over 1ms, %u ticks missed",
+            ticks, mean / 1000.0, mSqrt(var > 0 ? var : 0) / 1000.0,
+            F64(minLateUs) / 1000.0, F64(maxLateUs) / 1000.0, slips, missed);
+      }
+   };
+
+   TickJitterStats sgTickJitter;
+   timespec sgNextTick;
+   bool sgTickPaceStarted = false;
+
+   inline S64 toNs(const timespec& t)
+   {
+      return S64(t.tv_sec) * 1000000000 + t.tv_nsec;
+   }
+
+   inline timespec fromNs(S64 ns)
+   {
+      timespec t;
+      t.tv_sec = ns / 1000000000;
+      t.tv_nsec = ns % 1000000000;
+      return t;
+   }
+}
+
+static void WaitForNextTick()
+{
+   timespec now;
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   S64 nowNs = toNs(now);
+
+   if (!sgTickPaceStarted)
+   {
+      sgTickPaceStarted = true;
+      sgTickJitter.reset();
+      sgNextTick = now;
+   }
+
+   // Step to the next boundary still ahead.  Any skipped were missed
+   // because the last frame took longer than a tick.
+   S64 deadline = toNs(sgNextTick) + PaceTickNs;
+   while (deadline <= nowNs)
+   {
+      deadline += PaceTickNs;
+      sgTickJitter.missed++;
+   }
+   sgNextTick = fromNs(deadline);
+
+   while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &sgNextTick, NULL) == EINTR)
+      ;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   sgTickJitter.add((toNs(now) - deadline) / 1000);
+
+   if (sgTickJitter.ticks >= JitterReportTicks)
+   {
+      sgTickJitter.report();
+      sgTickJitter.reset();
+   }
+}
+
+//------------------------------------------------------------------------------
+// Without a window, wait for a packet, console input or the next thing the
+// game has scheduled, rather than polling.  -noidlewait turns this off.
+static void WaitForGameWork()
+{
+   // Game time events are clamped to a second, don't wait much longer.
+   const S32 MaxIdleWaitMs = 1000;
+
+   S32 timeout = Game->getIdleTimeout();
+   if (timeout == 0)
+      return;
+   if (timeout < 0 || timeout > MaxIdleWaitMs)
+      timeout = MaxIdleWaitMs;
+
+   // The timeout counts from the last time event.  TimeManager::process()
+   // doesn't post one until more than 5ms have passed, so waking any
+   // sooner would only spin.
+   S32 sinceTime = Platform::getRealMilliseconds() - lastTimeTick;
+   timeout = getMax(timeout - sinceTime, 6 - sinceTime);
+   if (timeout <= 0)
+      return;
+
+   x86UNIXNetWait(timeout, stdConsole ? stdConsole->getInputFd() : -1);
+}
+
+ConsoleFunction(dumpTickJitter, void, 1, 1, "dumpTickJitter()\n"
+   "Print how evenly the dedicated server has woken for ticks since the last report.")
+{
+   if (!x86UNIXState->getTickPace())
+      Con::printf("Tick pacing is off, start the dedicated server with -tickpace.");
+   sgTickJitter.report();
+}
+
 #ifndef DEDICATED
 struct AlertWinState
 {
@@ -671,7 +829,21 @@ void Platform::process()
       // there are no players connected.
       // JMQ: recent kernels (such as RH 8.0 2.4.18) reduce the latency
       // to 2-4 ms on average.
-      if (!Game->isJournalReading() && (x86UNIXState->getDSleep() ||
+      // With -tickpace the server instead sleeps until the next tick, and
+      // by default it sleeps until there's something to do.
+      if (!Game->isJournalReading() && x86UNIXState->getTickPace())
+      {
+         PROFILE_START(XUX_TickPace);
+         WaitForNextTick();
+         PROFILE_END();
+      }
+      else if (!Game->isJournalReading() && x86UNIXState->getIdleWait())
+      {
+         PROFILE_START(XUX_IdleWait);
+         WaitForGameWork();
+         PROFILE_END();
+      }
+      else if (!Game->isJournalReading() && (x86UNIXState->getDSleep() ||
              Con::getIntVariable("Server::PlayerCount") -
              Con::getIntVariable("Server::BotCount") <= 0))
       {
@@ -824,20 +996,25 @@ void Platform::init()
    if (x86UNIXState->isDedicated())
    {
       const S32 MaxSleepIter = 10;
-      U32 totalSleepTime = 0;
-      U32 start;
+      U64 totalSleepTime = 0;
+      U64 start;
       for (S32 i = 0; i < MaxSleepIter; ++i)
       {
-         start = Platform::getRealMilliseconds();
+         start = Platform::getRealMicroseconds();
          Sleep(0, 1000000);
-         totalSleepTime += Platform::getRealMilliseconds() - start;
+         totalSleepTime += Platform::getRealMicroseconds() - start;
       }
-      U32 average = static_cast<U32>(totalSleepTime / MaxSleepIter);
+      F32 average = F32(totalSleepTime) / MaxSleepIter / 1000.0f;
 
-      Con::printf("Sleep latency: %ums", average);
+      Con::printf("Sleep latency: %.3fms", average);
       // dPrintf as well, since console output won't be visible yet
-      dPrintf("Sleep latency: %ums\n", average);
-      if (!x86UNIXState->getDSleep() && average < 10)
+      dPrintf("Sleep latency: %.3fms\n", average);
+      if (x86UNIXState->getTickPace())
+      {
+         Con::printf("Pacing the server to %dms ticks", TickMs);
+         dPrintf("Pacing the server to %dms ticks\n", TickMs);
+      }
+      else if (!x86UNIXState->getDSleep() && average < 10)
       {
          const char* msg = "Sleep latency ok, enabling dsleep for lower cpu " \
             "utilization";
@@ -305,6 +305,8 @@ void RenderInstManager::sort()
 {
     PROFILE_START(RIM_sort);
 
+    mPreSortSignal.trigger();
+
     if (mRenderBins.size())
     {
         for (U32 i = 0; i < NumRenderBins; i++)
@@ -371,6 +373,34 @@ MatInstance *RenderInstManager::getWarningMat()
     return mWarningMat;
 }
 
+//-----------------------------------------------------------------------------
+// Names the bins in debug events, for PIX and the Null device's counts.
+//-----------------------------------------------------------------------------
+static const char* getRenderBinName(U32 bin)
+{
+    switch (bin)
+    {
+    case RenderInstManager::Begin:                   return "Begin";
+    case RenderInstManager::Sky:                     return "Sky";
+    case RenderInstManager::SkyShape:                return "SkyShape";
+    case RenderInstManager::Interior:                return "Interior";
+    case RenderInstManager::InteriorDynamicLighting: return "InteriorDynamicLighting";
+    case RenderInstManager::Mesh:                    return "Mesh";
+    case RenderInstManager::MarbleShadow:            return "MarbleShadow";
+    case RenderInstManager::Marble:                  return "Marble";
+    case RenderInstManager::MiscObject:              return "MiscObject";
+    case RenderInstManager::Shadow:                  return "Shadow";
+    case RenderInstManager::Decal:                   return "Decal";
+    case RenderInstManager::Water:                   return "Water";
+    case RenderInstManager::TranslucentPreGlow:      return "TranslucentPreGlow";
+    case RenderInstManager::Glow:                    return "Glow";
+    case RenderInstManager::Refraction:              return "Refraction";
+    case RenderInstManager::Foliage:                 return "Foliage";
+    case RenderInstManager::Translucent:             return "Translucent";
+    default:                                         return "Unknown";
+    }
+}
+
 //-----------------------------------------------------------------------------
 // render
 //-----------------------------------------------------------------------------
@@ -385,7 +415,10 @@ void RenderInstManager::render()
         {
             if (mRenderBins[i] && mRenderRenderBin[i])
             {
+                GFXDebugMarker marker(ColorF(1.0f, 1.0f, 1.0f), getRenderBinName(i));
+                marker.enter();
                 mRenderBins[i]->render();
+                marker.leave();
             }
         }
     }
@@ -398,7 +431,11 @@ void RenderInstManager::renderToZBuff(GFXTarget* target)
 {
     GFX->pushActiveRenderTarget();
     GFX->setActiveRenderTarget(target);
+
+    GFXDebugMarker marker(ColorF(1.0f, 1.0f, 1.0f), "ZOnly");
+    marker.enter();
     mZOnlyBin->render();
+    marker.leave();
     GFX->popActiveRenderTarget();
 }
 
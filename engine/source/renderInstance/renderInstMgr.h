@@ -37,7 +37,7 @@ struct RenderInst
     GFXPrimitive* prim;
 
     U32 primBuffIndex;
-    //U32 primStartIndex;
+    U32 primStartIndex;   // particles: first index in the shared particle index buffer
     //U32 primCount;
     MatInstance* matInst;
 
@@ -175,6 +175,8 @@ private:
     Point3F mCamPos;
     RenderZOnlyMgr* mZOnlyBin;
 
+    Signal<> mPreSortSignal;
+
     void handleGFXEvent(GFXDevice::GFXDeviceEventType event);
     void initBins();
     void uninitBins();
@@ -197,6 +199,11 @@ public:
         return inst;
     }
     void addInst(RenderInst* inst);
+
+    /// Triggered by sort(), once all the instances for a pass have been
+    /// added.  For systems that queue work in prepRenderImage and finish
+    /// it in one go.
+    Signal<>& getPreSortSignal() { return mPreSortSignal; }
     MatrixF* allocXform() { return mXformAllocator.alloc(); }
 
     // for lighting...
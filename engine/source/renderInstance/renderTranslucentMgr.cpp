@@ -134,6 +134,10 @@ void RenderTranslucentMgr::render()
         // handle particles
         if (ri->particles)
         {
+            // emitters that didn't fit in the shared buffers this pass
+            if (ri->primBuffIndex == 0)
+                continue;
+
             GFX->setCullMode(GFXCullNone);
             GFX->setTextureStageColorOp(0, GFXTOPModulate);
             GFX->setTextureStageColorOp(1, GFXTOPDisable);
@@ -156,7 +160,7 @@ void RenderTranslucentMgr::render()
             GFX->setVertexBuffer(*ri->vertBuff);
             GFX->disableShaders();
             GFX->setupGenericShaders(GFXDevice::GSModColorTexture);
-            GFX->drawIndexedPrimitive(GFXTriangleList, 0, ri->primBuffIndex * 4, 0, ri->primBuffIndex * 2);
+            GFX->drawIndexedPrimitive(GFXTriangleList, ri->primStartIndex / 6 * 4, ri->primBuffIndex * 4, ri->primStartIndex, ri->primBuffIndex * 2);
 
             GFX->popWorldMatrix();
 
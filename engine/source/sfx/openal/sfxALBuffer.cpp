@@ -38,6 +38,15 @@ SFXALBuffer::~SFXALBuffer()
 {
 }
 
+ALenum SFXALBuffer::_getFormat() const
+{
+   // Stereo 16 == 32 bits per sample, 16 per channel
+   if( mResource->getChannels() > 1 )
+      return mResource->getSampleBits() == 32 ? AL_FORMAT_STEREO16 : AL_FORMAT_STEREO8;
+   else
+      return mResource->getSampleBits() == 16 ? AL_FORMAT_MONO16 : AL_FORMAT_MONO8;
+}
+
 bool SFXALBuffer::createVoice(   ALuint *bufferName,
                                  ALuint *sourceName,
                                  ALenum *bufferFormat ) const
@@ -48,11 +57,7 @@ bool SFXALBuffer::createVoice(   ALuint *bufferName,
    AssertFatal( mOpenAL.alIsBuffer( *bufferName ), "AL Buffer Sanity Check Failed!" ); \
    AssertFatal( mOpenAL.alIsSource( *sourceName ), "AL Source Sanity Check Failed!" );
 
-   // Stereo 16 == 32 bits per sample, 16 per channel
-   if( mResource->getChannels() > 1 )
-      *bufferFormat = mResource->getSampleBits() == 32 ? AL_FORMAT_STEREO16 : AL_FORMAT_STEREO8;
-   else
-      *bufferFormat = mResource->getSampleBits() == 16 ? AL_FORMAT_MONO16 : AL_FORMAT_MONO8;
+   *bufferFormat = _getFormat();
 
    // Is this 3d?
    mOpenAL.alSourcei( *sourceName, AL_SOURCE_RELATIVE, ( mIs3d ? AL_FALSE : AL_TRUE ) );
@@ -73,3 +78,23 @@ bool SFXALBuffer::createVoice(   ALuint *bufferName,
 
    return ( err == AL_NO_ERROR );
 }
+
+bool SFXALBuffer::createStreamVoice(   U32 numBuffers,
+                                       ALuint *bufferNames,
+                                       ALuint *sourceName,
+                                       ALenum *bufferFormat ) const
+{
+   mOpenAL.alGetError();
+   mOpenAL.alGenBuffers( numBuffers, bufferNames );
+   mOpenAL.alGenSources( 1, sourceName );
+
+   *bufferFormat = _getFormat();
+
+   // Is this 3d?
+   mOpenAL.alSourcei( *sourceName, AL_SOURCE_RELATIVE, ( mIs3d ? AL_FALSE : AL_TRUE ) );
+
+   // The stream does the looping.
+   mOpenAL.alSourcei( *sourceName, AL_LOOPING, AL_FALSE );
+
+   return ( mOpenAL.alGetError() == AL_NO_ERROR );
+}
@@ -43,6 +43,9 @@ class SFXALBuffer : public SFXBuffer
 
       const OPENALFNTABLE &mOpenAL;
 
+      /// Returns the AL format matching the resource.
+      ALenum _getFormat() const;
+
    public:
 
       static SFXALBuffer* create(   const OPENALFNTABLE &oalft, 
@@ -56,6 +59,21 @@ class SFXALBuffer : public SFXBuffer
                         ALuint *sourceName,
                         ALenum *bufferFormat ) const;
 
+      /// Creates a source and a set of empty buffers which
+      /// are filled and queued as the resource streams.
+      bool createStreamVoice( U32 numBuffers,
+                              ALuint *bufferNames,
+                              ALuint *sourceName,
+                              ALenum *bufferFormat ) const;
+
+      /// Returns true if voices for this buffer should stream.
+      bool isStreaming() const { return mResource->isStreaming(); }
+
+      /// Returns a new stream over the resource data.
+      SFXStream* openStream() const { return mResource->openStream(); }
+
+      U32 getFrequency() const { return mResource->getFrequency(); }
+
 };
 
 
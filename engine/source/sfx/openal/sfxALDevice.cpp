@@ -132,6 +132,8 @@ void SFXALDevice::update( const SFXListener& listener )
    {
       if (mVoices[i]->is3D())
          mVoices[i]->setVelocity(velocity);
+
+      mVoices[i]->update();
    }
 
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 
 #include "sfx/openal/sfxALBuffer.h"
 #include "sfx/openal/sfxALDevice.h"
+#include "sfx/sfxStream.h"
 
 #ifdef TORQUE_DEBUG
 #  define AL_SANITY_CHECK() \
@@ -20,6 +21,39 @@
 SFXALVoice* SFXALVoice::create( SFXALBuffer *buffer )
 {
    AssertFatal( buffer, "SFXALVoice::create() - Got null buffer!" );
+
+   if ( buffer->isStreaming() )
+   {
+      ALuint bufferNames[ NumStreamBuffers ];
+      ALuint sourceName;
+      ALenum bufferFormat;
+
+      if ( !buffer->createStreamVoice( NumStreamBuffers,
+                                       bufferNames,
+                                       &sourceName,
+                                       &bufferFormat ) )
+         return NULL;
+
+      SFXALVoice *voice = new SFXALVoice( buffer->mOpenAL,
+                                          buffer,
+                                          bufferNames[0],
+                                          sourceName );
+
+      voice->mStream = buffer->openStream();
+      voice->mBufferFormat = bufferFormat;
+      voice->mFrequency = buffer->getFrequency();
+      for ( U32 i=0; i < NumStreamBuffers; i++ )
+         voice->mStreamBuffers[i] = voice->mFreeBuffers[i] = bufferNames[i];
+      voice->mNumFreeBuffers = NumStreamBuffers;
+
+      if ( !voice->mStream )
+      {
+         delete voice;
+         return NULL;
+      }
+
+      return voice;
+   }
  
    ALuint bufferName;
    ALuint sourceName;
@@ -48,7 +82,14 @@ SFXALVoice::SFXALVoice( const OPENALFNTABLE &oalft,
       mIsPlaying( false ), 
       mBufferName( bufferName ), 
       mSourceName( sourceName ),
-      mIs3D(buffer->mIs3d)
+      mIs3D(buffer->mIs3d),
+      mStream( NULL ),
+      mNumFreeBuffers( 0 ),
+      mBufferFormat( 0 ),
+      mFrequency( 0 ),
+      mStreamStart( 0 ),
+      mIsPaused( false ),
+      mIsLooping( false )
 {
    AL_SANITY_CHECK();
 }
@@ -56,12 +97,33 @@ SFXALVoice::SFXALVoice( const OPENALFNTABLE &oalft,
 SFXALVoice::~SFXALVoice()
 {
    mOpenAL.alDeleteSources( 1, &mSourceName );
-   mOpenAL.alDeleteBuffers( 1, &mBufferName );
+
+   if ( mStream )
+   {
+      delete mStream;
+      mOpenAL.alDeleteBuffers( NumStreamBuffers, mStreamBuffers );
+   }
+   else
+      mOpenAL.alDeleteBuffers( 1, &mBufferName );
 }
 
 void SFXALVoice::setPosition( U32 pos )
 {
    AL_SANITY_CHECK();
+
+   if ( mStream )
+   {
+      mStreamStart = pos;
+
+      // Restart a playing stream right away.
+      if ( mIsPlaying )
+      {
+         mIsPlaying = false;
+         play( mIsLooping );
+      }
+      return;
+   }
+
    mOpenAL.alSourcei( mSourceName, AL_SAMPLE_OFFSET, pos );
 }
 
@@ -77,6 +139,23 @@ SFXStatus SFXALVoice::getStatus() const
 {
    AL_SANITY_CHECK();
 
+   if ( mStream )
+   {
+      if ( mIsPaused )
+         return SFXStatusPaused;
+      if ( !mIsPlaying )
+         return SFXStatusStopped;
+
+      // The source stops by itself if the decoder falls
+      // behind, update() starts it again.
+      ALint state;
+      mOpenAL.alGetSourcei( mSourceName, AL_SOURCE_STATE, &state );
+      if ( state == AL_PLAYING || !mStream->isFinished() )
+         return SFXStatusPlaying;
+
+      return SFXStatusStopped;
+   }
+
    ALint state;
    mOpenAL.alGetSourcei( mSourceName, AL_SOURCE_STATE, &state );
    
@@ -93,6 +172,24 @@ void SFXALVoice::play( bool looping )
 {
    AL_SANITY_CHECK();
 
+   if ( mStream )
+   {
+      // A paused stream picks up where it left off.
+      if ( !mIsPaused )
+      {
+         _unqueueAll();
+         mStream->start( mStreamStart, looping );
+         mStreamStart = 0;
+         _queueStream();
+      }
+
+      mIsPlaying = true;
+      mIsPaused = false;
+      mIsLooping = looping;
+      mOpenAL.alSourcePlay( mSourceName );
+      return;
+   }
+
    mOpenAL.alSourceStop( mSourceName );
    mOpenAL.alSourcei( mSourceName, AL_LOOPING, ( looping ? AL_TRUE : AL_FALSE ) );
    mOpenAL.alSourcePlay( mSourceName );
@@ -117,6 +214,13 @@ void SFXALVoice::pause()
 
    mOpenAL.alSourcePause( mSourceName );
 
+   if ( mStream )
+   {
+      mIsPlaying = false;
+      mIsPaused = true;
+      return;
+   }
+
    //WORKAROUND: Another workaround for the buggy OAL.  Resuming playback of a paused source will cause the 
    // play cursor to jump.  Save the cursor so we can manually move it into position in _play().  Sigh.
 
@@ -127,6 +231,15 @@ void SFXALVoice::stop()
 {
    AL_SANITY_CHECK();
 
+   if ( mStream )
+   {
+      _unqueueAll();
+      mStream->stop();
+      mIsPlaying = false;
+      mIsPaused = false;
+      return;
+   }
+
    mOpenAL.alSourceStop( mSourceName );
    
    mResumeAtSampleOffset = -1.0f;
@@ -164,3 +277,64 @@ void SFXALVoice::setPitch( F32 pitch )
    mOpenAL.alSourcef( mSourceName, AL_PITCH, pitch );
 }
 
+void SFXALVoice::update()
+{
+   if ( !mStream || !mIsPlaying )
+      return;
+
+   // Take back the buffers the source is done with.
+   ALint processed = 0;
+   mOpenAL.alGetSourcei( mSourceName, AL_BUFFERS_PROCESSED, &processed );
+   while ( processed-- > 0 )
+   {
+      ALuint buffer;
+      mOpenAL.alSourceUnqueueBuffers( mSourceName, 1, &buffer );
+      mFreeBuffers[ mNumFreeBuffers++ ] = buffer;
+   }
+
+   _queueStream();
+
+   ALint state;
+   mOpenAL.alGetSourcei( mSourceName, AL_SOURCE_STATE, &state );
+   if ( state == AL_PLAYING )
+      return;
+
+   // Either the source ran dry and we have more
+   // for it now, or the stream is done.
+   if ( mNumFreeBuffers < NumStreamBuffers )
+      mOpenAL.alSourcePlay( mSourceName );
+   else if ( mStream->isFinished() )
+   {
+      mIsPlaying = false;
+      mStream->stop();
+   }
+}
+
+void SFXALVoice::_queueStream()
+{
+   // Only the main thread feeds voices.
+   static U8 sData[ SFXStream::ChunkSize ];
+
+   while ( mNumFreeBuffers > 0 )
+   {
+      U32 bytes = mStream->read( sData, sizeof( sData ) );
+      if ( bytes == 0 )
+         break;
+
+      ALuint buffer = mFreeBuffers[ --mNumFreeBuffers ];
+      mOpenAL.alBufferData( buffer, mBufferFormat, sData, bytes, mFrequency );
+      mOpenAL.alSourceQueueBuffers( mSourceName, 1, &buffer );
+   }
+}
+
+void SFXALVoice::_unqueueAll()
+{
+   // Detaching the buffer from a stopped
+   // source empties its queue.
+   mOpenAL.alSourceStop( mSourceName );
+   mOpenAL.alSourcei( mSourceName, AL_BUFFER, 0 );
+
+   for ( U32 i=0; i < NumStreamBuffers; i++ )
+      mFreeBuffers[i] = mStreamBuffers[i];
+   mNumFreeBuffers = NumStreamBuffers;
+}
@@ -15,6 +15,7 @@
 #endif
 
 class SFXALBuffer;
+class SFXStream;
 
 
 class SFXALVoice : public SFXVoice
@@ -23,6 +24,12 @@ class SFXALVoice : public SFXVoice
 
    protected:
 
+      enum Constants
+      {
+         /// The number of AL buffers queued on a streaming voice.
+         NumStreamBuffers = 3,
+      };
+
       SFXALVoice( const OPENALFNTABLE &oalft,
                   SFXALBuffer *buffer, 
                   ALuint bufferName,
@@ -41,6 +48,39 @@ class SFXALVoice : public SFXVoice
 
       const OPENALFNTABLE &mOpenAL;
 
+      /// @name Streaming
+      /// Voices for streaming resources decode as they play
+      /// and feed a small queue of AL buffers from update().
+      /// @{
+
+      /// The stream or NULL if the whole sound is in mBufferName.
+      SFXStream *mStream;
+
+      ALuint mStreamBuffers[ NumStreamBuffers ];
+
+      /// The stream buffers not currently queued on the source.
+      ALuint mFreeBuffers[ NumStreamBuffers ];
+      U32 mNumFreeBuffers;
+
+      ALenum mBufferFormat;
+
+      U32 mFrequency;
+
+      /// The byte offset the next play() starts the stream at.
+      U32 mStreamStart;
+
+      bool mIsPaused;
+
+      bool mIsLooping;
+
+      /// Fills and queues free buffers from the stream.
+      void _queueStream();
+
+      /// Stops the source and takes back all its buffers.
+      void _unqueueAll();
+
+      /// @}
+
    public:
 
       static SFXALVoice* create( SFXALBuffer *buffer );
@@ -68,6 +108,10 @@ class SFXALVoice : public SFXVoice
       void setPitch( F32 pitch );
 
       bool is3D() { return mIs3D; }
+
+      /// Keeps streaming voices fed.  Called from
+      /// SFXALDevice::update() every frame.
+      void update();
 };
 
 
@@ -125,6 +125,14 @@ SFXResource::~SFXResource()
    delete [] mData;
 }
 
+const U8* SFXResource::getData() const
+{
+   if ( !mData && isStreaming() )
+      _decodeAll();
+
+   return mData;
+}
+
 U32 SFXResource::getChannels() const
 {
    switch( mFormat )
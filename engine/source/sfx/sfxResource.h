@@ -11,6 +11,8 @@
 #include "core/resManager.h"
 #endif
 
+class SFXStream;
+
 
 /// The various types of sound data that may be
 /// returned from SFXResource::getData().
@@ -55,8 +57,9 @@ class SFXResource : public ResourceInstance
       /// The format of the sample data.
       SFXFormat mFormat;
 
-      /// The loaded sample data.
-      U8* mData;
+      /// The loaded sample data.  For streaming resources
+      /// this is only filled in if a device asks for it.
+      mutable U8* mData;
 
       /// The length of the mData array in bytes.
       U32 mSize;
@@ -67,6 +70,10 @@ class SFXResource : public ResourceInstance
       /// The length of the sample in milliseconds.
       U32 mLength;
 
+      /// Called by getData() for streaming resources to
+      /// decode all of the sample data into mData.
+      virtual void _decodeAll() const {}
+
    public:
 
       /// This is a helper function used by SFXProfile for load
@@ -84,8 +91,19 @@ class SFXResource : public ResourceInstance
       ///
       static bool exists( const char* filename );
 
-      /// Returns the sample data array.
-      const U8* getData() const { return mData; }
+      /// Returns the sample data array.  For streaming resources
+      /// this decodes the whole sound on the first call, so devices
+      /// that can stream should use openStream() instead.
+      const U8* getData() const;
+
+      /// Returns true if the sample data is decoded on demand
+      /// rather than held in memory.
+      virtual bool isStreaming() const { return false; }
+
+      /// Returns a new stream over the sample data which the
+      /// caller must delete, or NULL if the resource doesn't
+      /// support streaming.
+      virtual SFXStream* openStream() const { return NULL; }
 
       /// The length of the data buffer in bytes.
       U32 getSize() const { return mSize; }
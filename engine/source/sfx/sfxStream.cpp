@@ -0,0 +1,193 @@
+//-----------------------------------------------------------------------------
+// Torque Game Engine Advanced
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "sfx/sfxStream.h"
+
+#include "platform/platformMutex.h"
+#include "platform/platformThread.h"
+
+
+Vector<SFXStream*> SFXStream::smStreams( __FILE__, __LINE__ );
+void* SFXStream::smMutex = NULL;
+Thread* SFXStream::smThread = NULL;
+std::atomic<bool> SFXStream::smShutdown( false );
+
+
+SFXStream::SFXStream()
+   :  mChunks( NumChunks ),
+      mReadOffset( 0 ),
+      mFinished( false ),
+      mLooping( false ),
+      mEndOfStream( false ),
+      mDecoding( false )
+{
+}
+
+SFXStream::~SFXStream()
+{
+   AssertFatal( !mDecoding, "SFXStream::~SFXStream() - The derived class didn't stop the stream!" );
+}
+
+void SFXStream::start( U32 pos, bool looping )
+{
+   // The decode thread is started with the first stream.
+   if ( !smThread )
+   {
+      smMutex = Mutex::createMutex();
+      smShutdown = false;
+      smThread = new Thread( _decodeThread, NULL, true );
+   }
+
+   Mutex::lockMutex( smMutex );
+
+   // With the decode thread locked out we can
+   // throw away whatever it had buffered.
+   while ( mChunks.front() )
+      mChunks.pop();
+   mReadOffset = 0;
+   mFinished = false;
+
+   mLooping = looping;
+   mEndOfStream = !decoderSeek( pos );
+   if ( mEndOfStream )
+      mFinished = true;
+
+   // Have something ready for the first read so
+   // playback doesn't wait on the decode thread.
+   _fill();
+
+   if ( !mDecoding )
+   {
+      smStreams.push_back( this );
+      mDecoding = true;
+   }
+
+   Mutex::unlockMutex( smMutex );
+}
+
+void SFXStream::stop()
+{
+   if ( !mDecoding )
+      return;
+
+   Mutex::lockMutex( smMutex );
+
+   for ( U32 i=0; i < smStreams.size(); i++ )
+   {
+      if ( smStreams[i] == this )
+      {
+         smStreams.erase_fast( i );
+         break;
+      }
+   }
+   mDecoding = false;
+
+   Mutex::unlockMutex( smMutex );
+}
+
+U32 SFXStream::read( U8 *buffer, U32 length )
+{
+   U32 copied = 0;
+
+   while ( copied < length )
+   {
+      Chunk *chunk = mChunks.front();
+      if ( !chunk )
+         break;
+
+      U32 bytes = getMin( chunk->size - mReadOffset, length - copied );
+      dMemcpy( buffer + copied, chunk->data + mReadOffset, bytes );
+      copied += bytes;
+      mReadOffset += bytes;
+
+      if ( mReadOffset == chunk->size )
+      {
+         if ( chunk->last )
+            mFinished = true;
+
+         mReadOffset = 0;
+         mChunks.pop();
+      }
+   }
+
+   return copied;
+}
+
+bool SFXStream::_fill()
+{
+   if ( mEndOfStream )
+      return false;
+
+   Chunk *chunk = mChunks.beginPush();
+   if ( !chunk )
+      return false;
+
+   chunk->size = 0;
+   chunk->last = false;
+
+   bool wrapped = false;
+   while ( chunk->size < ChunkSize )
+   {
+      U32 bytes = decode( chunk->data + chunk->size, ChunkSize - chunk->size );
+      if ( bytes > 0 )
+      {
+         chunk->size += bytes;
+         wrapped = false;
+         continue;
+      }
+
+      // Looping streams go back to the start, but don't
+      // spin forever on a stream with nothing in it.
+      if ( mLooping && !wrapped && decoderSeek( 0 ) )
+      {
+         wrapped = true;
+         continue;
+      }
+
+      chunk->last = true;
+      mEndOfStream = true;
+      break;
+   }
+
+   mChunks.endPush();
+   return true;
+}
+
+void SFXStream::_decodeThread( void *arg )
+{
+   while ( !smShutdown )
+   {
+      // Round robin one chunk per stream so that
+      // one stream can't starve the others.
+      bool busy = false;
+
+      Mutex::lockMutex( smMutex );
+      for ( U32 i=0; i < smStreams.size(); i++ )
+         busy |= smStreams[i]->_fill();
+      Mutex::unlockMutex( smMutex );
+
+      if ( !busy )
+         Platform::sleep( 10 );
+   }
+}
+
+void SFXStream::shutdown()
+{
+   if ( !smThread )
+      return;
+
+   // The thread's destructor waits for it to exit.
+   smShutdown = true;
+   delete smThread;
+   smThread = NULL;
+
+   Mutex::destroyMutex( smMutex );
+   smMutex = NULL;
+
+   for ( U32 i=0; i < smStreams.size(); i++ )
+      smStreams[i]->mDecoding = false;
+   smStreams.clear();
+}
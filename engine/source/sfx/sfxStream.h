@@ -0,0 +1,133 @@
+//-----------------------------------------------------------------------------
+// Torque Game Engine Advanced
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#ifndef _SFXSTREAM_H_
+#define _SFXSTREAM_H_
+
+#ifndef _PLATFORM_H_
+#include "platform/platform.h"
+#endif
+#ifndef _TVECTOR_H_
+#include "core/tVector.h"
+#endif
+#ifndef _TSPSCQUEUE_H_
+#include "core/tSPSCQueue.h"
+#endif
+
+class Thread;
+
+
+/// A source of sample data which is decoded a little at a
+/// time instead of all at once at load.
+///
+/// Decoding happens on a single background thread shared by
+/// all streams.  Each stream keeps a small ring of decoded
+/// chunks which the decode thread tops up and the sound device
+/// drains with read() as it feeds its voice.  Only the thread
+/// which started the stream may read from it.
+///
+/// Derived classes implement decode() and decoderSeek() and
+/// must call stop() from their destructor, before their
+/// decoder state is torn down.
+///
+/// @see SFXResource::openStream()
+///
+class SFXStream
+{
+   public:
+
+      enum Constants
+      {
+         /// The number of decoded chunks buffered ahead.
+         NumChunks = 4,
+
+         /// The size of one decoded chunk in bytes.
+         ChunkSize = 32768,
+      };
+
+   protected:
+
+      struct Chunk
+      {
+         U8 data[ ChunkSize ];
+         U32 size;
+
+         /// This is the final chunk of a non-looping stream.
+         bool last;
+      };
+
+      /// The decoded chunks waiting to be read.
+      SPSCQueue<Chunk> mChunks;
+
+      /// The bytes already read from the front chunk.
+      U32 mReadOffset;
+
+      /// Set once the last chunk has been read.
+      bool mFinished;
+
+      /// @name Decoder state
+      /// Only touched by the decode thread or while holding smMutex.
+      /// @{
+
+      bool mLooping;
+
+      /// The decoder has produced the last chunk.
+      bool mEndOfStream;
+
+      /// The stream is in the decode thread's list.
+      bool mDecoding;
+
+      /// @}
+
+      /// Decode up to length bytes into buffer.  Returns the
+      /// number of bytes decoded or zero at the end of the data.
+      virtual U32 decode( U8 *buffer, U32 length ) = 0;
+
+      /// Move the decoder to the byte offset into the sample data.
+      virtual bool decoderSeek( U32 pos ) = 0;
+
+      /// Decodes one chunk if there is room for it.  Returns
+      /// true if any work was done.
+      bool _fill();
+
+      static Vector<SFXStream*> smStreams;
+      static void *smMutex;
+      static Thread *smThread;
+      static std::atomic<bool> smShutdown;
+
+      static void _decodeThread( void *arg );
+
+   public:
+
+      SFXStream();
+      virtual ~SFXStream();
+
+      /// Discards any buffered data, moves to the byte offset
+      /// into the sample data, and starts decoding from there.
+      ///
+      /// @param pos The byte offset to start at.
+      /// @param looping If true the stream wraps back to the start
+      ///                and never finishes.
+      ///
+      void start( U32 pos, bool looping );
+
+      /// Stops decoding.  Buffered data can still be read.
+      void stop();
+
+      /// Copies up to length bytes of decoded data into buffer
+      /// and returns the number of bytes copied.  This can be
+      /// less than asked for if the decoder hasn't caught up.
+      U32 read( U8 *buffer, U32 length );
+
+      /// Returns true once all the data of a non-looping
+      /// stream has been read.
+      bool isFinished() const { return mFinished; }
+
+      /// Stops the decode thread.  Called at SFX shutdown.
+      static void shutdown();
+};
+
+
+#endif // _SFXSTREAM_H_
@@ -11,6 +11,7 @@
 #include "console/console.h"
 #include "platform/profiler.h"
 #include "sfx/sfxWavResource.h"
+#include "sfx/sfxStream.h"
 
 #ifndef TORQUE_NO_OGGVORBIS
    #include "sfx/vorbis/sfxOggResource.h"
@@ -46,6 +47,10 @@ void SFXSystem::destroy()
 
    delete smSingleton;
    smSingleton = NULL;
+
+   // All the voices are gone so nothing
+   // is streaming anymore.
+   SFXStream::shutdown();
 }
 
 
@@ -66,6 +71,10 @@ SFXSystem::SFXSystem()
    Con::addVariable( "SFX::numPlaying", TypeS32, &mStatNumPlaying );
    Con::addVariable( "SFX::numCulled", TypeS32, &mStatNumCulled );
    Con::addVariable( "SFX::numVoices", TypeS32, &mStatNumVoices );
+
+#ifndef TORQUE_NO_OGGVORBIS
+   Con::addVariable( "pref::SFX::oggStreamThreshold", TypeS32, &SFXOggResource::smStreamThreshold );
+#endif
 }
 
 SFXSystem::~SFXSystem()
@@ -7,6 +7,84 @@
 
 #include "sfxOggResource.h"
 #include "vorbisStream.h"
+#include "sfx/sfxStream.h"
+#include "core/memstream.h"
+
+
+#ifdef TORQUE_BIG_ENDIAN
+   static const bool smBigEndian = true;
+#else
+   static const bool smBigEndian = false;
+#endif
+
+
+/// Decodes an Ogg Vorbis file held in memory.
+class SFXOggStream : public SFXStream
+{
+   protected:
+
+      MemStream mStream;
+
+      OggVorbisFile mVorbis;
+
+      bool mOpen;
+
+      U32 mSampleBytes;
+
+      // SFXStream
+      virtual U32 decode( U8 *buffer, U32 length );
+      virtual bool decoderSeek( U32 pos );
+
+   public:
+
+      SFXOggStream( const U8 *data, U32 size, U32 sampleBytes );
+      virtual ~SFXOggStream();
+};
+
+
+SFXOggStream::SFXOggStream( const U8 *data, U32 size, U32 sampleBytes )
+   :  mStream( size, (void*)data, true, false ),
+      mSampleBytes( sampleBytes )
+{
+   mOpen = mVorbis.ov_open( &mStream, NULL, 0 ) >= 0;
+}
+
+SFXOggStream::~SFXOggStream()
+{
+   // Get off the decode thread before the
+   // decoder goes away.
+   stop();
+
+   if ( mOpen )
+      mVorbis.ov_clear();
+}
+
+U32 SFXOggStream::decode( U8 *buffer, U32 length )
+{
+   if ( !mOpen )
+      return 0;
+
+   S32 bitstream = 0;
+   for ( ;; )
+   {
+      long bytes = mVorbis.ov_read( (char*)buffer, length, smBigEndian, &bitstream );
+      if ( bytes >= 0 )
+         return bytes;
+
+      // Skip over holes in the data, anything
+      // else ends the stream.
+      if ( bytes != OV_HOLE )
+         return 0;
+   }
+}
+
+bool SFXOggStream::decoderSeek( U32 pos )
+{
+   return mOpen && mVorbis.ov_pcm_seek( pos / mSampleBytes ) == 0;
+}
+
+
+S32 SFXOggResource::smStreamThreshold = 1024 * 1024;
 
 
 ResourceInstance* SFXOggResource::create( Stream &stream )
@@ -21,23 +99,41 @@ ResourceInstance* SFXOggResource::create( Stream &stream )
 
 
 SFXOggResource::SFXOggResource( )
-   : SFXResource()
+   :  SFXResource(),
+      mFileData( NULL ),
+      mFileSize( 0 )
 {
 }
 
 
 SFXOggResource::~SFXOggResource()
 {
+   delete [] mFileData;
 }
 
 
 bool SFXOggResource::load( Stream& stream )
 {
+   // Pull the whole compressed file into memory so
+   // that long sounds can be streamed from it later.
+   U32 fileSize = stream.getStreamSize() - stream.getPosition();
+   U8* fileData = new U8[ fileSize ];
+   if ( !stream.read( fileSize, fileData ) )
+   {
+      delete [] fileData;
+      return false;
+   }
+
+   MemStream memStream( fileSize, fileData, true, false );
+
    OggVorbisFile vf;
    vorbis_info *vi;
 
-   if ( vf.ov_open( &stream, NULL, 0 ) < 0 )
+   if ( vf.ov_open( &memStream, NULL, 0 ) < 0 )
+   {
+      delete [] fileData;
       return false;
+   }
 
    //Read Vorbis File Info
    vi = vf.ov_info(-1);
@@ -45,7 +141,7 @@ bool SFXOggResource::load( Stream& stream )
 
    U32 samples = (U32)vf.ov_pcm_total( -1 );
 
-   if ( vi->channels == 1 ) 
+   if ( vi->channels == 1 )
    {
       mFormat = SFX_FORMAT_MONO16;
       mSize = 2 * samples;
@@ -56,25 +152,55 @@ bool SFXOggResource::load( Stream& stream )
       mSize = 4 * samples;
    }
 
-   #ifdef TORQUE_BIG_ENDIAN
-      bool endian = true;
-   #else
-      bool endian = false;
-   #endif
+   // Calculate the sample length being careful
+   // to avoid overflow on the division.
+   mLength = ( (U64)samples*(U64)1000 ) / (U64)mFrequency;
+
+   // Long sounds, music mostly, keep just the compressed
+   // data and are decoded as they play.
+   if ( smStreamThreshold > 0 && mSize > U32( smStreamThreshold ) )
+   {
+      vf.ov_clear();
+      mFileData = fileData;
+      mFileSize = fileSize;
+      return true;
+   }
 
    mData = new U8[ mSize ];
    S32 current_section = 0;
-   read( &vf, mData, mSize, endian, &current_section );
+   read( &vf, mData, mSize, smBigEndian, &current_section );
 
    vf.ov_clear();
-
-   // Calculate the sample length being careful
-   // to avoid overflow on the division.
-   mLength = ( (U64)samples*(U64)1000 ) / (U64)mFrequency;
+   delete [] fileData;
 
    return true;
 }
 
+SFXStream* SFXOggResource::openStream() const
+{
+   if ( !mFileData )
+      return NULL;
+
+   return new SFXOggStream( mFileData, mFileSize, getSampleBytes() );
+}
+
+void SFXOggResource::_decodeAll() const
+{
+   AssertFatal( mFileData && !mData, "SFXOggResource::_decodeAll() - Nothing to decode!" );
+
+   MemStream memStream( mFileSize, mFileData, true, false );
+
+   OggVorbisFile vf;
+   if ( vf.ov_open( &memStream, NULL, 0 ) < 0 )
+      return;
+
+   mData = new U8[ mSize ];
+   S32 current_section = 0;
+   read( &vf, mData, mSize, smBigEndian, &current_section );
+
+   vf.ov_clear();
+}
+
 S32 SFXOggResource::read( OggVorbisFile* vf, U8* buffer, U32 length, bool bigendianp, S32* bitstream )
 {
    const U32 CHUNKSIZE = 4096;
@@ -99,4 +225,4 @@ S32 SFXOggResource::read( OggVorbisFile* vf, U8* buffer, U32 length, bool bigend
    }
 
    return offset;
-}
\ No newline at end of file
+}
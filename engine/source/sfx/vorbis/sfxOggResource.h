@@ -30,6 +30,16 @@ class SFXOggResource : public SFXResource
       /// The destructor.
       virtual ~SFXOggResource();
 
+      /// The compressed file data kept for streaming, or
+      /// NULL if the sound was decoded in full at load.
+      U8* mFileData;
+
+      /// The length of the mFileData array in bytes.
+      U32 mFileSize;
+
+      // SFXResource
+      virtual void _decodeAll() const;
+
       /// This does the real work of loading the 
       /// data from the stream.
       bool load( Stream& stream );
@@ -39,6 +49,11 @@ class SFXOggResource : public SFXResource
 
    public:
 
+      /// Sounds which decode to more than this many bytes
+      /// are streamed instead of being decoded at load.
+      /// Zero or less disables streaming.
+      static S32 smStreamThreshold;
+
       /// The creation function registered with the
       /// resource manager.
       ///
@@ -46,6 +61,9 @@ class SFXOggResource : public SFXResource
       ///
       static ResourceInstance* create( Stream &stream );
 
+      // SFXResource
+      virtual bool isStreaming() const { return mFileData != NULL; }
+      virtual SFXStream* openStream() const;
 };
 
 
@@ -14,6 +14,7 @@
 #include "sim/pathManager.h"
 #include "console/consoleTypes.h"
 #include "sim/netInterface.h"
+#include "sim/netSimulator.h"
 #include <stdarg.h>
 
 S32 gNetBitsSent = 0;
@@ -657,6 +658,13 @@ Net::Error NetConnection::sendPacket(BitStream* stream)
 
     if (isLocalConnection())
     {
+        // route through the link simulator if it's running.
+        if (NetSimulator::isActive())
+        {
+            NetSimulator::sendPacket(this, mRemoteConnection, stream);
+            return Net::NoError;
+        }
+
         // short circuit connection to the other side.
         // handle the packet, then force a notify.
         stream->setBuffer(stream->getBuffer(), stream->getPosition(), stream->getPosition());
@@ -1180,10 +1188,10 @@ ConsoleMethod(NetConnection, connect, void, 3, 3, "(string remoteAddress) Connec
     object->connect(&addr);
 }
 
-ConsoleMethod(NetConnection, connectLocal, const char*, 2, 2, "Connects a connection to the server running in the same process.")
+const char* NetConnection::connectLocal(bool primary)
 {
-    ConsoleObject* co = ConsoleObject::create(object->getClassName());
-    NetConnection* client = object;
+    ConsoleObject* co = ConsoleObject::create(getClassName());
+    NetConnection* client = this;
     NetConnection* server = dynamic_cast<NetConnection*>(co);
     const char* error = NULL;
     BitStream* stream = BitStream::getPacketStream();
@@ -1217,18 +1225,30 @@ ConsoleMethod(NetConnection, connectLocal, const char*, 2, 2, "Connects a connec
     server->setEstablished();
     client->setConnectSequence(0);
     server->setConnectSequence(0);
-    NetConnection::setLocalClientConnection(server);
-    server->assignName("LocalClientConnection");
-    return "";
+    if (primary)
+    {
+        NetConnection::setLocalClientConnection(server);
+        server->assignName("LocalClientConnection");
+    }
+    return NULL;
 
 errorOut:
-    server->deleteObject();
+    if (server)
+        server->deleteObject();
+    else if (co)
+        delete co;
     client->deleteObject();
     if (!error)
         error = "Unknown Error";
     return error;
 }
 
+ConsoleMethod(NetConnection, connectLocal, const char*, 2, 2, "Connects a connection to the server running in the same process.")
+{
+    const char* error = object->connectLocal();
+    return error ? error : "";
+}
+
 ConsoleMethod(NetConnection, getXnAddr, const char*, 2, 2, "getXnAddr()")
 {
     // TODO: Do we want to deal with this xbox live function?
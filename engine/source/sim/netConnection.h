@@ -571,6 +571,7 @@ protected:
 
 public:
     static NetConnection* getConnectionToServer() { return mServerConnection; }
+    static void setConnectionToServer(NetConnection* conn) { mServerConnection = conn; }
 
     static NetConnection* getLocalClientConnection() { return mLocalClientConnection; }
     static void setLocalClientConnection(NetConnection* conn) { mLocalClientConnection = conn; }
@@ -602,6 +603,14 @@ public:
     /// Call this if the "connection" is local to this app. This short-circuits the protocol layer.
     void setRemoteConnectionObject(NetConnection* connection) { mRemoteConnection = connection; };
 
+    /// Create the server side of a short circuited connection and connect this
+    /// (client) connection to it.
+    ///
+    /// If primary is set, the server side becomes the LocalClientConnection.
+    ///
+    /// @returns NULL on success, otherwise an error string.
+    const char* connectLocal(bool primary = true);
+
     void setSequence(U32 connectSequence);
 
     void setAddressDigest(U32 digest[4]);
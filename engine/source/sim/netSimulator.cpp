@@ -0,0 +1,307 @@
+//-----------------------------------------------------------------------------
+// Torque Game Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "sim/netSimulator.h"
+#include "sim/netConnection.h"
+#include "console/simBase.h"
+#include "console/consoleTypes.h"
+#include "core/bitStream.h"
+#include "platform/event.h"
+
+extern U32 gGhostUpdates;
+
+bool NetSimulator::smActive = false;
+NetSimulator::Params NetSimulator::smParams;
+NetSimulator::Stats NetSimulator::smStats;
+MRandomLCG NetSimulator::smRandom;
+Vector<NetSimulator::MoveTimes*> NetSimulator::smMoveTimes(__FILE__, __LINE__);
+
+//----------------------------------------------------------------------------
+/// Carries one packet across the simulated link.  Posted to the receiving
+/// connection, so it is dropped automatically if that connection goes away.
+class NetSimPacketEvent : public SimEvent
+{
+    U8 mBuffer[MaxPacketDataSize];
+    U32 mSize;
+    bool mToServer;
+public:
+    NetSimPacketEvent(BitStream* inStream, bool toServer)
+    {
+        mSize = inStream->getPosition();
+        mToServer = toServer;
+        dMemcpy(mBuffer, inStream->getBuffer(), mSize);
+    }
+    void process(SimObject* object)
+    {
+        NetSimulator::notePacketDelivered(mToServer, mSize);
+
+        BitStream stream(mBuffer, mSize, mSize);
+        ((NetConnection*)object)->processRawPacket(&stream);
+    }
+};
+
+//----------------------------------------------------------------------------
+
+void NetSimulator::init()
+{
+    smParams.latency = 50;
+    smParams.jitter = 0;
+    smParams.packetLoss = 0;
+    smParams.reorder = 0;
+    smParams.reorderDelay = 32;
+    smParams.seed = 1376312589;
+
+    Con::addVariable("NetSim::latency", TypeS32, &smParams.latency);
+    Con::addVariable("NetSim::jitter", TypeS32, &smParams.jitter);
+    Con::addVariable("NetSim::packetLoss", TypeF32, &smParams.packetLoss);
+    Con::addVariable("NetSim::reorder", TypeF32, &smParams.reorder);
+    Con::addVariable("NetSim::reorderDelay", TypeS32, &smParams.reorderDelay);
+    Con::addVariable("NetSim::seed", TypeS32, &smParams.seed);
+
+    resetStats();
+}
+
+void NetSimulator::shutdown()
+{
+    smActive = false;
+    for (U32 i = 0; i < smMoveTimes.size(); i++)
+        delete smMoveTimes[i];
+    smMoveTimes.clear();
+}
+
+void NetSimulator::start(const Params& params)
+{
+    smParams = params;
+    smRandom.setSeed(smParams.seed);
+    smActive = true;
+    resetStats();
+
+    Con::printf("NetSim: started - latency %dms, jitter %dms, loss %g, reorder %g, seed %d",
+        smParams.latency, smParams.jitter, smParams.packetLoss, smParams.reorder, smParams.seed);
+}
+
+void NetSimulator::stop()
+{
+    if (!smActive)
+        return;
+
+    smActive = false;
+    Con::printf("NetSim: stopped");
+}
+
+void NetSimulator::resetStats()
+{
+    dMemset(&smStats, 0, sizeof(smStats));
+    smStats.startRealTime = Platform::getRealMilliseconds();
+    smStats.startSimTime = Sim::getCurrentTime();
+    smStats.startGhostUpdates = gGhostUpdates;
+
+    for (U32 i = 0; i < smMoveTimes.size(); i++)
+        delete smMoveTimes[i];
+    smMoveTimes.clear();
+}
+
+//----------------------------------------------------------------------------
+
+void NetSimulator::sendPacket(NetConnection* from, NetConnection* to, BitStream* stream)
+{
+    bool toServer = from->isConnectionToServer();
+    LinkStats& link = toServer ? smStats.toServer : smStats.toClient;
+
+    link.packetsSent++;
+    link.bytesSent += stream->getPosition();
+
+    // Always draw the same number of values per packet so that changing one
+    // parameter doesn't shift the random sequence seen by the others.
+    F32 lossRoll = smRandom.randF();
+    F32 reorderRoll = smRandom.randF();
+    U32 jitter = smParams.jitter ? U32(smRandom.randI(0, smParams.jitter)) : 0;
+
+    if (lossRoll < smParams.packetLoss)
+    {
+        link.packetsDropped++;
+        return;
+    }
+
+    U32 delay = smParams.latency + jitter;
+    if (reorderRoll < smParams.reorder)
+    {
+        link.packetsReordered++;
+        delay += smParams.reorderDelay;
+    }
+
+    Sim::postEvent(to, new NetSimPacketEvent(stream, toServer), Sim::getCurrentTime() + delay);
+}
+
+NetConnection* NetSimulator::addClient(const char* className, const char** errorString)
+{
+    ConsoleObject* co = ConsoleObject::create(className);
+    NetConnection* client = dynamic_cast<NetConnection*>(co);
+    if (!client)
+    {
+        delete co;
+        *errorString = "Not a NetConnection class";
+        return NULL;
+    }
+    client->registerObject();
+
+    // Establishing the connection claims the connection to server slot,
+    // give it back to whoever had it.
+    NetConnection* serverConnection = NetConnection::getConnectionToServer();
+    const char* error = client->connectLocal(false);
+    NetConnection::setConnectionToServer(serverConnection);
+
+    if (error)
+    {
+        *errorString = error;
+        return NULL;
+    }
+    return client;
+}
+
+//----------------------------------------------------------------------------
+
+NetSimulator::MoveTimes* NetSimulator::findMoveTimes(NetConnection* conn, bool create)
+{
+    for (U32 i = 0; i < smMoveTimes.size(); i++)
+        if (smMoveTimes[i]->connectionId == conn->getId())
+            return smMoveTimes[i];
+
+    if (!create)
+        return NULL;
+
+    MoveTimes* times = new MoveTimes;
+    times->connectionId = conn->getId();
+    dMemset(times->moveIndex, 0xFF, sizeof(times->moveIndex));
+    smMoveTimes.push_back(times);
+    return times;
+}
+
+void NetSimulator::notePacketDelivered(bool toServer, U32 bytes)
+{
+    LinkStats& link = toServer ? smStats.toServer : smStats.toClient;
+    link.packetsDelivered++;
+    link.bytesDelivered += bytes;
+}
+
+void NetSimulator::noteMoveSent(NetConnection* conn, U32 moveIndex)
+{
+    if (!smActive)
+        return;
+
+    MoveTimes* times = findMoveTimes(conn, true);
+    U32 slot = moveIndex & (MoveTimeRingSize - 1);
+    times->moveIndex[slot] = moveIndex;
+    times->sendTime[slot] = Sim::getCurrentTime();
+}
+
+void NetSimulator::noteMovesAcked(NetConnection* conn, U32 firstIndex, U32 lastIndex)
+{
+    if (!smActive || firstIndex >= lastIndex)
+        return;
+
+    MoveTimes* times = findMoveTimes(conn, false);
+    if (!times)
+        return;
+
+    U32 now = Sim::getCurrentTime();
+    for (U32 i = firstIndex; i < lastIndex; i++)
+    {
+        U32 slot = i & (MoveTimeRingSize - 1);
+        if (times->moveIndex[slot] != i)
+            continue;
+
+        U32 elapsed = now - times->sendTime[slot];
+        smStats.moveAcks++;
+        smStats.moveAckTotalTime += elapsed;
+        smStats.moveAckMaxTime = getMax(smStats.moveAckMaxTime, elapsed);
+        times->moveIndex[slot] = U32(-1);
+    }
+}
+
+void NetSimulator::noteClientCatchup(U32 ticks, U32 realTime)
+{
+    if (!smActive)
+        return;
+
+    smStats.catchupCalls++;
+    smStats.catchupTicks += ticks;
+    smStats.catchupMaxTicks = getMax(smStats.catchupMaxTicks, ticks);
+    smStats.catchupRealTime += realTime;
+}
+
+//----------------------------------------------------------------------------
+
+static void dumpLinkStats(const char* name, const NetSimulator::LinkStats& link, F32 seconds)
+{
+    Con::printf("  %s: %d sent, %d dropped, %d reordered, %d delivered, %.1f kbit/s",
+        name, link.packetsSent, link.packetsDropped, link.packetsReordered, link.packetsDelivered,
+        seconds > 0 ? (link.bytesDelivered * 8 / 1000.0f) / seconds : 0.0f);
+}
+
+void NetSimulator::dumpStats()
+{
+    U32 simTime = Sim::getCurrentTime() - smStats.startSimTime;
+    U32 realTime = Platform::getRealMilliseconds() - smStats.startRealTime;
+    F32 seconds = simTime / 1000.0f;
+    U32 ghostUpdates = gGhostUpdates - smStats.startGhostUpdates;
+
+    Con::printf("NetSim: %s, %.2fs sim time, %.2fs real time", smActive ? "active" : "stopped",
+        seconds, realTime / 1000.0f);
+    dumpLinkStats("to client", smStats.toClient, seconds);
+    dumpLinkStats("to server", smStats.toServer, seconds);
+    Con::printf("  ghost updates: %d (%.1f/s)", ghostUpdates, seconds > 0 ? ghostUpdates / seconds : 0.0f);
+    Con::printf("  move ack latency: %d moves, avg %.1fms, max %dms", smStats.moveAcks,
+        smStats.moveAcks ? F32(smStats.moveAckTotalTime) / smStats.moveAcks : 0.0f, smStats.moveAckMaxTime);
+    Con::printf("  client catchup: %d calls, %d ticks (avg %.2f, max %d), %dms real time", smStats.catchupCalls,
+        smStats.catchupTicks, smStats.catchupCalls ? F32(smStats.catchupTicks) / smStats.catchupCalls : 0.0f,
+        smStats.catchupMaxTicks, smStats.catchupRealTime);
+}
+
+//----------------------------------------------------------------------------
+
+ConsoleFunctionGroupBegin(NetSim, "In-process network link simulation.");
+
+ConsoleFunction(netSimStart, void, 1, 1, "netSimStart()"
+    "Route local connection traffic through the simulated link, using the $NetSim:: parameters.")
+{
+    NetSimulator::start(NetSimulator::getParams());
+}
+
+ConsoleFunction(netSimStop, void, 1, 1, "netSimStop()")
+{
+    NetSimulator::stop();
+}
+
+ConsoleFunction(netSimIsActive, bool, 1, 1, "netSimIsActive()")
+{
+    return NetSimulator::isActive();
+}
+
+ConsoleFunction(netSimAddClient, S32, 1, 2, "netSimAddClient(className = GameConnection)"
+    "Create a virtual client connected to the local server.  Returns the client connection id, or 0.")
+{
+    const char* error = NULL;
+    NetConnection* conn = NetSimulator::addClient(argc > 1 ? argv[1] : "GameConnection", &error);
+    if (!conn)
+    {
+        Con::errorf("netSimAddClient: unable to connect - %s", error);
+        return 0;
+    }
+    return conn->getId();
+}
+
+ConsoleFunction(netSimResetStats, void, 1, 1, "netSimResetStats()")
+{
+    NetSimulator::resetStats();
+}
+
+ConsoleFunction(netSimDumpStats, void, 1, 1, "netSimDumpStats()")
+{
+    NetSimulator::dumpStats();
+}
+
+ConsoleFunctionGroupEnd(NetSim);
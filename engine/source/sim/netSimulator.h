@@ -0,0 +1,147 @@
+//-----------------------------------------------------------------------------
+// Torque Game Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#ifndef _NETSIMULATOR_H_
+#define _NETSIMULATOR_H_
+
+#ifndef _PLATFORM_H_
+#include "platform/platform.h"
+#endif
+#ifndef _TVECTOR_H_
+#include "core/tVector.h"
+#endif
+#ifndef _MRANDOM_H_
+#include "math/mRandom.h"
+#endif
+
+class NetConnection;
+class BitStream;
+
+/// In-process network link simulator.
+///
+/// When active, every packet sent over a short circuited (connectLocal)
+/// connection is routed through a simulated link instead of being handed
+/// straight to the other side.  The link applies latency, jitter, loss and
+/// reordering, and delivers packets through the Sim event queue, so a server
+/// and any number of virtual clients can be run in one process with no real
+/// socket traffic.
+///
+/// All randomness comes from a seeded LCG that only advances when packets are
+/// sent, so the same seed and the same traffic give the same drop/delay
+/// pattern from run to run.
+///
+/// The simulator also gathers the numbers we care about when load testing:
+/// ghosting throughput, move ack latency and client catchup cost.
+///
+/// @see netSimStart, netSimAddClient, netSimDumpStats
+class NetSimulator
+{
+public:
+    /// Link parameters.  Delays are in milliseconds, probabilities in 0..1.
+    struct Params
+    {
+        U32 latency;      ///< One way base delay.
+        U32 jitter;       ///< Maximum extra random delay added to each packet.
+        F32 packetLoss;   ///< Chance any given packet is dropped.
+        F32 reorder;      ///< Chance a packet is held back behind the next ones.
+        U32 reorderDelay; ///< How long a reordered packet is held back.
+        S32 seed;         ///< Seed for the link's random generator.
+    };
+
+    /// Counters for one direction of the link.
+    struct LinkStats
+    {
+        U32 packetsSent;
+        U32 packetsDropped;
+        U32 packetsReordered;
+        U32 packetsDelivered;
+        U32 bytesSent;
+        U32 bytesDelivered;
+    };
+
+    struct Stats
+    {
+        U32 startRealTime;      ///< Real time the run was started.
+        U32 startSimTime;       ///< Sim time the run was started.
+        U32 startGhostUpdates;  ///< Value of Stats::netGhostUpdates at start.
+
+        LinkStats toClient;     ///< Server to client traffic.
+        LinkStats toServer;     ///< Client to server traffic.
+
+        U32 moveAcks;           ///< Number of moves acked by the server.
+        U32 moveAckTotalTime;   ///< Sum of send to ack times, in ms.
+        U32 moveAckMaxTime;     ///< Worst send to ack time, in ms.
+
+        U32 catchupCalls;       ///< Number of clientCatchup calls.
+        U32 catchupTicks;       ///< Total ticks replayed by clientCatchup.
+        U32 catchupMaxTicks;    ///< Worst single catchup, in ticks.
+        U32 catchupRealTime;    ///< Real time spent in clientCatchup, in ms.
+    };
+
+private:
+    enum Constants
+    {
+        MoveTimeRingSize = 128,   ///< Must be a power of two.
+    };
+
+    /// Send times of the last few moves written by one client connection.
+    struct MoveTimes
+    {
+        U32 connectionId;
+        U32 moveIndex[MoveTimeRingSize];
+        U32 sendTime[MoveTimeRingSize];
+    };
+
+    static bool smActive;
+    static Params smParams;
+    static Stats smStats;
+    static MRandomLCG smRandom;
+    static Vector<MoveTimes*> smMoveTimes;
+
+    static MoveTimes* findMoveTimes(NetConnection* conn, bool create);
+
+public:
+    static void init();
+    static void shutdown();
+
+    /// Starts routing local connection traffic through the simulated link
+    /// and resets all statistics.
+    static void start(const Params& params);
+
+    /// Stops simulating.  Packets already in flight are still delivered.
+    static void stop();
+
+    static bool isActive() { return smActive; }
+    static const Params& getParams() { return smParams; }
+    static const Stats& getStats() { return smStats; }
+    static void resetStats();
+
+    /// Queue a packet from one side of a local connection to the other.
+    ///
+    /// The packet is copied, so the caller's stream can be reused right away.
+    static void sendPacket(NetConnection* from, NetConnection* to, BitStream* stream);
+
+    /// Create a new client connection of the given class and connect it to
+    /// the local server.  Unlike connectLocal, the new connection does not
+    /// become the process' connection to server.
+    ///
+    /// @returns The new connection, or NULL on failure (errorString is set).
+    static NetConnection* addClient(const char* className, const char** errorString);
+
+    /// @name Measurement hooks
+    /// @{
+
+    static void notePacketDelivered(bool toServer, U32 bytes);
+    static void noteMoveSent(NetConnection* conn, U32 moveIndex);
+    static void noteMovesAcked(NetConnection* conn, U32 firstIndex, U32 lastIndex);
+    static void noteClientCatchup(U32 ticks, U32 realTime);
+
+    /// @}
+
+    /// Print a summary of the current run to the console.
+    static void dumpStats();
+};
+
+#endif
@@ -121,6 +121,9 @@ void PathManagerEvent::process(NetConnection*)
     }
     else
         *(gClientPathManager->mPaths[modifiedPath]) = path;
+
+    gClientPathManager->mPaths[modifiedPath]->buildLookup();
+    gClientPathManager->mRevision++;
 }
 
 IMPLEMENT_CO_NETEVENT_V1(PathManagerEvent);
@@ -138,6 +141,7 @@ PathManager::PathManager(const bool isServer)
     VECTOR_SET_ASSOCIATION(mPaths);
 
     mIsServer = isServer;
+    mRevision = 0;
 }
 
 PathManager::~PathManager()
@@ -150,6 +154,7 @@ void PathManager::clearPaths()
     for (U32 i = 0; i < mPaths.size(); i++)
         delete mPaths[i];
     mPaths.setSize(0);
+    mRevision++;
 #ifdef TORQUE_DEBUG
     // This gets rid of the memory used by the vector.
     // Prevents it from showing up in memory leak logs.
@@ -187,6 +192,14 @@ void PathManager::destroy()
 
 
 //--------------------------------------------------------------------------
+void PathManager::PathEntry::buildLookup()
+{
+    msStart.setSize(msToNext.size() + 1);
+    msStart[0] = 0;
+    for (U32 i = 0; i < msToNext.size(); i++)
+        msStart[i + 1] = msStart[i] + msToNext[i];
+}
+
 U32 PathManager::allocatePathId()
 {
     mPaths.increment();
@@ -220,6 +233,8 @@ void PathManager::updatePath(const U32              id,
     for (S32 i = 0; i < S32(rEntry.msToNext.size()); i++)
 #endif
         rEntry.totalTime += rEntry.msToNext[i];
+    rEntry.buildLookup();
+    mRevision++;
 
     transmitPath(id);
 }
@@ -285,15 +300,24 @@ void PathManager::getPathPosition(const U32 id,
     PROFILE_START(PathManGetPos);
 
     // Ok, query holds our path information...
+    const PathEntry& rEntry = *mPaths[id];
     F64 ms = msPosition;
-    if (ms > mPaths[id]->totalTime)
-        ms = mPaths[id]->totalTime;
+    if (ms > rEntry.totalTime)
+        ms = rEntry.totalTime;
 
-    S32 startNode = 0;
-    while (ms > mPaths[id]->msToNext[startNode]) {
-        ms -= mPaths[id]->msToNext[startNode];
-        startNode++;
+    // The segment is the first whose end time isn't before ms
+    S32 lo = 0, hi = rEntry.positions.size() - 1;
+    while (lo < hi)
+    {
+        S32 mid = (lo + hi) >> 1;
+        if (ms > rEntry.msStart[mid + 1])
+            lo = mid + 1;
+        else
+            hi = mid;
     }
+    S32 startNode = lo;
+    ms -= rEntry.msStart[startNode];
+
     S32 endNode = (startNode + 1) % mPaths[id]->positions.size();
 
     Point3F& rStart = mPaths[id]->positions[startNode];
@@ -351,11 +375,7 @@ U32 PathManager::getWaypointTime(const U32 id, const U32 wayPoint) const
     AssertFatal(isValidPath(id), "Error, this is not a valid path!");
     AssertFatal(wayPoint < getPathNumWaypoints(id), "Invalid waypoint!");
 
-    U32 time = 0;
-    for (U32 i = 0; i < wayPoint; i++)
-        time += mPaths[id]->msToNext[i];
-
-    return time;
+    return mPaths[id]->msStart[wayPoint];
 }
 
 U32 PathManager::getPathTimeBits(const U32 id)
@@ -415,7 +435,9 @@ bool PathManager::readState(BitStream* stream)
             mathRead(*stream, &rEntry.positions[j]);
             stream->read(&rEntry.msToNext[j]);
         }
+        rEntry.buildLookup();
     }
+    mRevision++;
 
     return stream->getStatus() == Stream::Ok;
 }
@@ -39,16 +39,27 @@ private:
         Vector<U32>     smoothingType;
         Vector<U32>     msToNext;
 
+        /// Time each waypoint is reached, so finding the segment for a
+        /// time is a binary search.  Built by buildLookup() whenever the
+        /// waypoints change; one longer than positions.
+        Vector<U32>     msStart;
+
         PathEntry() {
             VECTOR_SET_ASSOCIATION(positions);
             VECTOR_SET_ASSOCIATION(rotations);
             VECTOR_SET_ASSOCIATION(smoothingType);
             VECTOR_SET_ASSOCIATION(msToNext);
+            VECTOR_SET_ASSOCIATION(msStart);
         }
+
+        void buildLookup();
     };
 
     Vector<PathEntry*> mPaths;
 
+    /// Bumped whenever any path changes.
+    U32 mRevision;
+
 public:
     enum PathType {
         BackAndForth,
@@ -71,6 +82,10 @@ public:
     U32  getPathNumWaypoints(const U32 id) const;
     U32  getWaypointTime(const U32 id, const U32 wayPoint) const;
 
+    /// Changes whenever a path is added, changed or cleared, so results
+    /// worked out from the paths can be cached against it.
+    U32  getRevision() const { return mRevision; }
+
     U32 getPathTimeBits(const U32 id);
     U32 getPathWaypointBits(const U32 id);
 
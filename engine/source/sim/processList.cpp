@@ -7,6 +7,7 @@
 #include "game/gameConnection.h"
 #include "game/gameBase.h"
 #include "game/shapeBase.h"
+#include "ts/tsShapeInstance.h"
 
 #include "sim/processList.h"
 #include "platform/profiler.h"
@@ -19,6 +20,8 @@
 //----------------------------------------------------------------------------
 
 bool ProcessList::mDebugControlSync = false;
+S32 ProcessList::smCatchupBudget = 512;
+bool ProcessList::smLogCatchup = false;
 U32 gNetOrderNextId = 0;
 F32 gMaxHiFiVelSq = 100 * 100;
 
@@ -69,6 +72,125 @@ MoveSync moveSync;
 
 //--------------------------------------------------------------------------
 
+namespace {
+
+    /// Hashed grid over the client's hi fi objects, built once per catch-up
+    /// so the neighbor search doesn't query the container for every object
+    /// it looks around.  Objects go in by the center of their world box and
+    /// queries are grown by the biggest half extent, so each object is in
+    /// one cell and comes back at most once.
+    class CatchupGrid
+    {
+        struct Entry
+        {
+            GameBase* obj;
+            S32 x, y, z;
+            S32 next;
+        };
+
+        Vector<Entry> mEntries;
+        Vector<S32> mBuckets;
+        Vector<GameBase*> mGlobal;   ///< Global bounds objects, in every query.
+        Point3F mMaxExtent;
+        F32 mInvCellSize;
+
+        inline U32 hash(S32 x, S32 y, S32 z) const
+        {
+            return (U32(x) * 73856093U ^ U32(y) * 19349663U ^ U32(z) * 83492791U) & (mBuckets.size() - 1);
+        }
+
+        inline S32 cell(F32 v) const
+        {
+            return S32(mFloor(v * mInvCellSize));
+        }
+
+    public:
+        CatchupGrid()
+        {
+            VECTOR_SET_ASSOCIATION(mEntries);
+            VECTOR_SET_ASSOCIATION(mBuckets);
+            VECTOR_SET_ASSOCIATION(mGlobal);
+        }
+
+        void build(const Vector<GameBase*>& objects, F32 cellSize)
+        {
+            mEntries.clear();
+            mGlobal.clear();
+            mMaxExtent.set(0.0f, 0.0f, 0.0f);
+            mInvCellSize = 1.0f / getMax(cellSize, 1.0f);
+
+            U32 numBuckets = 16;
+            while (numBuckets < objects.size() * 2)
+                numBuckets <<= 1;
+            mBuckets.setSize(numBuckets);
+            dMemset(mBuckets.address(), 0xFF, numBuckets * sizeof(S32));
+
+            for (U32 i = 0; i < objects.size(); i++)
+            {
+                GameBase* obj = objects[i];
+                if (obj->isGlobalBounds())
+                {
+                    mGlobal.push_back(obj);
+                    continue;
+                }
+
+                const Box3F& box = obj->getWorldBox();
+                Point3F center, extent = (box.max - box.min) * 0.5f;
+                box.getCenter(&center);
+                mMaxExtent.setMax(extent);
+
+                mEntries.increment();
+                Entry& entry = mEntries.last();
+                entry.obj = obj;
+                entry.x = cell(center.x);
+                entry.y = cell(center.y);
+                entry.z = cell(center.z);
+                U32 bucket = hash(entry.x, entry.y, entry.z);
+                entry.next = mBuckets[bucket];
+                mBuckets[bucket] = mEntries.size() - 1;
+            }
+        }
+
+        /// Append everything whose world box overlaps box.
+        void query(const Box3F& box, Vector<GameBase*>& out) const
+        {
+            U32 i;
+            for (i = 0; i < mGlobal.size(); i++)
+                out.push_back(mGlobal[i]);
+
+            S32 x0 = cell(box.min.x - mMaxExtent.x), x1 = cell(box.max.x + mMaxExtent.x);
+            S32 y0 = cell(box.min.y - mMaxExtent.y), y1 = cell(box.max.y + mMaxExtent.y);
+            S32 z0 = cell(box.min.z - mMaxExtent.z), z1 = cell(box.max.z + mMaxExtent.z);
+
+            // A query wider than the table is cheaper as a straight walk
+            if (F32(x1 - x0 + 1) * F32(y1 - y0 + 1) * F32(z1 - z0 + 1) > F32(mEntries.size()))
+            {
+                for (i = 0; i < mEntries.size(); i++)
+                    if (mEntries[i].obj->getWorldBox().isOverlapped(box))
+                        out.push_back(mEntries[i].obj);
+                return;
+            }
+
+            for (S32 z = z0; z <= z1; z++)
+                for (S32 y = y0; y <= y1; y++)
+                    for (S32 x = x0; x <= x1; x++)
+                    {
+                        for (S32 walk = mBuckets[hash(x, y, z)]; walk != -1; walk = mEntries[walk].next)
+                        {
+                            const Entry& entry = mEntries[walk];
+                            if (entry.x == x && entry.y == y && entry.z == z && entry.obj->getWorldBox().isOverlapped(box))
+                                out.push_back(entry.obj);
+                        }
+                    }
+        }
+    };
+
+    CatchupGrid sgCatchupGrid;
+
+} // namespace {}
+
+//--------------------------------------------------------------------------
+
 
 ProcessObject::ProcessObject()
 {
@@ -342,6 +464,7 @@ bool ProcessList::advanceClientTime(SimTime timeDelta)
             GameBase* gb = getGameBase(pobj);
             gb->advanceTime(dt);
         }
+        TSShapeInstance::flushAnimateQueue();
 
 #ifdef MB_CLIENT_PHYSICS_EVERY_FRAME
         for (ProcessObject* pobj = mHead.mProcessLink.next; pobj != &mHead; pobj = pobj->mProcessLink.next)
@@ -404,6 +527,7 @@ bool ProcessList::advanceSPModeTime(SimTime timeDelta)
         GameBase* gb = getGameBase(obj);
         gb->advanceTime(dt);
     }
+    TSShapeInstance::flushAnimateQueue();
 
     mLastTime = targetTime;
     PROFILE_END();
@@ -558,6 +682,9 @@ void ProcessList::clientCatchup(GameConnection* connection, S32 catchup)
     Con::printf("client catching up... (%i)%s", catchup, mForceHifiReset ? " reset" : "");
 #endif
 
+    U32 startTime = Platform::getRealMilliseconds();
+    U32 numUpdated = 0, numNeighbors = 0, numDeferred = 0;
+
     const F32 maxVel = mSqrt(gMaxHiFiVelSq) * 1.25f;
     F32 dt = F32(catchup + 1) * TickSec;
     Point3F bigDelta(maxVel * dt, maxVel * dt, maxVel * dt);
@@ -567,17 +694,83 @@ void ProcessList::clientCatchup(GameConnection* connection, S32 catchup)
     ProcessObject* pobj;
     if (catchup && !mForceHifiReset)
     {
+        // Everything the neighbor search can turn up, put in a grid once
+        // rather than searched for again around every object
+        static Vector<GameBase*> candidates;
+        candidates.clear();
+        F32 maxRadius = 0.0f;
+
+#ifdef MB_ULTRA
+        // CodeReview - this is left in for MBU, but also so we can deal with the issue later.
+        // add marble blast hack so hifi networking can see hidden objects
+        // (since hidden is under control of hifi networking)
+        gForceNotHidden = true;
+#endif
+
+        for (pobj = mHead.mProcessLink.next; pobj != &mHead; pobj = pobj->mProcessLink.next)
+        {
+            GameBase* obj = getGameBase(pobj);
+            if (!(obj->getType() & GameBaseHiFiObjectType))
+                continue;
+
+            if (obj->isGhostUpdated())
+                numUpdated++;
+            if (obj->getContainer() == getCurrentClientContainer() && !obj->isHidden())
+            {
+                candidates.push_back(obj);
+                maxRadius = getMax(maxRadius, obj->getWorldSphere().radius);
+            }
+        }
+
+#ifdef MB_ULTRA
+        // CodeReview - this is left in for MBU, but also so we can deal with the issue later.
+        // disable above hack
+        gForceNotHidden = false;
+#endif
+
+        sgCatchupGrid.build(candidates, 2.0f * (bigDelta.x + 1.5f * maxRadius));
+
+        // Every object rolled back costs catchup ticks of replay.  The ones
+        // the server sent are a must, neighbors are taken while it lasts.
+        U32 maxObjects = smCatchupBudget > 0 ? getMax(U32(smCatchupBudget) / U32(catchup), numUpdated) : U32(-1);
+        U32 numObjects = numUpdated;
+
+        // Neighbors the last catch-up had to leave go first
+        for (U32 k = 0; k < mDeferredCatchup.size(); k++)
+        {
+            GameBase* obj = NULL;
+            Sim::findObject(mDeferredCatchup[k], obj);
+            if (obj && !obj->isGhostUpdated() && (obj->getType() & GameBaseHiFiObjectType) && numObjects < maxObjects)
+            {
+                obj->beginTickCacheList();
+                TickCacheEntry* tce = obj->incTickCacheList(true);
+                BitStream bs(tce->packetData, TickCacheEntry::MaxPacketSize);
+                obj->readPacketData(connection, &bs);
+                obj->setGhostUpdated(true);
+                numObjects++;
+                numNeighbors++;
+            }
+            else if (obj && !obj->isGhostUpdated() && (obj->getType() & GameBaseHiFiObjectType))
+            {
+                // still no room, keep it and don't defer it twice
+                obj->mNetFlags.set(GameBase::NetNearbyAdded);
+                continue;
+            }
+
+            mDeferredCatchup.erase_fast(k--);
+        }
+
         for (pobj = mHead.mProcessLink.next; pobj != &mHead; pobj = pobj->mProcessLink.next)
         {
             GameBase* obj = getGameBase(pobj);
-            static SimpleQueryList nearby;
-            nearby.mList.clear();
+            static Vector<GameBase*> nearby;
+            nearby.clear();
             // check for nearby objects which need to be reset and then caught up
             // note the funky loop logic -- first time through obj is us, then
             // we start iterating through nearby list (to look for objects nearby
             // the nearby objects), which is why index starts at -1
             // [objects nearby the nearby objects also get added to the nearby list]
-            for (S32 i = -1; obj; obj = ++i < nearby.mList.size() ? (GameBase*)nearby.mList[i] : NULL)
+            for (S32 i = -1; obj; obj = ++i < nearby.size() ? nearby[i] : NULL)
             {
                 if (obj->isGhostUpdated() && (obj->getType() & GameBaseHiFiObjectType) && !obj->mNetFlags.test(GameBase::NetNearbyAdded))
                 {
@@ -593,26 +786,13 @@ void ProcessList::clientCatchup(GameConnection* connection, S32 catchup)
                     box.min -= bigDelta + rads;
                     box.max += bigDelta + rads;
 
-#ifdef MB_ULTRA
-                    // CodeReview - this is left in for MBU, but also so we can deal with the issue later.
-                    // add marble blast hack so hifi networking can see hidden objects
-                    // (since hidden is under control of hifi networking)
-                    gForceNotHidden = true;
-#endif
-
-                    S32 j = nearby.mList.size();
-                    getCurrentClientContainer()->findObjects(box, GameBaseHiFiObjectType, SimpleQueryList::insertionCallback, &nearby);
-
-#ifdef MB_ULTRA
-                    // CodeReview - this is left in for MBU, but also so we can deal with the issue later.
-                    // disable above hack
-                    gForceNotHidden = false;
-#endif
+                    S32 j = nearby.size();
+                    sgCatchupGrid.query(box, nearby);
 
                     // drop anyone not heading toward us or already checked
-                    for (; j < nearby.mList.size(); j++)
+                    for (; j < nearby.size(); j++)
                     {
-                        GameBase* obj2 = (GameBase*)nearby.mList[j];
+                        GameBase* obj2 = nearby[j];
                         // if both passive, these guys don't interact with each other
                         bool passive = obj->mNetFlags.test(GameBase::HiFiPassive) && obj2->mNetFlags.test(GameBase::HiFiPassive);
                         if (!obj2->isGhostUpdated() && !passive)
@@ -624,22 +804,38 @@ void ProcessList::clientCatchup(GameConnection* connection, S32 catchup)
                             F32 rad2 = 1.5f * obj->getWorldSphere().radius;
                             if (MathUtils::capsuleCapsuleOverlap(start, end, rad, start2, end2, rad2))
                             {
-                                // better add obj2
-                                obj2->beginTickCacheList();
-                                TickCacheEntry* tce = obj2->incTickCacheList(true);
-                                BitStream bs(tce->packetData, TickCacheEntry::MaxPacketSize);
-                                obj2->readPacketData(connection, &bs);
-                                obj2->setGhostUpdated(true);
-
-                                // continue so we later add the neighbors too
-                                continue;
+                                if (numObjects >= maxObjects)
+                                {
+                                    // out of budget, the next catch-up rolls it back
+                                    // (marked so it's only deferred once)
+                                    if (!obj2->mNetFlags.test(GameBase::NetNearbyAdded))
+                                    {
+                                        mDeferredCatchup.push_back(obj2->getId());
+                                        obj2->mNetFlags.set(GameBase::NetNearbyAdded);
+                                        numDeferred++;
+                                    }
+                                }
+                                else
+                                {
+                                    // better add obj2
+                                    obj2->beginTickCacheList();
+                                    TickCacheEntry* tce = obj2->incTickCacheList(true);
+                                    BitStream bs(tce->packetData, TickCacheEntry::MaxPacketSize);
+                                    obj2->readPacketData(connection, &bs);
+                                    obj2->setGhostUpdated(true);
+                                    numObjects++;
+                                    numNeighbors++;
+
+                                    // continue so we later add the neighbors too
+                                    continue;
+                                }
                             }
 
                         }
 
                         // didn't pass above test...so don't add it or nearby objects
-                        nearby.mList[j] = nearby.mList.last();
-                        nearby.mList.decrement();
+                        nearby[j] = nearby.last();
+                        nearby.decrement();
                         j--;
                     }
                     obj->mNetFlags.set(GameBase::NetNearbyAdded);
@@ -647,6 +843,11 @@ void ProcessList::clientCatchup(GameConnection* connection, S32 catchup)
             }
         }
     }
+    else if (mForceHifiReset)
+    {
+        // everything is rolled back below
+        mDeferredCatchup.clear();
+    }
 
     // save water mark -- for game base list
     FrameAllocatorMarker mark;
@@ -767,6 +968,16 @@ void ProcessList::clientCatchup(GameConnection* connection, S32 catchup)
     }
     connection->clearMoves(catchup);
 
+    if (smLogCatchup)
+    {
+        U32 numObjects = 0;
+        for (ProcessObject* walk = list.mProcessLink.next; walk != &list; walk = walk->mProcessLink.next)
+            numObjects++;
+        Con::printf("clientCatchup: %d ticks, %d objects (%d updated, %d neighbors, %d deferred), %d object ticks, %dms%s",
+            catchup, numObjects, numUpdated, numNeighbors, numDeferred, numObjects * catchup,
+            Platform::getRealMilliseconds() - startTime, mForceHifiReset ? " reset" : "");
+    }
+
     // Handle network error smoothing here...but only for control object
     GameBase* control = connection->getControlObject();
     if (control && !control->isNewGhost())
@@ -51,6 +51,10 @@ class ProcessList
     SimTime mTotalTicks;
     static bool mDebugControlSync;
 
+    /// Neighbors clientCatchup found but had no budget left for.  They are
+    /// rolled back and replayed by the next catch-up.
+    Vector<SimObjectId> mDeferredCatchup;
+
     void orderList();
     void advanceObjects();
 
@@ -71,6 +75,14 @@ public:
     void ageTickCache(S32 numToAge, S32 len);
     void updateMoveSync(S32 moveDiff);
     void clientCatchup(GameConnection* connection, S32 catchup);
+
+    /// Most object ticks one clientCatchup replays.  Objects the server
+    /// updated and the control object are always replayed, the budget caps
+    /// the neighbors pulled in alongside them.  0 means no cap.
+    static S32 smCatchupBudget;
+
+    /// Print the cost of every clientCatchup.
+    static bool smLogCatchup;
     void forceHifiReset(bool reset) { mForceHifiReset = reset; }
     SimTime getTotalTicks() { return mTotalTicks; }
 
@@ -21,13 +21,15 @@
 #include "lightingSystem/sgLightObject.h"
 #include "sim/netConnection.h"
 
+#ifdef TORQUE_SUPPORTS_SSE
+#include <xmmintrin.h>
+#endif
+
 IMPLEMENT_CONOBJECT(SceneObject);
 
-const U32 Container::csmNumBins = 16;
-const F32 Container::csmBinSize = 64;
-const F32 Container::csmTotalBinSize = Container::csmBinSize * Container::csmNumBins;
+const F32 Container::csmTreeMargin = 1.0f;
 U32       Container::smCurrSeqKey = 1;
-const U32 Container::csmRefPoolBlockSize = 4096;
+U32       Container::smRevisionTypes = 0;
 
 // Statics used by buildPolyList methods
 AbstractPolyList* sPolyList;
@@ -249,78 +251,6 @@ ConsoleFunction(containerRayCast, const char*, 4, 5, "( Point3F start, Point3F e
 
 ConsoleFunctionGroupEnd(Containers);
 
-// Utility method for bin insertion
-void getBinRange(const F32 min,
-    const F32 max,
-    U32& minBin,
-    U32& maxBin)
-{
-    AssertFatal(max >= min, "Error, bad range! in getBinRange");
-
-    if ((max - min) >= (Container::csmTotalBinSize - Container::csmBinSize))
-    {
-        F32 minCoord = mFmod(min, Container::csmTotalBinSize);
-        if (minCoord < 0.0f)
-        {
-            minCoord += Container::csmTotalBinSize;
-
-            // This is truly lame, but it can happen.  There must be a better way to
-            //  deal with this.
-            if (minCoord == Container::csmTotalBinSize)
-                minCoord = Container::csmTotalBinSize - 0.01;
-        }
-
-        AssertFatal(minCoord >= 0.0 && minCoord < Container::csmTotalBinSize, "Bad minCoord");
-
-        minBin = U32(minCoord / Container::csmBinSize);
-        AssertFatal(minBin < Container::csmNumBins, avar("Error, bad clipping! (%g, %d)", minCoord, minBin));
-
-        maxBin = minBin + (Container::csmNumBins - 1);
-        return;
-    }
-    else
-    {
-
-        F32 minCoord = mFmod(min, Container::csmTotalBinSize);
-
-        if (minCoord < 0.0f)
-        {
-            minCoord += Container::csmTotalBinSize;
-
-            // This is truly lame, but it can happen.  There must be a better way to
-            //  deal with this.
-            if (minCoord == Container::csmTotalBinSize)
-                minCoord = Container::csmTotalBinSize - 0.01;
-        }
-        AssertFatal(minCoord >= 0.0 && minCoord < Container::csmTotalBinSize, "Bad minCoord");
-
-        F32 maxCoord = mFmod(max, Container::csmTotalBinSize);
-        if (maxCoord < 0.0f) {
-            maxCoord += Container::csmTotalBinSize;
-
-            // This is truly lame, but it can happen.  There must be a better way to
-            //  deal with this.
-            if (maxCoord == Container::csmTotalBinSize)
-                maxCoord = Container::csmTotalBinSize - 0.01;
-        }
-        AssertFatal(maxCoord >= 0.0 && maxCoord < Container::csmTotalBinSize, "Bad maxCoord");
-
-        minBin = U32(minCoord / Container::csmBinSize);
-        maxBin = U32(maxCoord / Container::csmBinSize);
-        AssertFatal(minBin < Container::csmNumBins, avar("Error, bad clipping(min)! (%g, %d)", maxCoord, minBin));
-        AssertFatal(minBin < Container::csmNumBins, avar("Error, bad clipping(max)! (%g, %d)", maxCoord, maxBin));
-
-        // MSVC6 seems to be generating some bad floating point code around
-        // here when full optimizations are on.  The min != max test should
-        // not be needed, but it clears up the VC issue.
-        if (min != max && minCoord > maxCoord)
-            maxBin += Container::csmNumBins;
-
-        AssertFatal(maxBin >= minBin, "Error, min should always be less than max!");
-    }
-}
-
-
 //--------------------------------------------------------------------------
 //-------------------------------------- SceneObject implementation
 //
@@ -357,7 +287,7 @@ SceneObject::SceneObject()
 
     mContainerSeqKey = 0;
 
-    mBinRefHead = NULL;
+    mContainerProxy = Container::NoProxy;
 
     mSceneManager = NULL;
     mZoneRangeStart = 0xFFFFFFFF;
@@ -368,11 +298,6 @@ SceneObject::SceneObject()
     mLastState = NULL;
     mLastStateKey = 0;
 
-    mBinMinX = 0xFFFFFFFF;
-    mBinMaxX = 0xFFFFFFFF;
-    mBinMinY = 0xFFFFFFFF;
-    mBinMaxY = 0xFFFFFFFF;
-
     mHidden = false;
 
 #ifdef MB_ULTRA
@@ -384,7 +309,7 @@ SceneObject::~SceneObject()
 {
     AssertFatal(mZoneRangeStart == 0xFFFFFFFF && mSceneManager == NULL,
         "Error, SceneObject not properly removed from sceneGraph");
-    AssertFatal(mZoneRefHead == NULL && mBinRefHead == NULL,
+    AssertFatal(mZoneRefHead == NULL && mContainerProxy == Container::NoProxy,
         "Error, still linked in reference lists!");
 
     unlink();
@@ -602,7 +527,7 @@ void SceneObject::setTransform(const MatrixF& mat)
         mSceneManager->zoneRemove(this);
         mSceneManager->zoneInsert(this);
         if (getContainer())
-            getContainer()->checkBins(this);
+            getContainer()->checkTree(this);
     }
 
     if (isClientObject() || gSPMode)
@@ -623,7 +548,7 @@ void SceneObject::setScale(const VectorF& scale)
         mSceneManager->zoneRemove(this);
         mSceneManager->zoneInsert(this);
         if (getContainer())
-            getContainer()->checkBins(this);
+            getContainer()->checkTree(this);
     }
 
     if (isClientObject() || gSPMode)
@@ -831,6 +756,7 @@ Container gClientContainer;
 Container gSPModeContainer;
 
 Container::Container()
+    : mTree(csmTreeMargin)
 {
     mEnd.next = mEnd.prev = &mStart;
     mStart.next = mStart.prev = &mEnd;
@@ -844,54 +770,34 @@ Container::Container()
         sBoxPolyhedron.buildBox(imat, box);
     }
 
-    mBinArray = new SceneObjectRef[csmNumBins * csmNumBins];
-    for (U32 i = 0; i < csmNumBins; i++)
-    {
-        U32 base = i * csmNumBins;
-        for (U32 j = 0; j < csmNumBins; j++)
-        {
-            mBinArray[base + j].object = NULL;
-            mBinArray[base + j].nextInBin = NULL;
-            mBinArray[base + j].prevInBin = NULL;
-            mBinArray[base + j].nextInObj = NULL;
-        }
-    }
-    mOverflowBin.object = NULL;
-    mOverflowBin.nextInBin = NULL;
-    mOverflowBin.prevInBin = NULL;
-    mOverflowBin.nextInObj = NULL;
-
-    VECTOR_SET_ASSOCIATION(mRefPoolBlocks);
+    VECTOR_SET_ASSOCIATION(mOverflowList);
+    VECTOR_SET_ASSOCIATION(mQueryLists);
     VECTOR_SET_ASSOCIATION(mSearchList);
 
-    mFreeRefPool = NULL;
-    addRefPoolBlock();
+    mQueryDepth = 0;
+    mTypeRevision = 0;
 
     cleanupSearchVectors();
 }
 
 Container::~Container()
 {
-    for (U32 i = 0; i < mRefPoolBlocks.size(); i++)
+    for (Link* itr = mStart.next; itr != &mEnd; itr = itr->next)
     {
-        SceneObjectRef* pool = mRefPoolBlocks[i];
-        for (U32 j = 0; j < csmRefPoolBlockSize; j++)
-        {
-            // Depressingly, this can give weird results if its pointing at bad memory...
-            if (pool[j].object != NULL)
-                Con::warnf("Error, a %s (%x) isn't properly out of the bins!", pool[j].object->getClassName(), pool[j].object);
-
-            // If you're getting this it means that an object created didn't
-            // remove itself from its container before we destroyed the
-            // container. Typically you get this behavior from particle
-            // emitters, as they try to hang around until all their particles
-            // die. In general it's benign, though if you get it for things
-            // that aren't particle emitters it can be a bad sign!
-        }
-
-        delete[] pool;
+        SceneObject* obj = static_cast<SceneObject*>(itr);
+
+        // If you're getting this it means that an object created didn't
+        // remove itself from its container before we destroyed the
+        // container. Typically you get this behavior from particle
+        // emitters, as they try to hang around until all their particles
+        // die. In general it's benign, though if you get it for things
+        // that aren't particle emitters it can be a bad sign!
+        Con::warnf("Error, a %s (%x) isn't properly out of the container!", obj->getClassName(), obj);
+        obj->mContainerProxy = NoProxy;
     }
-    mFreeRefPool = NULL;
+
+    for (U32 i = 0; i < mQueryLists.size(); i++)
+        delete mQueryLists[i];
 
     cleanupSearchVectors();
 }
@@ -901,275 +807,141 @@ bool Container::addObject(SceneObject* obj)
     AssertFatal(obj->mContainer == NULL, "Adding already added object.");
     obj->mContainer = this;
     obj->linkAfter(&mStart);
+    if (obj->getTypeMask() & smRevisionTypes)
+        mTypeRevision++;
 
-    insertIntoBins(obj);
+    insertIntoTree(obj);
     return true;
 }
 
 bool Container::removeObject(SceneObject* obj)
 {
     AssertFatal(obj->mContainer == this, "Trying to remove from wrong container.");
-    removeFromBins(obj);
+    removeFromTree(obj);
+    if (obj->getTypeMask() & smRevisionTypes)
+        mTypeRevision++;
 
     obj->mContainer = 0;
     obj->unlink();
     return true;
 }
 
-void Container::addRefPoolBlock()
-{
-    mRefPoolBlocks.push_back(new SceneObjectRef[csmRefPoolBlockSize]);
-    for (U32 i = 0; i < csmRefPoolBlockSize - 1; i++)
-    {
-        mRefPoolBlocks.last()[i].object = NULL;
-        mRefPoolBlocks.last()[i].prevInBin = NULL;
-        mRefPoolBlocks.last()[i].nextInBin = NULL;
-        mRefPoolBlocks.last()[i].nextInObj = &(mRefPoolBlocks.last()[i + 1]);
-    }
-    mRefPoolBlocks.last()[csmRefPoolBlockSize - 1].object = NULL;
-    mRefPoolBlocks.last()[csmRefPoolBlockSize - 1].prevInBin = NULL;
-    mRefPoolBlocks.last()[csmRefPoolBlockSize - 1].nextInBin = NULL;
-    mRefPoolBlocks.last()[csmRefPoolBlockSize - 1].nextInObj = mFreeRefPool;
-
-    mFreeRefPool = &(mRefPoolBlocks.last()[0]);
-}
 
-
-void Container::insertIntoBins(SceneObject* obj)
+void Container::insertIntoTree(SceneObject* obj)
 {
     AssertFatal(obj != NULL, "No object?");
-    AssertFatal(obj->mBinRefHead == NULL, "Error, already have a bin chain!");
-
-    // The first thing we do is find which bins are covered in x and y...
-    const Box3F* pWBox = &obj->getWorldBox();
-
-    U32 minX, maxX, minY, maxY;
-    getBinRange(pWBox->min.x, pWBox->max.x, minX, maxX);
-    getBinRange(pWBox->min.y, pWBox->max.y, minY, maxY);
-
-    // Store the current regions for later queries
-    obj->mBinMinX = minX;
-    obj->mBinMaxX = maxX;
-    obj->mBinMinY = minY;
-    obj->mBinMaxY = maxY;
+    AssertFatal(obj->mContainerProxy == NoProxy, "Error, already in the container tree!");
 
-    // For huge objects, dump them into the overflow bin.  Otherwise, everything
-    //  goes into the grid...
-    if ((maxX - minX + 1) < csmNumBins || (maxY - minY + 1) < csmNumBins && !obj->isGlobalBounds())
+    if (obj->isGlobalBounds())
     {
-        SceneObjectRef** pCurrInsert = &obj->mBinRefHead;
-
-        for (U32 i = minY; i <= maxY; i++)
-        {
-            U32 insertY = i % csmNumBins;
-            U32 base = insertY * csmNumBins;
-            for (U32 j = minX; j <= maxX; j++)
-            {
-                U32 insertX = j % csmNumBins;
-
-                SceneObjectRef* ref = allocateObjectRef();
-
-                ref->object = obj;
-                ref->nextInBin = mBinArray[base + insertX].nextInBin;
-                ref->prevInBin = &mBinArray[base + insertX];
-                ref->nextInObj = NULL;
-
-                if (mBinArray[base + insertX].nextInBin)
-                    mBinArray[base + insertX].nextInBin->prevInBin = ref;
-                mBinArray[base + insertX].nextInBin = ref;
-
-                *pCurrInsert = ref;
-                pCurrInsert = &ref->nextInObj;
-            }
-        }
+        mOverflowList.push_back(obj);
+        obj->mContainerProxy = OverflowProxy;
     }
     else
-    {
-        SceneObjectRef* ref = allocateObjectRef();
-
-        ref->object = obj;
-        ref->nextInBin = mOverflowBin.nextInBin;
-        ref->prevInBin = &mOverflowBin;
-        ref->nextInObj = NULL;
-
-        if (mOverflowBin.nextInBin)
-            mOverflowBin.nextInBin->prevInBin = ref;
-        mOverflowBin.nextInBin = ref;
-
-        obj->mBinRefHead = ref;
-    }
+        obj->mContainerProxy = mTree.createProxy(obj->getWorldBox(), obj);
 }
 
-void Container::insertIntoBins(SceneObject* obj,
-    U32 minX, U32 maxX,
-    U32 minY, U32 maxY)
+void Container::removeFromTree(SceneObject* obj)
 {
-    PROFILE_START(InsertBins);
+    PROFILE_START(RemoveFromTree);
     AssertFatal(obj != NULL, "No object?");
 
-    AssertFatal(obj->mBinRefHead == NULL, "Error, already have a bin chain!");
-    // Store the current regions for later queries
-    obj->mBinMinX = minX;
-    obj->mBinMaxX = maxX;
-    obj->mBinMinY = minY;
-    obj->mBinMaxY = maxY;
-
-    // For huge objects, dump them into the overflow bin.  Otherwise, everything
-    //  goes into the grid...
-    //
-    if ((maxX - minX + 1) < csmNumBins || (maxY - minY + 1) < csmNumBins && !obj->isGlobalBounds())
+    if (obj->mContainerProxy == OverflowProxy)
     {
-        SceneObjectRef** pCurrInsert = &obj->mBinRefHead;
-
-        for (U32 i = minY; i <= maxY; i++)
+        for (U32 i = 0; i < mOverflowList.size(); i++)
         {
-            U32 insertY = i % csmNumBins;
-            U32 base = insertY * csmNumBins;
-            for (U32 j = minX; j <= maxX; j++)
+            if (mOverflowList[i] == obj)
             {
-                U32 insertX = j % csmNumBins;
-
-                SceneObjectRef* ref = allocateObjectRef();
-
-                ref->object = obj;
-                ref->nextInBin = mBinArray[base + insertX].nextInBin;
-                ref->prevInBin = &mBinArray[base + insertX];
-                ref->nextInObj = NULL;
-
-                if (mBinArray[base + insertX].nextInBin)
-                    mBinArray[base + insertX].nextInBin->prevInBin = ref;
-                mBinArray[base + insertX].nextInBin = ref;
-
-                *pCurrInsert = ref;
-                pCurrInsert = &ref->nextInObj;
+                mOverflowList.erase_fast(i);
+                break;
             }
         }
     }
-    else
-    {
-        SceneObjectRef* ref = allocateObjectRef();
+    else if (obj->mContainerProxy != NoProxy)
+        mTree.destroyProxy(obj->mContainerProxy);
 
-        ref->object = obj;
-        ref->nextInBin = mOverflowBin.nextInBin;
-        ref->prevInBin = &mOverflowBin;
-        ref->nextInObj = NULL;
+    obj->mContainerProxy = NoProxy;
 
-        if (mOverflowBin.nextInBin)
-            mOverflowBin.nextInBin->prevInBin = ref;
-        mOverflowBin.nextInBin = ref;
-        obj->mBinRefHead = ref;
+    // An object going away from inside a query callback mustn't be handed
+    // to the rest of that query's callbacks.
+    for (U32 i = 0; i < mQueryDepth; i++)
+    {
+        Vector<SceneObject*>& list = *mQueryLists[i];
+        for (U32 j = 0; j < list.size(); j++)
+            if (list[j] == obj)
+                list[j] = NULL;
     }
     PROFILE_END();
 }
 
-void Container::removeFromBins(SceneObject* obj)
+
+void Container::checkTree(SceneObject* obj)
 {
-    PROFILE_START(RemoveFromBins);
     AssertFatal(obj != NULL, "No object?");
 
-    SceneObjectRef* chain = obj->mBinRefHead;
-    obj->mBinRefHead = NULL;
-
-    while (chain)
-    {
-        SceneObjectRef* trash = chain;
-        chain = chain->nextInObj;
-
-        AssertFatal(trash->prevInBin != NULL, "Error, must have a previous entry in the bin!");
-        if (trash->nextInBin)
-            trash->nextInBin->prevInBin = trash->prevInBin;
-        trash->prevInBin->nextInBin = trash->nextInBin;
-
-        freeObjectRef(trash);
-    }
+    PROFILE_START(CheckTree);
+    if (obj->mContainerProxy == NoProxy)
+        insertIntoTree(obj);
+    else if (obj->mContainerProxy != OverflowProxy)
+        mTree.moveProxy(obj->mContainerProxy, obj->getWorldBox());
     PROFILE_END();
 }
 
 
-void Container::checkBins(SceneObject* obj)
+//----------------------------------------------------------------------------
+
+struct ContainerQueryCallback
 {
-    AssertFatal(obj != NULL, "No object?");
+    const AABBTree* tree;
+    const Box3F* box;
+    Vector<SceneObject*>* list;
 
-    PROFILE_START(CheckBins);
-    if (obj->mBinRefHead == NULL)
+    bool queryCallback(S32 proxy)
     {
-        insertIntoBins(obj);
-        PROFILE_END();
-        return;
+        // The tree only knows the enlarged leaf box
+        SceneObject* obj = static_cast<SceneObject*>(tree->getUserData(proxy));
+        if (obj->getWorldBox().isOverlapped(*box))
+            list->push_back(obj);
+        return true;
     }
+};
 
-    // Otherwise, the object is already in the bins.  Let's see if it has strayed out of
-    //  the bins that it's currently in...
-    const Box3F* pWBox = &obj->getWorldBox();
+Vector<SceneObject*>& Container::beginQuery(const Box3F& box)
+{
+    if (mQueryDepth == mQueryLists.size())
+        mQueryLists.push_back(new Vector<SceneObject*>(__FILE__, __LINE__));
 
-    U32 minX, maxX, minY, maxY;
-    getBinRange(pWBox->min.x, pWBox->max.x, minX, maxX);
-    getBinRange(pWBox->min.y, pWBox->max.y, minY, maxY);
+    Vector<SceneObject*>& list = *mQueryLists[mQueryDepth++];
+    list.clear();
 
-    if (obj->mBinMinX != minX || obj->mBinMaxX != maxX ||
-        obj->mBinMinY != minY || obj->mBinMaxY != maxY)
-    {
-        // We have to rebin the object
-        removeFromBins(obj);
-        insertIntoBins(obj, minX, maxX, minY, maxY);
-    }
-    PROFILE_END();
-}
+    // The callbacks run after the tree walk, so they can move objects
+    // around without pulling the tree out from under us.
+    ContainerQueryCallback callback;
+    callback.tree = &mTree;
+    callback.box = &box;
+    callback.list = &list;
+    mTree.query(box, &callback);
+
+    for (U32 i = 0; i < mOverflowList.size(); i++)
+        list.push_back(mOverflowList[i]);
 
+    return list;
+}
 
 void Container::findObjects(const Box3F& box, U32 mask, FindCallback callback, void* key)
 {
     PROFILE_START(ContainerFindObjects);
-    U32 minX, maxX, minY, maxY;
-    getBinRange(box.min.x, box.max.x, minX, maxX);
-    getBinRange(box.min.y, box.max.y, minY, maxY);
-    smCurrSeqKey++;
-    for (U32 i = minY; i <= maxY; i++)
+    Vector<SceneObject*>& list = beginQuery(box);
+    for (U32 i = 0; i < list.size(); i++)
     {
-        U32 insertY = i % csmNumBins;
-        U32 base = insertY * csmNumBins;
-        for (U32 j = minX; j <= maxX; j++)
+        SceneObject* obj = list[i];
+        if (obj && (obj->getType() & mask) != 0 &&
+            obj->isCollisionEnabled() && !obj->isHidden())
         {
-            U32 insertX = j % csmNumBins;
-
-            SceneObjectRef* chain = mBinArray[base + insertX].nextInBin;
-            while (chain)
-            {
-                if (chain->object->getContainerSeqKey() != smCurrSeqKey)
-                {
-                    chain->object->setContainerSeqKey(smCurrSeqKey);
-
-                    if ((chain->object->getType() & mask) != 0 &&
-                        chain->object->isCollisionEnabled() && !chain->object->isHidden())
-                    {
-                        if (chain->object->getWorldBox().isOverlapped(box) || chain->object->isGlobalBounds())
-                        {
-                            (*callback)(chain->object, key);
-                        }
-                    }
-                }
-                chain = chain->nextInBin;
-            }
-        }
-    }
-    SceneObjectRef* chain = mOverflowBin.nextInBin;
-    while (chain)
-    {
-        if (chain->object->getContainerSeqKey() != smCurrSeqKey)
-        {
-            chain->object->setContainerSeqKey(smCurrSeqKey);
-
-            if ((chain->object->getType() & mask) != 0 &&
-                chain->object->isCollisionEnabled() && !chain->object->isHidden())
-            {
-                if (chain->object->getWorldBox().isOverlapped(box) || chain->object->isGlobalBounds())
-                {
-                    (*callback)(chain->object, key);
-                }
-            }
+            (*callback)(obj, key);
         }
-        chain = chain->nextInBin;
     }
+    endQuery();
     PROFILE_END();
 }
 
@@ -1186,322 +958,450 @@ void Container::polyhedronFindObjects(const Polyhedron& polyhedron, U32 mask, Fi
         box.max.setMax(polyhedron.pointList[i]);
     }
 
-    U32 minX, maxX, minY, maxY;
-    getBinRange(box.min.x, box.max.x, minX, maxX);
-    getBinRange(box.min.y, box.max.y, minY, maxY);
-    smCurrSeqKey++;
-    for (i = minY; i <= maxY; i++)
+    Vector<SceneObject*>& list = beginQuery(box);
+    for (i = 0; i < list.size(); i++)
     {
-        U32 insertY = i % csmNumBins;
-        U32 base = insertY * csmNumBins;
-        for (U32 j = minX; j <= maxX; j++)
-        {
-            U32 insertX = j % csmNumBins;
+        SceneObject* obj = list[i];
+        if (obj && (obj->getType() & mask) != 0 && obj->isCollisionEnabled())
+            (*callback)(obj, key);
+    }
+    endQuery();
+}
 
-            SceneObjectRef* chain = mBinArray[base + insertX].nextInBin;
-            while (chain)
-            {
-                if (chain->object->getContainerSeqKey() != smCurrSeqKey)
-                {
-                    chain->object->setContainerSeqKey(smCurrSeqKey);
 
-                    if ((chain->object->getType() & mask) != 0 &&
-                        chain->object->isCollisionEnabled())
-                    {
-                        if (chain->object->getWorldBox().isOverlapped(box) || chain->object->isGlobalBounds())
-                        {
-                            (*callback)(chain->object, key);
-                        }
-                    }
-                }
-                chain = chain->nextInBin;
-            }
-        }
-    }
-    SceneObjectRef* chain = mOverflowBin.nextInBin;
-    while (chain)
+//----------------------------------------------------------------------------
+
+/// Bump a hit's normal from the object's space into worldspace.
+static void transformRayNormal(RayInfo* info)
+{
+    PlaneF fakePlane;
+    fakePlane.x = info->normal.x;
+    fakePlane.y = info->normal.y;
+    fakePlane.z = info->normal.z;
+    fakePlane.d = 0;
+
+    PlaneF result;
+    mTransformPlane(info->object->getTransform(), info->object->getScale(), fakePlane, &result);
+    info->normal = result;
+}
+
+struct ContainerRayCastCallback
+{
+    const AABBTree* tree;
+    Point3F start;
+    Point3F end;
+    U32 mask;
+    RayInfo* info;
+    F32 currentT;
+
+    void castObject(SceneObject* ptr)
     {
-        if (chain->object->getContainerSeqKey() != smCurrSeqKey)
+        Point3F xformedStart, xformedEnd;
+        ptr->getWorldTransform().mulP(start, &xformedStart);
+        ptr->getWorldTransform().mulP(end, &xformedEnd);
+        xformedStart.convolveInverse(ptr->getScale());
+        xformedEnd.convolveInverse(ptr->getScale());
+
+        RayInfo ri;
+        if (ptr->castRay(xformedStart, xformedEnd, &ri))
         {
-            chain->object->setContainerSeqKey(smCurrSeqKey);
-
-            if ((chain->object->getType() & mask) != 0 &&
-                chain->object->isCollisionEnabled())
+            if (ri.t < currentT)
             {
-                if (chain->object->getWorldBox().isOverlapped(box) || chain->object->isGlobalBounds())
-                {
-                    (*callback)(chain->object, key);
-                }
+                *info = ri;
+                info->point.interpolate(start, end, info->t);
+                currentT = ri.t;
             }
         }
-        chain = chain->nextInBin;
     }
-}
 
+    F32 rayCastCallback(S32 proxy, F32 maxT)
+    {
+        SceneObject* ptr = static_cast<SceneObject*>(tree->getUserData(proxy));
+        if ((ptr->getType() & mask) != 0 && ptr->isCollisionEnabled() &&
+            ptr->getWorldBox().collideLine(start, end))
+        {
+            castObject(ptr);
+        }
+
+        // Nothing past the closest hit so far can matter
+        return getMin(maxT, currentT);
+    }
+};
 
-//----------------------------------------------------------------------------
-// DMMNOTE: There are still some optimizations to be done here.  In particular:
-//           - After checking the overflow bin, we can potentially shorten the line
-//             that we rasterize against the grid if there is a collision with say,
-//             the terrain.
-//           - The optimal grid size isn't necessarily what we have set here. possibly
-//             a resolution of 16 meters would give better results
-//           - The line rasterizer is pretty lame.  Unfortunately we can't use a
-//             simple bres. here, since we need to check every grid element that the line
-//             passes through, which bres does _not_ do for us.  Possibly there's a
-//             rasterizer for anti-aliased lines that will serve better than what
-//             we have below.
-//
 bool Container::castRay(const Point3F& start, const Point3F& end, U32 mask, RayInfo* info)
 {
     PROFILE_START(ContainerCastRay);
-    F32 currentT = 2.0;
-    smCurrSeqKey++;
 
-    SceneObjectRef* chain = mOverflowBin.nextInBin;
-    while (chain)
-    {
-        SceneObject* ptr = chain->object;
-        if (ptr->getContainerSeqKey() != smCurrSeqKey)
-        {
-            ptr->setContainerSeqKey(smCurrSeqKey);
+    ContainerRayCastCallback callback;
+    callback.tree = &mTree;
+    callback.start = start;
+    callback.end = end;
+    callback.mask = mask;
+    callback.info = info;
+    callback.currentT = 2.0;
 
-            // In the overflow bin, the world box is always going to intersect the line,
-            //  so we can omit that test...
-            if ((ptr->getType() & mask) != 0 &&
-                ptr->isCollisionEnabled() == true)
-            {
-                Point3F xformedStart, xformedEnd;
-                ptr->mWorldToObj.mulP(start, &xformedStart);
-                ptr->mWorldToObj.mulP(end, &xformedEnd);
-                xformedStart.convolveInverse(ptr->mObjScale);
-                xformedEnd.convolveInverse(ptr->mObjScale);
-
-                RayInfo ri;
-                if (ptr->castRay(xformedStart, xformedEnd, &ri))
-                {
-                    if (ri.t < currentT)
-                    {
-                        *info = ri;
-                        info->point.interpolate(start, end, info->t);
-                        currentT = ri.t;
-                    }
-                }
-            }
-        }
-        chain = chain->nextInBin;
+    // Global objects always intersect the line, so we can omit that test...
+    for (U32 i = 0; i < mOverflowList.size(); i++)
+    {
+        SceneObject* ptr = mOverflowList[i];
+        if ((ptr->getType() & mask) != 0 && ptr->isCollisionEnabled())
+            callback.castObject(ptr);
     }
 
-    // These are just for rasterizing the line against the grid.  We want the x coord
-    //  of the start to be <= the x coord of the end
-    Point3F normalStart, normalEnd;
-    if (start.x <= end.x)
+    mTree.rayCast(start, end, &callback);
+
+    // Bump the normal into worldspace if appropriate.
+    if (callback.currentT != 2)
     {
-        normalStart = start;
-        normalEnd = end;
+        transformRayNormal(info);
+
+        PROFILE_END();
+        return true;
     }
     else
     {
-        normalStart = end;
-        normalEnd = start;
+        // Do nothing and exit...
+        PROFILE_END();
+        return false;
     }
 
-    // Ok, let's scan the grids.  The simplest way to do this will be to scan across in
-    //  x, finding the y range for each affected bin...
-    U32 minX, maxX;
-    U32 minY, maxY;
-    //if (normalStart.x == normalEnd.x)
-    //   Con::printf("X start = %g, end = %g", normalStart.x, normalEnd.x);
-
-    getBinRange(normalStart.x, normalEnd.x, minX, maxX);
-    getBinRange(getMin(normalStart.y, normalEnd.y),
-        getMax(normalStart.y, normalEnd.y), minY, maxY);
-
-    //if (normalStart.x == normalEnd.x && minX != maxX)
-    //   Con::printf("X min = %d, max = %d", minX, maxX);
-    //if (normalStart.y == normalEnd.y && minY != maxY)
-    //   Con::printf("Y min = %d, max = %d", minY, maxY);
-
-       // We'll optimize the case that the line is contained in one bin row or column, which
-       //  will be quite a few lines.  No sense doing more work than we have to...
-       //
-    if ((mFabs(normalStart.x - normalEnd.x) < csmTotalBinSize && minX == maxX) ||
-        (mFabs(normalStart.y - normalEnd.y) < csmTotalBinSize && minY == maxY))
+}
+
+//----------------------------------------------------------------------------
+// Batched ray casts.  Rays are tested against candidate boxes in packets of
+// four, laid out one axis per array so the slab test runs across the packet.
+
+namespace {
+
+enum { RayPacketSize = 4 };
+
+struct RayPacket
+{
+    F32 start[3][RayPacketSize];
+    F32 invDir[3][RayPacketSize];
+
+    /// Closest hit so far for each ray, negative for unused lanes.
+    F32 maxT[RayPacketSize];
+
+    U32 count;
+
+    void set(const Container::RayQuery* rays, U32 num)
     {
-        U32 count;
-        U32 incX, incY;
-        if (minX == maxX)
+        count = num;
+        for (U32 lane = 0; lane < RayPacketSize; lane++)
         {
-            count = maxY - minY + 1;
-            incX = 0;
-            incY = 1;
+            const Container::RayQuery& ray = rays[lane < num ? lane : 0];
+            for (U32 axis = 0; axis < 3; axis++)
+            {
+                // Axis parallel rays get a huge rather than infinite
+                // reciprocal, so the slab test never produces a NaN.
+                // This only ever lets an extra box through.
+                F32 d = ray.end[axis] - ray.start[axis];
+                if (mFabs(d) < 1e-9f)
+                    d = d < 0.0f ? -1e-9f : 1e-9f;
+
+                start[axis][lane] = ray.start[axis];
+                invDir[axis][lane] = 1.0f / d;
+            }
+            maxT[lane] = lane < num ? 2.0f : -1.0f;
         }
-        else
+    }
+
+    /// Returns a bit per ray whose segment, up to its closest hit, touches
+    /// the box.
+    U32 overlaps(const Box3F& box) const
+    {
+#ifdef TORQUE_SUPPORTS_SSE
+        __m128 tMin = _mm_setzero_ps();
+        __m128 tMax = _mm_loadu_ps(maxT);
+        for (U32 axis = 0; axis < 3; axis++)
+        {
+            __m128 s = _mm_loadu_ps(start[axis]);
+            __m128 inv = _mm_loadu_ps(invDir[axis]);
+            __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.min[axis]), s), inv);
+            __m128 t2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.max[axis]), s), inv);
+            tMin = _mm_max_ps(tMin, _mm_min_ps(t1, t2));
+            tMax = _mm_min_ps(tMax, _mm_max_ps(t1, t2));
+        }
+        return U32(_mm_movemask_ps(_mm_cmple_ps(tMin, tMax)));
+#else
+        U32 result = 0;
+        for (U32 lane = 0; lane < RayPacketSize; lane++)
         {
-            count = maxX - minX + 1;
-            incX = 1;
-            incY = 0;
+            F32 tMin = 0.0f;
+            F32 tMax = maxT[lane];
+            for (U32 axis = 0; axis < 3; axis++)
+            {
+                F32 t1 = (box.min[axis] - start[axis][lane]) * invDir[axis][lane];
+                F32 t2 = (box.max[axis] - start[axis][lane]) * invDir[axis][lane];
+                tMin = getMax(tMin, getMin(t1, t2));
+                tMax = getMin(tMax, getMax(t1, t2));
+            }
+            if (tMin <= tMax)
+                result |= 1 << lane;
         }
+        return result;
+#endif
+    }
+};
+
+} // namespace
+
+U32 Container::castRays(const RayQuery* rays, U32 count, U32 mask, RayInfo* results)
+{
+    if (count == 0)
+        return 0;
+
+    PROFILE_START(ContainerCastRays);
+
+    Box3F bounds(rays[0].start, rays[0].start, true);
+    for (U32 i = 0; i < count; i++)
+    {
+        bounds.min.setMin(rays[i].start);
+        bounds.min.setMin(rays[i].end);
+        bounds.max.setMax(rays[i].start);
+        bounds.max.setMax(rays[i].end);
+    }
+
+    // One query for the lot, trimmed down to what the mask lets through
+    Vector<SceneObject*>& list = beginQuery(bounds);
+    U32 numCandidates = 0;
+    for (U32 i = 0; i < list.size(); i++)
+    {
+        SceneObject* ptr = list[i];
+        if (ptr && (ptr->getType() & mask) != 0 && ptr->isCollisionEnabled())
+            list[numCandidates++] = ptr;
+    }
+
+    ContainerRayCastCallback callback;
+    callback.tree = &mTree;
+    callback.mask = mask;
+
+    RayPacket packet;
+    U32 hits = 0;
+    for (U32 base = 0; base < count; base += RayPacketSize)
+    {
+        packet.set(rays + base, getMin(count - base, U32(RayPacketSize)));
 
-        U32 x = minX;
-        U32 y = minY;
-        for (U32 i = 0; i < count; i++)
+        for (U32 i = 0; i < numCandidates; i++)
         {
-            U32 checkX = x % csmNumBins;
-            U32 checkY = y % csmNumBins;
+            // Entries are nulled if an object is removed under us
+            SceneObject* ptr = list[i];
+            if (!ptr)
+                continue;
 
-            SceneObjectRef* chain = mBinArray[(checkY * csmNumBins) + checkX].nextInBin;
-            while (chain)
+            U32 lanes = ptr->isGlobalBounds() ? (1 << packet.count) - 1 : packet.overlaps(ptr->getWorldBox());
+            for (U32 lane = 0; lanes != 0; lane++, lanes >>= 1)
             {
-                SceneObject* ptr = chain->object;
-                if (ptr->getContainerSeqKey() != smCurrSeqKey)
-                {
-                    ptr->setContainerSeqKey(smCurrSeqKey);
-
-                    if ((ptr->getType() & mask) != 0 &&
-                        ptr->isCollisionEnabled() == true)
-                    {
-                        if (ptr->getWorldBox().collideLine(start, end) || chain->object->isGlobalBounds())
-                        {
-                            Point3F xformedStart, xformedEnd;
-                            ptr->mWorldToObj.mulP(start, &xformedStart);
-                            ptr->mWorldToObj.mulP(end, &xformedEnd);
-                            xformedStart.convolveInverse(ptr->mObjScale);
-                            xformedEnd.convolveInverse(ptr->mObjScale);
-
-                            RayInfo ri;
-                            if (ptr->castRay(xformedStart, xformedEnd, &ri))
-                            {
-                                if (ri.t < currentT)
-                                {
-                                    *info = ri;
-                                    info->point.interpolate(start, end, info->t);
-                                    currentT = ri.t;
-                                }
-                            }
-                        }
-                    }
-                }
-                chain = chain->nextInBin;
+                if (!(lanes & 1))
+                    continue;
+
+                callback.start = rays[base + lane].start;
+                callback.end = rays[base + lane].end;
+                callback.info = &results[base + lane];
+                callback.currentT = packet.maxT[lane];
+                callback.castObject(ptr);
+                packet.maxT[lane] = callback.currentT;
             }
+        }
 
-            x += incX;
-            y += incY;
+        for (U32 lane = 0; lane < packet.count; lane++)
+        {
+            RayInfo* info = &results[base + lane];
+            if (packet.maxT[lane] != 2.0f)
+            {
+                transformRayNormal(info);
+                hits++;
+            }
+            else
+                info->object = NULL;
         }
     }
-    else
-    {
-        // Oh well, let's earn our keep.  We know that after the above conditional, we're
-        //  going to cross at least one boundary, so that simplifies our job...
 
-        F32 currStartX = normalStart.x;
+    endQuery();
 
-        AssertFatal(currStartX != normalEnd.x, "This is going to cause problems in Container::castRay");
-        while (currStartX != normalEnd.x)
-        {
-            F32 currEndX = getMin(currStartX + csmTotalBinSize, normalEnd.x);
+    PROFILE_END();
+    return hits;
+}
 
-            F32 currStartT = (currStartX - normalStart.x) / (normalEnd.x - normalStart.x);
-            F32 currEndT = (currEndX - normalStart.x) / (normalEnd.x - normalStart.x);
+//----------------------------------------------------------------------------
+// Query benchmark.  Runs a box query and a vertical ray cast around every
+// object in the container, through the tree and by brute force over every
+// object, and reports the average cost of each.  Also times four rays per
+// object cast one at a time against the same four cast with castRays().
 
-            F32 y1 = normalStart.y + (normalEnd.y - normalStart.y) * currStartT;
-            F32 y2 = normalStart.y + (normalEnd.y - normalStart.y) * currEndT;
+static void benchCollectCallback(SceneObject* obj, void* key)
+{
+    static_cast<Vector<SceneObject*>*>(key)->push_back(obj);
+}
 
-            U32 subMinX, subMaxX;
-            getBinRange(currStartX, currEndX, subMinX, subMaxX);
+static void benchCountCallback(SceneObject* obj, void* key)
+{
+    (*static_cast<U32*>(key))++;
+}
 
-            F32 subStartX = currStartX;
-            F32 subEndX = currStartX;
+static void buildBenchRayPacket(const Box3F& box, Container::RayQuery* rays)
+{
+    Point3F center;
+    box.getCenter(&center);
+    F32 dx = box.len_x() * 0.25f;
+    F32 dy = box.len_y() * 0.25f;
 
-            if (currStartX < 0.0f)
-                subEndX -= mFmod(subEndX, csmBinSize);
-            else
-                subEndX += (csmBinSize - mFmod(subEndX, csmBinSize));
+    for (U32 i = 0; i < 4; i++)
+    {
+        F32 x = center.x + (i & 1 ? dx : -dx);
+        F32 y = center.y + (i & 2 ? dy : -dy);
+        rays[i].start.set(x, y, box.max.z + 20);
+        rays[i].end.set(x, y, box.min.z - 20);
+    }
+}
 
-            for (U32 currXBin = subMinX; currXBin <= subMaxX; currXBin++)
-            {
-                U32 checkX = currXBin % csmNumBins;
+static void benchmarkContainer(Container* container, const char* name, U32 iterations)
+{
+    Vector<SceneObject*> objects(__FILE__, __LINE__);
+    container->findObjects(0xFFFFFFFF, benchCollectCallback, &objects);
 
-                F32 subStartT = (subStartX - currStartX) / (currEndX - currStartX);
-                F32 subEndT = getMin(F32((subEndX - currStartX) / (currEndX - currStartX)), 1.f);
+    // Only objects with real bounds make useful query centers
+    Vector<Box3F> queryBoxes(__FILE__, __LINE__);
+    for (U32 i = 0; i < objects.size(); i++)
+    {
+        if (objects[i]->isGlobalBounds())
+            continue;
 
-                F32 subY1 = y1 + (y2 - y1) * subStartT;
-                F32 subY2 = y1 + (y2 - y1) * subEndT;
+        Box3F box = objects[i]->getWorldBox();
+        box.min -= Point3F(5, 5, 5);
+        box.max += Point3F(5, 5, 5);
+        queryBoxes.push_back(box);
+    }
 
-                U32 newMinY, newMaxY;
-                getBinRange(getMin(subY1, subY2), getMax(subY1, subY2), newMinY, newMaxY);
+    Con::printf("%s container: %d objects, %d in tree (height %d), %d global",
+        name, objects.size(), container->getTreeObjectCount(), container->getTreeHeight(),
+        container->getOverflowCount());
 
-                for (U32 i = newMinY; i <= newMaxY; i++)
-                {
-                    U32 checkY = i % csmNumBins;
+    if (queryBoxes.empty() || iterations == 0)
+        return;
 
-                    SceneObjectRef* chain = mBinArray[(checkY * csmNumBins) + checkX].nextInBin;
-                    while (chain)
-                    {
-                        SceneObject* ptr = chain->object;
-                        if (ptr->getContainerSeqKey() != smCurrSeqKey)
-                        {
-                            ptr->setContainerSeqKey(smCurrSeqKey);
-
-                            if ((ptr->getType() & mask) != 0 &&
-                                ptr->isCollisionEnabled() == true)
-                            {
-                                if (ptr->getWorldBox().collideLine(start, end))
-                                {
-                                    Point3F xformedStart, xformedEnd;
-                                    ptr->mWorldToObj.mulP(start, &xformedStart);
-                                    ptr->mWorldToObj.mulP(end, &xformedEnd);
-                                    xformedStart.convolveInverse(ptr->mObjScale);
-                                    xformedEnd.convolveInverse(ptr->mObjScale);
-
-                                    RayInfo ri;
-                                    if (ptr->castRay(xformedStart, xformedEnd, &ri))
-                                    {
-                                        if (ri.t < currentT)
-                                        {
-                                            *info = ri;
-                                            info->point.interpolate(start, end, info->t);
-                                            currentT = ri.t;
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                        chain = chain->nextInBin;
-                    }
-                }
+    const U32 numQueries = queryBoxes.size() * iterations;
+    U32 found = 0, foundLinear = 0;
+    U32 hits = 0, hitsLinear = 0;
+
+    // Box queries
+    U32 start = Platform::getRealMilliseconds();
+    for (U32 n = 0; n < iterations; n++)
+        for (U32 i = 0; i < queryBoxes.size(); i++)
+            container->findObjects(queryBoxes[i], 0xFFFFFFFF, benchCountCallback, &found);
+    U32 treeBoxTime = Platform::getRealMilliseconds() - start;
+
+    start = Platform::getRealMilliseconds();
+    for (U32 n = 0; n < iterations; n++)
+        for (U32 i = 0; i < queryBoxes.size(); i++)
+            for (U32 j = 0; j < objects.size(); j++)
+                if (!objects[j]->isHidden() &&
+                    (objects[j]->isGlobalBounds() || objects[j]->getWorldBox().isOverlapped(queryBoxes[i])))
+                    foundLinear++;
+    U32 linearBoxTime = Platform::getRealMilliseconds() - start;
+
+    // Vertical rays through the middle of each box
+    start = Platform::getRealMilliseconds();
+    for (U32 n = 0; n < iterations; n++)
+    {
+        for (U32 i = 0; i < queryBoxes.size(); i++)
+        {
+            Point3F center;
+            queryBoxes[i].getCenter(&center);
+            Point3F top(center.x, center.y, queryBoxes[i].max.z + 20);
+            Point3F bottom(center.x, center.y, queryBoxes[i].min.z - 20);
+
+            RayInfo info;
+            if (container->castRay(top, bottom, 0xFFFFFFFF, &info))
+                hits++;
+        }
+    }
+    U32 treeRayTime = Platform::getRealMilliseconds() - start;
 
-                subStartX = subEndX;
-                subEndX = getMin(subEndX + csmBinSize, currEndX);
+    start = Platform::getRealMilliseconds();
+    for (U32 n = 0; n < iterations; n++)
+    {
+        for (U32 i = 0; i < queryBoxes.size(); i++)
+        {
+            Point3F center;
+            queryBoxes[i].getCenter(&center);
+
+            RayInfo info;
+            ContainerRayCastCallback callback;
+            callback.start.set(center.x, center.y, queryBoxes[i].max.z + 20);
+            callback.end.set(center.x, center.y, queryBoxes[i].min.z - 20);
+            callback.mask = 0xFFFFFFFF;
+            callback.info = &info;
+            callback.currentT = 2.0;
+
+            for (U32 j = 0; j < objects.size(); j++)
+            {
+                if (objects[j]->isGlobalBounds() || objects[j]->getWorldBox().collideLine(callback.start, callback.end))
+                    callback.castObject(objects[j]);
             }
-
-            currStartX = currEndX;
+            if (callback.currentT != 2.0)
+                hitsLinear++;
         }
     }
+    U32 linearRayTime = Platform::getRealMilliseconds() - start;
 
-    // Bump the normal into worldspace if appropriate.
-    if (currentT != 2)
+    // Packets of four vertical rays spread over each box, one at a time
+    // and batched
+    U32 packetHits = 0, packetHitsBatched = 0;
+    start = Platform::getRealMilliseconds();
+    for (U32 n = 0; n < iterations; n++)
     {
-        PlaneF fakePlane;
-        fakePlane.x = info->normal.x;
-        fakePlane.y = info->normal.y;
-        fakePlane.z = info->normal.z;
-        fakePlane.d = 0;
+        for (U32 i = 0; i < queryBoxes.size(); i++)
+        {
+            Container::RayQuery rays[4];
+            buildBenchRayPacket(queryBoxes[i], rays);
+
+            RayInfo info;
+            for (U32 j = 0; j < 4; j++)
+                if (container->castRay(rays[j].start, rays[j].end, 0xFFFFFFFF, &info))
+                    packetHits++;
+        }
+    }
+    U32 singleRayTime = Platform::getRealMilliseconds() - start;
 
-        PlaneF result;
-        mTransformPlane(info->object->getTransform(), info->object->getScale(), fakePlane, &result);
-        info->normal = result;
+    start = Platform::getRealMilliseconds();
+    for (U32 n = 0; n < iterations; n++)
+    {
+        for (U32 i = 0; i < queryBoxes.size(); i++)
+        {
+            Container::RayQuery rays[4];
+            buildBenchRayPacket(queryBoxes[i], rays);
 
-        PROFILE_END();
-        return true;
+            RayInfo info[4];
+            packetHitsBatched += container->castRays(rays, 4, 0xFFFFFFFF, info);
+        }
     }
+    U32 batchedRayTime = Platform::getRealMilliseconds() - start;
+
+    Con::printf("   box query: %.2fus tree, %.2fus linear (%.1f results each)",
+        treeBoxTime * 1000.0f / numQueries, linearBoxTime * 1000.0f / numQueries, F32(found) / numQueries);
+    Con::printf("   ray cast:  %.2fus tree, %.2fus linear (%d/%d hits)",
+        treeRayTime * 1000.0f / numQueries, linearRayTime * 1000.0f / numQueries, hits, hitsLinear);
+    Con::printf("   4 rays:    %.2fus castRay, %.2fus castRays (%d/%d hits)",
+        singleRayTime * 1000.0f / numQueries, batchedRayTime * 1000.0f / numQueries, packetHits, packetHitsBatched);
+
+    if (found != foundLinear || hits != hitsLinear || packetHits != packetHitsBatched)
+        Con::warnf("   tree and linear results differ!");
+}
+
+ConsoleFunction(containerBenchmark, void, 1, 2, "(int iterations = 10)"
+    "Time box queries and ray casts around every object in the server and client containers.")
+{
+    U32 iterations = argc > 1 ? dAtoi(argv[1]) : 10;
+
+    if (gSPMode)
+        benchmarkContainer(&gSPModeContainer, "Shared", iterations);
     else
     {
-        // Do nothing and exit...
-        PROFILE_END();
-        return false;
+        benchmarkContainer(&gServerContainer, "Server", iterations);
+        benchmarkContainer(&gClientContainer, "Client", iterations);
     }
-
 }
 
 // collide with the objects projected object box
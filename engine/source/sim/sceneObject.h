@@ -21,6 +21,9 @@
 #ifndef _ABSTRACTPOLYLIST_H_
 #include "collision/abstractPolyList.h"
 #endif
+#ifndef _AABBTREE_H_
+#include "collision/aabbTree.h"
+#endif
 #ifndef _OBJECTTYPES_H_
 #include "game/objectTypes.h"
 #endif
@@ -118,20 +121,41 @@ public:
         void* key;
     };
 
-    static const U32 csmNumBins;
-    static const F32 csmBinSize;
-    static const F32 csmTotalBinSize;
-    static const U32 csmRefPoolBlockSize;
+    enum ProxyConstants
+    {
+        NoProxy = AABBTree::NullNode,  ///< Not in the container's spatial index.
+        OverflowProxy = -2,            ///< On the overflow list.
+    };
+
+    /// How far past its world box an object can move before it has to be
+    /// moved in the tree.
+    static const F32 csmTreeMargin;
     static U32    smCurrSeqKey;
 
+    /// Adding or removing an object of one of these types bumps the type
+    /// revision, see getTypeRevision().
+    static U32    smRevisionTypes;
+
 private:
     Link mStart, mEnd;
 
-    SceneObjectRef* mFreeRefPool;
-    Vector<SceneObjectRef*> mRefPoolBlocks;
+    /// Every object with finite bounds, keyed by world box.
+    AABBTree mTree;
 
-    SceneObjectRef* mBinArray;
-    SceneObjectRef  mOverflowBin;
+    /// Objects with global bounds.  They overlap every query, so there's
+    /// no point putting them in the tree.
+    Vector<SceneObject*> mOverflowList;
+
+    /// Scratch lists for queries, one per nesting level, since callbacks
+    /// are free to query the container again.
+    Vector<Vector<SceneObject*>*> mQueryLists;
+    U32 mQueryDepth;
+
+    U32 mTypeRevision;
+
+    /// Gather every object whose world box overlaps box.
+    Vector<SceneObject*>& beginQuery(const Box3F& box);
+    void endQuery() { mQueryDepth--; }
 
 public:
     Container();
@@ -143,6 +167,14 @@ public:
     ///
     typedef void (*FindCallback)(SceneObject*, void* key);
     void findObjects(U32 mask, FindCallback, void* key = NULL);
+
+    /// Every object of the given types, including ones which are hidden or
+    /// have collision turned off for now.
+    void collectObjects(U32 mask, Vector<SceneObject*>& list);
+
+    /// Changes whenever an object of one of the smRevisionTypes types is
+    /// added or removed, so lists of such objects know to rebuild.
+    U32 getTypeRevision() const { return mTypeRevision; }
     void findObjects(const Box3F& box, U32 mask, FindCallback, void* key = NULL);
     void polyhedronFindObjects(const Polyhedron& polyhedron, U32 mask,
         FindCallback, void* key = NULL);
@@ -153,6 +185,22 @@ public:
 
     ///
     bool castRay(const Point3F& start, const Point3F& end, U32 mask, RayInfo* info);
+
+    /// One segment for castRays().
+    struct RayQuery
+    {
+        Point3F start;
+        Point3F end;
+    };
+
+    /// Cast several rays at once.  The objects near all of the rays are
+    /// gathered in a single query, and the rays are tested against their
+    /// boxes four at a time before any object level cast is done.
+    ///
+    /// results[i] is filled in for rays[i] as by castRay(); rays which hit
+    /// nothing get a NULL object.  Returns the number of rays which hit.
+    U32 castRays(const RayQuery* rays, U32 count, U32 mask, RayInfo* results);
+
     bool collideBox(const Point3F& start, const Point3F& end, U32 mask, RayInfo* info);
     /// @}
 
@@ -174,17 +222,19 @@ public:
     bool addObject(SceneObject*);
     bool removeObject(SceneObject*);
 
-    void addRefPoolBlock();
-    SceneObjectRef* allocateObjectRef();
-    void freeObjectRef(SceneObjectRef*);
-    void insertIntoBins(SceneObject*);
-    void removeFromBins(SceneObject*);
+    void insertIntoTree(SceneObject*);
+    void removeFromTree(SceneObject*);
 
-    /// Checkbins makes sure that we're not just sticking the object right back
-    /// where it came from.  The overloaded insertInto is so we don't calculate
-    /// the ranges twice.
-    void checkBins(SceneObject*);
-    void insertIntoBins(SceneObject*, U32, U32, U32, U32);
+    /// Update the object's leaf after its world box changed.  This is free
+    /// unless the object moved out of its leaf's box.
+    void checkTree(SceneObject*);
+
+    /// @name Statistics
+    /// @{
+    U32 getTreeObjectCount() const { return mTree.getProxyCount(); }
+    S32 getTreeHeight() const { return mTree.getHeight(); }
+    U32 getOverflowCount() const { return mOverflowList.size(); }
+    /// @}
 
 
 private:
@@ -737,12 +787,9 @@ protected:
     void    resetRenderWorldBox();
 
     SceneObjectRef* mZoneRefHead;
-    SceneObjectRef* mBinRefHead;
 
-    U32 mBinMinX;
-    U32 mBinMaxX;
-    U32 mBinMinY;
-    U32 mBinMaxY;
+    /// Our leaf in the container's tree, or one of Container::ProxyConstants.
+    S32 mContainerProxy;
 
     /// @}
 
@@ -793,14 +840,14 @@ public:
     void setGlobalBounds()
     {
         if (mContainer)
-            mContainer->removeFromBins(this);
+            mContainer->removeFromTree(this);
 
         mGlobalBounds = true;
         mObjBox.min.set(-1e10, -1e10, -1e10);
         mObjBox.max.set(1e10, 1e10, 1e10);
 
         if (mContainer)
-            mContainer->insertIntoBins(this);
+            mContainer->insertIntoTree(this);
     }
 
 public:
@@ -903,36 +950,21 @@ inline U32 SceneObject::getCurrZone(const U32 index) const
 }
 
 //--------------------------------------------------------------------------
-inline SceneObjectRef* Container::allocateObjectRef()
+inline void Container::findObjects(U32 mask, FindCallback callback, void* key)
 {
-    if (mFreeRefPool == NULL)
-    {
-        addRefPoolBlock();
+    for (Link* itr = mStart.next; itr != &mEnd; itr = itr->next) {
+        SceneObject* ptr = static_cast<SceneObject*>(itr);
+        if ((ptr->getType() & mask) != 0 && !ptr->mCollisionCount)
+            (*callback)(ptr, key);
     }
-    AssertFatal(mFreeRefPool != NULL, "Error, should always have a free reference here!");
-
-    SceneObjectRef* ret = mFreeRefPool;
-    mFreeRefPool = mFreeRefPool->nextInObj;
-
-    ret->nextInObj = NULL;
-    return ret;
-}
-
-inline void Container::freeObjectRef(SceneObjectRef* trash)
-{
-    trash->object = NULL;
-    trash->nextInBin = NULL;
-    trash->prevInBin = NULL;
-    trash->nextInObj = mFreeRefPool;
-    mFreeRefPool = trash;
 }
 
-inline void Container::findObjects(U32 mask, FindCallback callback, void* key)
+inline void Container::collectObjects(U32 mask, Vector<SceneObject*>& list)
 {
     for (Link* itr = mStart.next; itr != &mEnd; itr = itr->next) {
         SceneObject* ptr = static_cast<SceneObject*>(itr);
-        if ((ptr->getType() & mask) != 0 && !ptr->mCollisionCount)
-            (*callback)(ptr, key);
+        if ((ptr->getType() & mask) != 0)
+            list.push_back(ptr);
     }
 }
 
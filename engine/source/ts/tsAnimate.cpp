@@ -4,6 +4,8 @@
 //-----------------------------------------------------------------------------
 
 #include "ts/tsShapeInstance.h"
+#include "platform/profiler.h"
+#include "platform/threadPool.h"
 
 //----------------------------------------------------------------------------------
 // some utility functions
@@ -39,16 +41,60 @@ void TSShapeInstance::clearDirty(U32 dirty)
 // Animate nodes
 //-------------------------------------------------------------------------------------
 
+bool TSShapeInstance::sameAnimSamples(S32 ss)
+{
+    bool same = mLastAnimSubShape == ss && mLastAnimSamples.size() == mThreadList.size();
+    mLastAnimSamples.setSize(mThreadList.size());
+    for (S32 i = 0; i < mThreadList.size(); i++)
+    {
+        const TSThread* th = mThreadList[i];
+        AnimSample& sample = mLastAnimSamples[i];
+        if (same &&
+            sample.sequence == th->sequence &&
+            sample.keyNum1 == th->keyNum1 &&
+            sample.keyNum2 == th->keyNum2 &&
+            sample.keyPos == th->keyPos &&
+            sample.blendDisabled == th->blendDisabled &&
+            sample.inTransition == th->transitionData.inTransition &&
+            sample.transitionPos == th->transitionData.pos)
+            continue;
+
+        same = false;
+        sample.sequence = th->sequence;
+        sample.keyNum1 = th->keyNum1;
+        sample.keyNum2 = th->keyNum2;
+        sample.keyPos = th->keyPos;
+        sample.blendDisabled = th->blendDisabled;
+        sample.inTransition = th->transitionData.inTransition;
+        sample.transitionPos = th->transitionData.pos;
+    }
+
+    // Hands off and callback nodes are moved from outside, so shapes with
+    // them have to animate every time.
+    if (mHandsOffNodes.testAll(mShape->nodes.size()) || mCallbackNodes.testAll(mShape->nodes.size()))
+    {
+        mLastAnimSubShape = -1;
+        return false;
+    }
+
+    mLastAnimSubShape = ss;
+    return same;
+}
+
 void TSShapeInstance::animateNodes(S32 ss)
 {
     if (!mShape->nodes.size())
         return;
 
+    // The transforms are still good if no thread has moved
+    if (sameAnimSamples(ss))
+        return;
+
     // temporary storage for node transforms
-    smNodeCurrentRotations.setSize(mShape->nodes.size());
-    smNodeCurrentTranslations.setSize(mShape->nodes.size());
-    smRotationThreads.setSize(mShape->nodes.size());
-    smTranslationThreads.setSize(mShape->nodes.size());
+    mNodeCurrentRotations.setSize(mShape->nodes.size());
+    mNodeCurrentTranslations.setSize(mShape->nodes.size());
+    mRotationThreads.setSize(mShape->nodes.size());
+    mTranslationThreads.setSize(mShape->nodes.size());
 
     TSIntegerSet rotBeenSet;
     TSIntegerSet tranBeenSet;
@@ -94,13 +140,13 @@ void TSShapeInstance::animateNodes(S32 ss)
     {
         if (rotBeenSet.test(i))
         {
-            mShape->defaultRotations[i].getQuatF(&smNodeCurrentRotations[i]);
-            smRotationThreads[i] = NULL;
+            mShape->defaultRotations[i].getQuatF(&mNodeCurrentRotations[i]);
+            mRotationThreads[i] = NULL;
         }
         if (tranBeenSet.test(i))
         {
-            smNodeCurrentTranslations[i] = mShape->defaultTranslations[i];
-            smTranslationThreads[i] = NULL;
+            mNodeCurrentTranslations[i] = mShape->defaultTranslations[i];
+            mTranslationThreads[i] = NULL;
         }
     }
 
@@ -133,9 +179,9 @@ void TSShapeInstance::animateNodes(S32 ss)
                 QuatF q1, q2;
                 mShape->getRotation(*th->sequence, th->keyNum1, j, &q1);
                 mShape->getRotation(*th->sequence, th->keyNum2, j, &q2);
-                TSTransform::interpolate(q1, q2, th->keyPos, &smNodeCurrentRotations[nodeIndex]);
+                TSTransform::interpolate(q1, q2, th->keyPos, &mNodeCurrentRotations[nodeIndex]);
                 rotBeenSet.set(nodeIndex);
-                smRotationThreads[nodeIndex] = th;
+                mRotationThreads[nodeIndex] = th;
             }
         }
 
@@ -154,8 +200,8 @@ void TSShapeInstance::animateNodes(S32 ss)
                 {
                     const Point3F& p1 = mShape->getTranslation(*th->sequence, th->keyNum1, j);
                     const Point3F& p2 = mShape->getTranslation(*th->sequence, th->keyNum2, j);
-                    TSTransform::interpolate(p1, p2, th->keyPos, &smNodeCurrentTranslations[nodeIndex]);
-                    smTranslationThreads[nodeIndex] = th;
+                    TSTransform::interpolate(p1, p2, th->keyPos, &mNodeCurrentTranslations[nodeIndex]);
+                    mTranslationThreads[nodeIndex] = th;
                 }
                 tranBeenSet.set(nodeIndex);
             }
@@ -172,7 +218,7 @@ void TSShapeInstance::animateNodes(S32 ss)
     // compute transforms
     for (i = a; i < b; i++)
         if (!mHandsOffNodes.test(i))
-            TSTransform::setMatrix(smNodeCurrentRotations[i], smNodeCurrentTranslations[i], &mNodeTransforms[i]);
+            TSTransform::setMatrix(mNodeCurrentRotations[i], mNodeCurrentTranslations[i], &mNodeTransforms[i]);
 
     // add scale onto transforms
     if (scaleCurrentlyAnimated())
@@ -211,37 +257,37 @@ void TSShapeInstance::handleDefaultScale(S32 a, S32 b, TSIntegerSet& scaleBeenSe
     // set default scale values (i.e., identity) and do any initialization
     // relating to animated scale (since scale normally not animated)
 
-    smScaleThreads.setSize(mShape->nodes.size());
+    mScaleThreads.setSize(mShape->nodes.size());
     scaleBeenSet.takeAway(mCallbackNodes);
     scaleBeenSet.takeAway(mHandsOffNodes);
     if (animatesUniformScale())
     {
-        smNodeCurrentUniformScales.setSize(mShape->nodes.size());
+        mNodeCurrentUniformScales.setSize(mShape->nodes.size());
         for (S32 i = a; i < b; i++)
             if (scaleBeenSet.test(i))
             {
-                smNodeCurrentUniformScales[i] = 1.0f;
-                smScaleThreads[i] = NULL;
+                mNodeCurrentUniformScales[i] = 1.0f;
+                mScaleThreads[i] = NULL;
             }
     }
     else if (animatesAlignedScale())
     {
-        smNodeCurrentAlignedScales.setSize(mShape->nodes.size());
+        mNodeCurrentAlignedScales.setSize(mShape->nodes.size());
         for (S32 i = a; i < b; i++)
             if (scaleBeenSet.test(i))
             {
-                smNodeCurrentAlignedScales[i].set(1.0f, 1.0f, 1.0f);
-                smScaleThreads[i] = NULL;
+                mNodeCurrentAlignedScales[i].set(1.0f, 1.0f, 1.0f);
+                mScaleThreads[i] = NULL;
             }
     }
     else
     {
-        smNodeCurrentArbitraryScales.setSize(mShape->nodes.size());
+        mNodeCurrentArbitraryScales.setSize(mShape->nodes.size());
         for (S32 i = a; i < b; i++)
             if (scaleBeenSet.test(i))
             {
-                smNodeCurrentArbitraryScales[i].identity();
-                smScaleThreads[i] = NULL;
+                mNodeCurrentArbitraryScales[i].identity();
+                mScaleThreads[i] = NULL;
             }
     }
 
@@ -259,7 +305,7 @@ void TSShapeInstance::handleTransitionNodes(S32 a, S32 b)
     {
         if (nodeIndex < a)
             continue;
-        TSThread* thread = smRotationThreads[nodeIndex];
+        TSThread* thread = mRotationThreads[nodeIndex];
         thread = thread && thread->transitionData.inTransition ? thread : NULL;
         if (!thread)
         {
@@ -277,7 +323,7 @@ void TSShapeInstance::handleTransitionNodes(S32 a, S32 b)
             AssertFatal(thread != NULL, "TSShapeInstance::handleRotTransitionNodes (rotation)");
         }
         QuatF tmpQ;
-        TSTransform::interpolate(mNodeReferenceRotations[nodeIndex].getQuatF(&tmpQ), smNodeCurrentRotations[nodeIndex], thread->transitionData.pos, &smNodeCurrentRotations[nodeIndex]);
+        TSTransform::interpolate(mNodeReferenceRotations[nodeIndex].getQuatF(&tmpQ), mNodeCurrentRotations[nodeIndex], thread->transitionData.pos, &mNodeCurrentRotations[nodeIndex]);
     }
 
     // then translation
@@ -285,7 +331,7 @@ void TSShapeInstance::handleTransitionNodes(S32 a, S32 b)
     end = b;
     for (nodeIndex = start; nodeIndex < end; mTransitionTranslationNodes.next(nodeIndex))
     {
-        TSThread* thread = smTranslationThreads[nodeIndex];
+        TSThread* thread = mTranslationThreads[nodeIndex];
         thread = thread && thread->transitionData.inTransition ? thread : NULL;
         if (!thread)
         {
@@ -302,7 +348,7 @@ void TSShapeInstance::handleTransitionNodes(S32 a, S32 b)
             }
             AssertFatal(thread != NULL, "TSShapeInstance::handleTransitionNodes (translation).");
         }
-        Point3F& p = smNodeCurrentTranslations[nodeIndex];
+        Point3F& p = mNodeCurrentTranslations[nodeIndex];
         Point3F& p1 = mNodeReferenceTranslations[nodeIndex];
         Point3F& p2 = p;
         F32 k = thread->transitionData.pos;
@@ -318,7 +364,7 @@ void TSShapeInstance::handleTransitionNodes(S32 a, S32 b)
         end = b;
         for (nodeIndex = start; nodeIndex < end; mTransitionScaleNodes.next(nodeIndex))
         {
-            TSThread* thread = smScaleThreads[nodeIndex];
+            TSThread* thread = mScaleThreads[nodeIndex];
             thread = thread && thread->transitionData.inTransition ? thread : NULL;
             if (!thread)
             {
@@ -336,14 +382,14 @@ void TSShapeInstance::handleTransitionNodes(S32 a, S32 b)
                 AssertFatal(thread != NULL, "TSShapeInstance::handleTransitionNodes (scale).");
             }
             if (animatesUniformScale())
-                smNodeCurrentUniformScales[nodeIndex] += thread->transitionData.pos * (mNodeReferenceUniformScales[nodeIndex] - smNodeCurrentUniformScales[nodeIndex]);
+                mNodeCurrentUniformScales[nodeIndex] += thread->transitionData.pos * (mNodeReferenceUniformScales[nodeIndex] - mNodeCurrentUniformScales[nodeIndex]);
             else if (animatesAlignedScale())
-                TSTransform::interpolate(mNodeReferenceScaleFactors[nodeIndex], smNodeCurrentAlignedScales[nodeIndex], thread->transitionData.pos, &smNodeCurrentAlignedScales[nodeIndex]);
+                TSTransform::interpolate(mNodeReferenceScaleFactors[nodeIndex], mNodeCurrentAlignedScales[nodeIndex], thread->transitionData.pos, &mNodeCurrentAlignedScales[nodeIndex]);
             else
             {
                 QuatF q;
-                TSTransform::interpolate(mNodeReferenceScaleFactors[nodeIndex], smNodeCurrentArbitraryScales[nodeIndex].mScale, thread->transitionData.pos, &smNodeCurrentArbitraryScales[nodeIndex].mScale);
-                TSTransform::interpolate(mNodeReferenceArbitraryScaleRots[nodeIndex].getQuatF(&q), smNodeCurrentArbitraryScales[nodeIndex].mRotate, thread->transitionData.pos, &smNodeCurrentArbitraryScales[nodeIndex].mRotate);
+                TSTransform::interpolate(mNodeReferenceScaleFactors[nodeIndex], mNodeCurrentArbitraryScales[nodeIndex].mScale, thread->transitionData.pos, &mNodeCurrentArbitraryScales[nodeIndex].mScale);
+                TSTransform::interpolate(mNodeReferenceArbitraryScaleRots[nodeIndex].getQuatF(&q), mNodeCurrentArbitraryScales[nodeIndex].mRotate, thread->transitionData.pos, &mNodeCurrentArbitraryScales[nodeIndex].mRotate);
             }
         }
     }
@@ -355,19 +401,19 @@ void TSShapeInstance::handleNodeScale(S32 a, S32 b)
     {
         for (S32 i = a; i < b; i++)
             if (!mHandsOffNodes.test(i))
-                TSTransform::applyScale(smNodeCurrentUniformScales[i], &mNodeTransforms[i]);
+                TSTransform::applyScale(mNodeCurrentUniformScales[i], &mNodeTransforms[i]);
     }
     else if (animatesAlignedScale())
     {
         for (S32 i = a; i < b; i++)
             if (!mHandsOffNodes.test(i))
-                TSTransform::applyScale(smNodeCurrentAlignedScales[i], &mNodeTransforms[i]);
+                TSTransform::applyScale(mNodeCurrentAlignedScales[i], &mNodeTransforms[i]);
     }
     else
     {
         for (S32 i = a; i < b; i++)
             if (!mHandsOffNodes.test(i))
-                TSTransform::applyScale(smNodeCurrentArbitraryScales[i], &mNodeTransforms[i]);
+                TSTransform::applyScale(mNodeCurrentArbitraryScales[i], &mNodeTransforms[i]);
     }
 }
 
@@ -436,28 +482,28 @@ void TSShapeInstance::handleAnimatedScale(TSThread* thread, S32 a, S32 b, TSInte
             {
             case 0: // uniform -> uniform
             {
-                smNodeCurrentUniformScales[nodeIndex] = uniformScale;
+                mNodeCurrentUniformScales[nodeIndex] = uniformScale;
                 break;
             }
             case 1: // uniform -> aligned
             case 4: // aligned -> aligned
-                smNodeCurrentAlignedScales[nodeIndex] = alignedScale;
+                mNodeCurrentAlignedScales[nodeIndex] = alignedScale;
                 break;
             case 2: // uniform -> arbitrary
             case 5: // aligned -> arbitrary
             {
-                smNodeCurrentArbitraryScales[nodeIndex].identity();
-                smNodeCurrentArbitraryScales[nodeIndex].mScale = alignedScale;
+                mNodeCurrentArbitraryScales[nodeIndex].identity();
+                mNodeCurrentArbitraryScales[nodeIndex].mScale = alignedScale;
                 break;
             }
             case 8: // arbitrary -> arbitary
             {
-                smNodeCurrentArbitraryScales[nodeIndex] = arbitraryScale;
+                mNodeCurrentArbitraryScales[nodeIndex] = arbitraryScale;
                 break;
             }
             default: AssertFatal(0, "TSShapeInstance::handleAnimatedScale"); break;
             }
-            smScaleThreads[nodeIndex] = thread;
+            mScaleThreads[nodeIndex] = thread;
             scaleBeenSet.set(nodeIndex);
         }
     }
@@ -471,13 +517,13 @@ void TSShapeInstance::handleMaskedPositionNode(TSThread* th, S32 nodeIndex, S32
     TSTransform::interpolate(p1, p2, th->keyPos, &p);
 
     if (!mMaskPosXNodes.test(nodeIndex))
-        smNodeCurrentTranslations[nodeIndex].x = p.x;
+        mNodeCurrentTranslations[nodeIndex].x = p.x;
 
     if (!mMaskPosYNodes.test(nodeIndex))
-        smNodeCurrentTranslations[nodeIndex].y = p.y;
+        mNodeCurrentTranslations[nodeIndex].y = p.y;
 
     if (!mMaskPosZNodes.test(nodeIndex))
-        smNodeCurrentTranslations[nodeIndex].z = p.z;
+        mNodeCurrentTranslations[nodeIndex].z = p.z;
 }
 
 void TSShapeInstance::handleBlendSequence(TSThread* thread, S32 a, S32 b)
@@ -871,6 +917,46 @@ void TSShapeInstance::animate(S32 dl)
     mDirtyFlags[ss] = 0;
 }
 
+void TSShapeInstance::queueAnimate(TSShapeInstance* instance)
+{
+    if (instance->mAnimateQueued)
+        return;
+
+    instance->mAnimateQueued = true;
+    smAnimateQueue.push_back(instance);
+}
+
+static void animateJob(void* data, U32 index)
+{
+    ((TSShapeInstance**)data)[index]->animate();
+}
+
+void TSShapeInstance::flushAnimateQueue()
+{
+    if (smAnimateQueue.empty())
+        return;
+
+    PROFILE_START(FlushAnimateQueue);
+
+    // Callbacks go back into game code, so shapes with them are animated
+    // here rather than on a worker
+    U32 count = 0;
+    for (S32 i = 0; i < smAnimateQueue.size(); i++)
+    {
+        TSShapeInstance* instance = smAnimateQueue[i];
+        instance->mAnimateQueued = false;
+        if (instance->mCallback && instance->mCallbackNodes.testAll(instance->mShape->nodes.size()))
+            instance->animate();
+        else
+            smAnimateQueue[count++] = instance;
+    }
+
+    ThreadPool::run(animateJob, smAnimateQueue.address(), count);
+    smAnimateQueue.clear();
+
+    PROFILE_END();
+}
+
 void TSShapeInstance::animateNodeSubtrees(bool forceFull)
 {
     // animate all the nodes for all the detail levels...
@@ -1048,6 +1134,7 @@ void TSShapeInstance::setNodeAnimationState(S32 nodeIndex, U32 animationState)
 
     // feel so dirty...
     setDirty(AllDirtyMask);
+    clearAnimSamples();
 
     if (animationState & MaskNodeAllButBlend)
     {
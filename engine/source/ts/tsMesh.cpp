@@ -23,6 +23,11 @@
 #include "game/shapeBase.h"
 #include "game/game.h"
 #include "lightingSystem/sgLightingModel.h"
+#include "platform/threadPool.h"
+
+#ifdef TORQUE_SUPPORTS_SSE
+#include <xmmintrin.h>
+#endif
 
 // Not worth the effort, much less the effort to comment, but if the draw types
 // are consecutive use addition rather than a table to go from index to command value...
@@ -2341,101 +2346,350 @@ GFXVertexBufferHandle<MeshVertex>& TSSkinMesh::getVertexBuffer()
 Vector<MatrixF> gBoneTransforms;
 Vector<Point3F> gSkinVerts;
 Vector<Point3F> gSkinNorms;
+Vector<MeshVertex> gSkinVBVerts;
 
-void TSSkinMesh::updateSkin()
+U32 TSSkinMesh::smSkinVBGeneration = 1;
+
+namespace {
+    struct SkinJob
+    {
+        const TSSkinMesh* mesh;
+        const MatrixF* bones;
+        Point3F* verts;
+        Point3F* norms;
+        U32 chunk;
+    };
+
+    Vector<SkinJob> sgSkinJobs;
+
+    void skinJob(void* data, U32 index)
+    {
+        const SkinJob& job = ((const SkinJob*)data)[index];
+        job.mesh->skinChunk(job.chunk, job.bones, job.verts, job.norms);
+    }
+
+    /// Dynamic buffers come back empty after the device is reset, so every
+    /// instance has to refill its skin vertex buffer.
+    S32 sgSkinTexCallback = -1;
+    GFXDevice* sgSkinTexCallbackDevice = NULL;
+
+    void skinTexCallback(GFXTexCallbackCode code, void* userData)
+    {
+        if (code == GFXResurrect)
+            TSSkinMesh::smSkinVBGeneration++;
+    }
+
+    S32 QSORT_CALLBACK skinKeyCompare(const void* a, const void* b)
+    {
+        const U32* k1 = (const U32*)a;
+        const U32* k2 = (const U32*)b;
+        if (k1[0] != k2[0])
+            return k1[0] < k2[0] ? -1 : 1;
+        return k1[1] < k2[1] ? -1 : (k1[1] > k2[1] ? 1 : 0);
+    }
+} // namespace {}
+
+void TSSkinMesh::buildSkinLayout()
 {
-    if (smGlowPass || smRefractPass)
+    const U32 numVerts = initialVerts.size();
+    const U32 numInfluences = vertexIndex.size();
+    const U32 numBones = getMax(U32(nodeIndex.size()), U32(1));
+    const U32 numChunks = (numVerts + SkinChunkVerts - 1) / SkinChunkVerts;
+
+    // Sort the influences on chunk, then bone.  Pairs of key and influence.
+    Vector<U32> order;
+    order.setSize(numInfluences * 2);
+    for (U32 i = 0; i < numInfluences; i++)
     {
-        return;
+        order[i * 2] = (vertexIndex[i] / SkinChunkVerts) * numBones + boneIndex[i];
+        order[i * 2 + 1] = i;
     }
+    if (numInfluences)
+        dQsort(order.address(), numInfluences, sizeof(U32) * 2, skinKeyCompare);
+
+    // Batches are padded out to whole SSE registers
+    mSkinBatches.clear();
+    mSkinChunks.setSize(numChunks);
+    U32 stride = 0;
+    U32 i = 0;
+    for (U32 c = 0; c < numChunks; c++)
+    {
+        SkinChunk& chunk = mSkinChunks[c];
+        chunk.firstBatch = mSkinBatches.size();
+        chunk.firstVert = c * SkinChunkVerts;
+        chunk.numVerts = getMin(numVerts - chunk.firstVert, U32(SkinChunkVerts));
 
-    PROFILE_START(UpdateSkin);
+        while (i < numInfluences && order[i * 2] / numBones == c)
+        {
+            U32 key = order[i * 2];
+            U32 count = 0;
+            while (i + count < numInfluences && order[(i + count) * 2] == key)
+                count++;
+
+            mSkinBatches.increment();
+            SkinBatch& batch = mSkinBatches.last();
+            batch.bone = key % numBones;
+            batch.start = stride;
+            batch.count = (count + 3) & ~3;
+
+            stride += batch.count;
+            i += count;
+        }
+        chunk.numBatches = mSkinBatches.size() - chunk.firstBatch;
+    }
+    mSkinStride = stride;
 
-    // set arrays
-    gBoneTransforms.setSize(nodeIndex.size());
-#if defined(TORQUE_MAX_LIB)
-    verts.setSize(initialVerts.size());
-    norms.setSize(initialVerts.size());
-#else
-    if (encodedNorms.size())
+    mSkinStreams.setSize(NumSkinStreams * stride);
+    mSkinVertIndex.setSize(stride);
+    if (stride)
+        dMemset(mSkinStreams.address(), 0, sizeof(F32) * mSkinStreams.size());
+
+    // Decode the normals once here rather than every time we skin
+    i = 0;
+    for (U32 b = 0; b < mSkinBatches.size(); b++)
     {
-        // we co-opt responsibility for updating encoded normals from mesh
-        gNormalStore.setSize(vertsPerFrame);
-        for (S32 i = 0; i < vertsPerFrame; i++)
-            gNormalStore[i] = decodeNormal(encodedNorms[i]);
-        initialNorms.set(gNormalStore.address(), vertsPerFrame);
-    }
-    gSkinVerts.setSize(initialVerts.size());
-    gSkinNorms.setSize(initialNorms.size());
-    verts.set(gSkinVerts.address(), gSkinVerts.size());
-    norms.set(gSkinNorms.address(), gSkinNorms.size());
-#endif
+        const SkinBatch& batch = mSkinBatches[b];
+        U32 key = order[i * 2];
+        U32 out = batch.start;
+        for (; i < numInfluences && order[i * 2] == key; i++, out++)
+        {
+            U32 influence = order[i * 2 + 1];
+            S32 v = vertexIndex[influence];
+            const Point3F& p = initialVerts[v];
+            const Point3F& n = encodedNorms.size() ? decodeNormal(encodedNorms[v]) : initialNorms[v];
+
+            mSkinStreams[SkinPosX * stride + out] = p.x;
+            mSkinStreams[SkinPosY * stride + out] = p.y;
+            mSkinStreams[SkinPosZ * stride + out] = p.z;
+            mSkinStreams[SkinNormX * stride + out] = n.x;
+            mSkinStreams[SkinNormY * stride + out] = n.y;
+            mSkinStreams[SkinNormZ * stride + out] = n.z;
+            mSkinStreams[SkinWeight * stride + out] = weight[influence];
+            mSkinVertIndex[out] = v;
+        }
 
-    //if (!initialTangents.size())
-    //{
-    //    dMemcpy(verts.address(), initialVerts.address(), sizeof(Point3F) * verts.size());
-    //    dMemcpy(norms.address(), initialNorms.address(), sizeof(Point3F) * norms.size());
-    //    createTangents();
-    //}
+        // Padding has no weight, so any vertex in the chunk will do
+        for (; out < batch.start + batch.count; out++)
+            mSkinVertIndex[out] = mSkinVertIndex[batch.start];
+    }
+}
 
-    // set up bone transforms
-    S32 i;
-    for (i = 0; i < nodeIndex.size(); i++)
-    {
-        S32 node = nodeIndex[i];
-        gBoneTransforms[i].mul(TSShapeInstance::ObjectInstance::smTransforms[node], initialTransforms[i]);
-    }
-
-    // multiply verts and normals by boneTransforms
-    S32 prevIndex = -1;
-    for (i = 0; i < vertexIndex.size(); i++)
-    {
-        Point3F v0, n0, t0;
-        S32 vIndex = vertexIndex[i];
-        MatrixF& deltaTransform = gBoneTransforms[boneIndex[i]];
-        deltaTransform.mulP(initialVerts[vIndex], &v0);
-        deltaTransform.mulV(initialNorms[vIndex], &n0);
-        deltaTransform.mulV(initialTangents[vIndex], &t0);
-        v0 *= weight[i];
-        n0 *= weight[i];
-        t0 *= weight[i];
-        Point3F& v = verts[vIndex];
-        Point3F& n = norms[vIndex];
-        Point3F& t = (Point3F&)tangents[vIndex];
-        // this should be implemented as a series of conditional moves to avoid the branch
-        if (vIndex != prevIndex)
+bool TSSkinMesh::updateBones(Vector<MatrixF>& bones) const
+{
+    bool changed = bones.size() != nodeIndex.size();
+    bones.setSize(nodeIndex.size());
+
+    for (S32 i = 0; i < nodeIndex.size(); i++)
+    {
+        MatrixF bone;
+        bone.mul(TSShapeInstance::ObjectInstance::smTransforms[nodeIndex[i]], initialTransforms[i]);
+        if (changed || dMemcmp(&bone, &bones[i], sizeof(MatrixF)))
+        {
+            bones[i] = bone;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+void TSSkinMesh::skinChunk(U32 c, const MatrixF* bones, Point3F* outVerts, Point3F* outNorms) const
+{
+    const SkinChunk& chunk = mSkinChunks[c];
+    dMemset(outVerts + chunk.firstVert, 0, sizeof(Point3F) * chunk.numVerts);
+    dMemset(outNorms + chunk.firstVert, 0, sizeof(Point3F) * chunk.numVerts);
+
+    const F32* px = mSkinStreams.address() + SkinPosX * mSkinStride;
+    const F32* py = mSkinStreams.address() + SkinPosY * mSkinStride;
+    const F32* pz = mSkinStreams.address() + SkinPosZ * mSkinStride;
+    const F32* nx = mSkinStreams.address() + SkinNormX * mSkinStride;
+    const F32* ny = mSkinStreams.address() + SkinNormY * mSkinStride;
+    const F32* nz = mSkinStreams.address() + SkinNormZ * mSkinStride;
+    const F32* w = mSkinStreams.address() + SkinWeight * mSkinStride;
+    const S32* index = mSkinVertIndex.address();
+
+    for (U32 b = chunk.firstBatch; b < chunk.firstBatch + chunk.numBatches; b++)
+    {
+        const SkinBatch& batch = mSkinBatches[b];
+        const F32* m = bones[batch.bone];
+        const U32 end = batch.start + batch.count;
+
+#ifdef TORQUE_SUPPORTS_SSE
+        const __m128 m0 = _mm_set1_ps(m[0]), m1 = _mm_set1_ps(m[1]), m2 = _mm_set1_ps(m[2]), m3 = _mm_set1_ps(m[3]);
+        const __m128 m4 = _mm_set1_ps(m[4]), m5 = _mm_set1_ps(m[5]), m6 = _mm_set1_ps(m[6]), m7 = _mm_set1_ps(m[7]);
+        const __m128 m8 = _mm_set1_ps(m[8]), m9 = _mm_set1_ps(m[9]), m10 = _mm_set1_ps(m[10]), m11 = _mm_set1_ps(m[11]);
+
+        F32 out[6][4];
+        for (U32 i = batch.start; i < end; i += 4)
+        {
+            const __m128 x = _mm_loadu_ps(px + i);
+            const __m128 y = _mm_loadu_ps(py + i);
+            const __m128 z = _mm_loadu_ps(pz + i);
+            const __m128 wt = _mm_loadu_ps(w + i);
+
+            _mm_storeu_ps(out[0], _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m0, x), _mm_mul_ps(m1, y)), _mm_mul_ps(m2, z)), m3), wt));
+            _mm_storeu_ps(out[1], _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m4, x), _mm_mul_ps(m5, y)), _mm_mul_ps(m6, z)), m7), wt));
+            _mm_storeu_ps(out[2], _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m8, x), _mm_mul_ps(m9, y)), _mm_mul_ps(m10, z)), m11), wt));
+
+            const __m128 a = _mm_loadu_ps(nx + i);
+            const __m128 b = _mm_loadu_ps(ny + i);
+            const __m128 c = _mm_loadu_ps(nz + i);
+
+            _mm_storeu_ps(out[3], _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m0, a), _mm_mul_ps(m1, b)), _mm_mul_ps(m2, c)), wt));
+            _mm_storeu_ps(out[4], _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m4, a), _mm_mul_ps(m5, b)), _mm_mul_ps(m6, c)), wt));
+            _mm_storeu_ps(out[5], _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m8, a), _mm_mul_ps(m9, b)), _mm_mul_ps(m10, c)), wt));
+
+            for (U32 k = 0; k < 4; k++)
+            {
+                Point3F& v = outVerts[index[i + k]];
+                Point3F& n = outNorms[index[i + k]];
+                v.x += out[0][k];
+                v.y += out[1][k];
+                v.z += out[2][k];
+                n.x += out[3][k];
+                n.y += out[4][k];
+                n.z += out[5][k];
+            }
+        }
+#else
+        for (U32 i = batch.start; i < end; i++)
         {
-            v.x = 0.0f;
-            v.y = 0.0f;
-            v.z = 0.0f;
-            n.x = 0.0f;
-            n.y = 0.0f;
-            n.z = 0.0f;
-            t.x = 0.0f;
-            t.y = 0.0f;
-            t.z = 0.0f;
+            Point3F& v = outVerts[index[i]];
+            Point3F& n = outNorms[index[i]];
+            v.x += (m[0] * px[i] + m[1] * py[i] + m[2] * pz[i] + m[3]) * w[i];
+            v.y += (m[4] * px[i] + m[5] * py[i] + m[6] * pz[i] + m[7]) * w[i];
+            v.z += (m[8] * px[i] + m[9] * py[i] + m[10] * pz[i] + m[11]) * w[i];
+            n.x += (m[0] * nx[i] + m[1] * ny[i] + m[2] * nz[i]) * w[i];
+            n.y += (m[4] * nx[i] + m[5] * ny[i] + m[6] * nz[i]) * w[i];
+            n.z += (m[8] * nx[i] + m[9] * ny[i] + m[10] * nz[i]) * w[i];
         }
-        v += v0;
-        n += n0;
-        t += t0;
-        prevIndex = vIndex;
+#endif
     }
 
     // normalize normals...
-    for (i = 0; i < norms.size(); i++)
+    for (U32 i = chunk.firstVert; i < chunk.firstVert + chunk.numVerts; i++)
     {
         // gotta do a check now since shared verts between meshes
         // may result in an unused vert in the list...
-        Point3F& n = norms[i];
+        Point3F& n = outNorms[i];
         F32 len2 = mDot(n, n);
         if (len2 > 0.01f)
-            norms[i] *= 1.0f / mSqrt(len2);
+            n *= 1.0f / mSqrt(len2);
+    }
+}
+
+void TSSkinMesh::queueSkin(const MatrixF* bones, Point3F* outVerts, Point3F* outNorms)
+{
+    if (mSkinChunks.empty())
+        buildSkinLayout();
+
+    for (U32 i = 0; i < mSkinChunks.size(); i++)
+    {
+        sgSkinJobs.increment();
+        SkinJob& job = sgSkinJobs.last();
+        job.mesh = this;
+        job.bones = bones;
+        job.verts = outVerts;
+        job.norms = outNorms;
+        job.chunk = i;
+    }
+}
 
-        // also normalize tangent matrix
-        ((Point3F&)tangents[i]).normalize();
+void TSSkinMesh::runSkinJobs()
+{
+    if (sgSkinJobs.empty())
+        return;
+
+    PROFILE_START(RunSkinJobs);
+    ThreadPool::run(skinJob, sgSkinJobs.address(), sgSkinJobs.size());
+    sgSkinJobs.clear();
+    PROFILE_END();
+}
+
+void TSSkinMesh::fillSkinVB(GFXVertexBufferHandle<MeshVertex>& vb)
+{
+    if (!verts.size() || !GFXDevice::devicePresent())
+        return;
+
+    PROFILE_START(FillSkinVB);
+
+    if (sgSkinTexCallbackDevice != GFX)
+    {
+        GFX->registerTexCallback(skinTexCallback, NULL, sgSkinTexCallback);
+        sgSkinTexCallbackDevice = GFX;
+    }
+
+    // The index buffer is the same for every instance
+    if (mPB.isNull())
+        createPB();
+
+    gSkinVBVerts.setSize(verts.size());
+    MeshVertex* tempVerts = gSkinVBVerts.address();
+    for (U32 i = 0; i < verts.size(); i++)
+    {
+        tempVerts[i].point = verts[i];
+        tempVerts[i].texCoord = tverts[i];
+        tempVerts[i].normal = norms[i];
     }
+    fillTextureSpaceInfo(tempVerts);
+
+    // Dynamic rather than volatile, so it can be drawn again next frame
+    // if the pose doesn't change.
+    if (vb.isNull() || vb->mNumVerts != verts.size())
+        vb.set(GFX, verts.size(), GFXBufferTypeDynamic);
+
+    MeshVertex* vbVerts = vb.lock();
+    dMemcpy(vbVerts, tempVerts, sizeof(MeshVertex) * verts.size());
+    vb.unlock();
+
+    PROFILE_END();
+}
+
+void TSSkinMesh::updateSkin()
+{
+    if (smGlowPass || smRefractPass)
+    {
+        return;
+    }
+
+    PROFILE_START(UpdateSkin);
 
-    createVBIB();
+#if defined(TORQUE_MAX_LIB)
+    verts.setSize(initialVerts.size());
+    norms.setSize(initialVerts.size());
+    updateBones(gBoneTransforms);
+    queueSkin(gBoneTransforms.address(), verts.address(), norms.address());
+    runSkinJobs();
+#else
+    TSShapeInstance::MeshObjectInstance* inst = TSShapeInstance::smRenderData.currentObjectInstance;
+    if (inst)
+    {
+        // TSShapeInstance::render usually skins all its meshes up front, in
+        // which case there's nothing left to do here.
+        if (inst->queueSkin(this))
+            runSkinJobs();
+
+        verts.set(inst->mSkinVerts.address(), inst->mSkinVerts.size());
+        norms.set(inst->mSkinNorms.address(), inst->mSkinNorms.size());
+
+        if (inst->mSkinVBGeneration != smSkinVBGeneration)
+        {
+            fillSkinVB(inst->mVB);
+            inst->mSkinVBGeneration = smSkinVBGeneration;
+        }
+    }
+    else
+    {
+        // Not drawing an instance, so there's nowhere to keep the result
+        updateBones(gBoneTransforms);
+        gSkinVerts.setSize(initialVerts.size());
+        gSkinNorms.setSize(initialVerts.size());
+        queueSkin(gBoneTransforms.address(), gSkinVerts.address(), gSkinNorms.address());
+        runSkinJobs();
+
+        verts.set(gSkinVerts.address(), gSkinVerts.size());
+        norms.set(gSkinNorms.address(), gSkinNorms.size());
+    }
+#endif
 
     PROFILE_END();
 }
@@ -3201,17 +3455,18 @@ void TSMesh::leaveAsMultipleStrips(S16* primitiveDataIn, S32* primitiveMatIn, S1
 // that pointer (in the case that we don't skip this mesh).
 // If we do have a parent mesh, then we return a pointer to the data in the shape buffer,
 // copying the data in there ourselves if our parent didn't already do it (i.e., if it was skipped).
+// Baked shapes keep the memory buffer, so their data is never copied.
 S32* TSMesh::getSharedData32(S32 parentMesh, S32 size, S32** source, bool skip)
 {
     S32* ptr;
     if (parentMesh < 0)
-        ptr = skip ? alloc.getPointer32(size) : alloc.copyToShape32(size);
+        ptr = (skip || alloc.isInPlace()) ? alloc.getPointer32(size) : alloc.copyToShape32(size);
     else
     {
         ptr = source[parentMesh];
         // if we skipped the previous mesh (and we're not skipping this one) then
         // we still need to copy points into the shape...
-        if (!smDataCopied[parentMesh] && !skip)
+        if (!smDataCopied[parentMesh] && !skip && !alloc.isInPlace())
         {
             S32* tmp = ptr;
             ptr = alloc.allocShape32(size);
@@ -3226,13 +3481,13 @@ S8* TSMesh::getSharedData8(S32 parentMesh, S32 size, S8** source, bool skip)
 {
     S8* ptr;
     if (parentMesh < 0)
-        ptr = skip ? alloc.getPointer8(size) : alloc.copyToShape8(size);
+        ptr = (skip || alloc.isInPlace()) ? alloc.getPointer8(size) : alloc.copyToShape8(size);
     else
     {
         ptr = source[parentMesh];
         // if we skipped the previous mesh (and we're not skipping this one) then
         // we still need to copy points into the shape...
-        if (!smDataCopied[parentMesh] && !skip)
+        if (!smDataCopied[parentMesh] && !skip && !alloc.isInPlace())
         {
             S8* tmp = ptr;
             ptr = alloc.allocShape8(size);
@@ -3285,6 +3540,13 @@ void TSMesh::createVBIB()
 
     delete[] tempVerts;
 
+    createPB();
+
+    PROFILE_END();
+}
+
+void TSMesh::createPB()
+{
     // go through and create PrimitiveInfo array
     Vector <GFXPrimitive> piArray;
     for (S32 i = 0; i < primitives.size(); i++)
@@ -3325,15 +3587,14 @@ void TSMesh::createVBIB()
 
     U16* ibIndices;
     GFXPrimitive* piInput;
-    mPB.set(GFX, indices.size(), piArray.size(), mDynamic ? GFXBufferTypeVolatile : GFXBufferTypeStatic);
+    // Only the vertices of dynamic meshes change, the indices never do
+    mPB.set(GFX, indices.size(), piArray.size(), GFXBufferTypeStatic);
     mPB.lock(&ibIndices, &piInput);
 
     dMemcpy(ibIndices, indices.address(), indices.size() * sizeof(U16));
     dMemcpy(piInput, piArray.address(), piArray.size() * sizeof(GFXPrimitive));
 
     mPB.unlock();
-
-    PROFILE_END();
 }
 
 
@@ -3396,32 +3657,53 @@ void TSMesh::assemble(bool skip)
     S32 szInd = alloc.get32();
     S16* ind16 = alloc.getPointer16(szInd);
 
-    // count then copy...
-    S32 cpyPrim = szPrim, cpyInd = szInd;
-    if (smUseTriangles)
-        convertToTris(prim16, prim32, ind16, szPrim, cpyPrim, cpyInd, NULL, NULL);
-    else if (smUseOneStrip)
-        convertToSingleStrip(prim16, prim32, ind16, szPrim, cpyPrim, cpyInd, NULL, NULL);
-    else
-        leaveAsMultipleStrips(prim16, prim32, ind16, szPrim, cpyPrim, cpyInd, NULL, NULL);
-    ptr32 = alloc.allocShape32(2 * cpyPrim);
-    S16* ptr16 = alloc.allocShape16(cpyInd);
-    alloc.align32();
-    S32 chkPrim = szPrim, chkInd = szInd;
-    if (smUseTriangles)
-        convertToTris(prim16, prim32, ind16, szPrim, chkPrim, chkInd, ptr32, ptr16);
-    else if (smUseOneStrip)
-        convertToSingleStrip(prim16, prim32, ind16, szPrim, chkPrim, chkInd, ptr32, ptr16);
+    if (alloc.isInPlace())
+    {
+        // baked shapes were converted when they were baked, so the indices
+        // are used where they lie and only the primitives need interleaving
+        ptr32 = alloc.allocShape32(2 * szPrim);
+        if (ptr32)
+        {
+            for (S32 i = 0; i < szPrim; i++)
+            {
+                TSDrawPrimitive* prim = (TSDrawPrimitive*)&ptr32[i * 2];
+                prim->start = prim16[i * 2];
+                prim->numElements = prim16[i * 2 + 1];
+                prim->matIndex = prim32[i];
+            }
+        }
+        primitives.set(ptr32, szPrim);
+        indices.set(ind16, szInd);
+    }
     else
-        leaveAsMultipleStrips(prim16, prim32, ind16, szPrim, chkPrim, chkInd, ptr32, ptr16);
-    AssertFatal(chkPrim == cpyPrim && chkInd == cpyInd, "TSMesh::primitive conversion");
-    primitives.set(ptr32, cpyPrim);
-    indices.set(ptr16, cpyInd);
+    {
+        // count then copy...
+        S32 cpyPrim = szPrim, cpyInd = szInd;
+        if (smUseTriangles)
+            convertToTris(prim16, prim32, ind16, szPrim, cpyPrim, cpyInd, NULL, NULL);
+        else if (smUseOneStrip)
+            convertToSingleStrip(prim16, prim32, ind16, szPrim, cpyPrim, cpyInd, NULL, NULL);
+        else
+            leaveAsMultipleStrips(prim16, prim32, ind16, szPrim, cpyPrim, cpyInd, NULL, NULL);
+        ptr32 = alloc.allocShape32(2 * cpyPrim);
+        S16* ptr16 = alloc.allocShape16(cpyInd);
+        alloc.align32();
+        S32 chkPrim = szPrim, chkInd = szInd;
+        if (smUseTriangles)
+            convertToTris(prim16, prim32, ind16, szPrim, chkPrim, chkInd, ptr32, ptr16);
+        else if (smUseOneStrip)
+            convertToSingleStrip(prim16, prim32, ind16, szPrim, chkPrim, chkInd, ptr32, ptr16);
+        else
+            leaveAsMultipleStrips(prim16, prim32, ind16, szPrim, chkPrim, chkInd, ptr32, ptr16);
+        AssertFatal(chkPrim == cpyPrim && chkInd == cpyInd, "TSMesh::primitive conversion");
+        primitives.set(ptr32, cpyPrim);
+        indices.set(ptr16, cpyInd);
+    }
 
     S32 sz = alloc.get32();
-    ptr16 = alloc.copyToShape16(sz);
+    S16* merge16 = alloc.isInPlace() ? alloc.getPointer16(sz) : alloc.copyToShape16(sz);
     alloc.align32();
-    mergeIndices.set(ptr16, sz);
+    mergeIndices.set(merge16, sz);
 
     vertsPerFrame = alloc.get32();
     U32 flags = (U32)alloc.get32();
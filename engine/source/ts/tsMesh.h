@@ -246,6 +246,7 @@ public:
     virtual GFXVertexBufferHandle<MeshVertex>& getVertexBuffer() { return mVB; };
 
     void createVBIB();
+    void createPB();
     void createTextureSpaceMatrix(MeshVertex* v0, MeshVertex* v1, MeshVertex* v2);
     void fillTextureSpaceInfo(MeshVertex* vertArray);
 
@@ -338,6 +339,74 @@ public:
     /// set verts and normals...
     void updateSkin();
 
+    /// @name Skinning
+    /// The influences above regrouped for skinning.  The vertices are split
+    /// into chunks which are skinned as separate jobs on the ThreadPool, and
+    /// within a chunk the influences are grouped by bone and stored one
+    /// stream per component, so each bone matrix is loaded once and applied to
+    /// four influences at a time.  Built the first time the mesh is skinned.
+    /// @{
+
+    enum SkinStreams
+    {
+        SkinPosX, SkinPosY, SkinPosZ,
+        SkinNormX, SkinNormY, SkinNormZ,
+        SkinWeight,
+        NumSkinStreams
+    };
+
+    enum
+    {
+        SkinChunkVerts = 512,
+    };
+
+    /// A run of influences on one bone, padded to a multiple of four with
+    /// zero weights.
+    struct SkinBatch
+    {
+        S32 bone;
+        U32 start;
+        U32 count;
+    };
+
+    struct SkinChunk
+    {
+        U32 firstBatch;
+        U32 numBatches;
+        U32 firstVert;
+        U32 numVerts;
+    };
+
+    Vector<SkinBatch> mSkinBatches;
+    Vector<SkinChunk> mSkinChunks;
+    Vector<F32> mSkinStreams;     ///< NumSkinStreams streams of mSkinStride floats
+    Vector<S32> mSkinVertIndex;   ///< vertex each influence adds into
+    U32 mSkinStride;
+
+    void buildSkinLayout();
+
+    /// Work out the bone transforms for the current pose.  Returns false if
+    /// bones already held them.
+    bool updateBones(Vector<MatrixF>& bones) const;
+
+    /// Skin one chunk of verts and norms with the given bone transforms.
+    void skinChunk(U32 chunk, const MatrixF* bones, Point3F* outVerts, Point3F* outNorms) const;
+
+    /// Queue skinning of the whole mesh into outVerts and outNorms, which
+    /// must hold initialVerts.size() entries.  Nothing is done until
+    /// runSkinJobs.
+    void queueSkin(const MatrixF* bones, Point3F* outVerts, Point3F* outNorms);
+
+    /// Skin everything queued, on the ThreadPool.
+    static void runSkinJobs();
+
+    /// Copy skinned verts and norms into a vertex buffer.
+    void fillSkinVB(GFXVertexBufferHandle<MeshVertex>& vb);
+
+    /// Bumped whenever the device loses the contents of dynamic buffers.
+    static U32 smSkinVBGeneration;
+    /// @}
+
     // overrides from TSMesh
     GFXVertexBufferHandle<MeshVertex>& getVertexBuffer();
 
@@ -368,6 +437,7 @@ public:
     {
         meshType = SkinMeshType;
         mDynamic = true;
+        mSkinStride = 0;
     }
 };
 
@@ -30,12 +30,16 @@ S32 TSShape::smNumSkipLoadDetails = 0;
 
 bool TSShape::smInitOnRead = true;
 
+const U32 TSShape::smBakedMagic = makeFourCCTag('D', 'T', 'B', 'S');
+const U32 TSShape::smBakedVersion = 1;
+
 
 TSShape::TSShape()
 {
     materialList = NULL;
     mReadVersion = -1; // -1 means constructed from scratch (e.g., in exporter or no read yet)
     mMemoryBlock = NULL;
+    mBakedBlock = NULL;
 
     mSequencesConstructed = false;
 
@@ -101,6 +105,8 @@ TSShape::~TSShape()
 
     delete[] mMemoryBlock;
     mMemoryBlock = NULL;
+    delete[] mBakedBlock;
+    mBakedBlock = NULL;
 
     /*
        if (mVertexBuffer != -1)
@@ -1357,6 +1363,136 @@ void TSShape::write(Stream* s)
     delete[] buffer8;
 }
 
+//-------------------------------------------------
+// write baked shape
+//-------------------------------------------------
+U32 TSShape::getBakedFlags()
+{
+    U32 flags = 0;
+    if (TSMesh::smUseTriangles)
+        flags |= BakedTriangles;
+    else if (TSMesh::smUseOneStrip)
+        flags |= BakedOneStrip;
+    if (TSMesh::smUseEncodedNormals)
+        flags |= BakedEncodedNormals;
+    return flags;
+}
+
+bool TSShape::writeBaked(Stream* s, U32 sourceCRC)
+{
+    alloc.setWrite();
+    disassembleShape();
+
+    S32* buffer32 = alloc.getBuffer32();
+    S16* buffer16 = alloc.getBuffer16();
+    S8* buffer8 = alloc.getBuffer8();
+
+    S32 size32 = alloc.getBufferSize32();
+    S32 size16 = alloc.getBufferSize16();
+    S32 size8 = alloc.getBufferSize8();
+
+    // convert sizes to dwords, and pad each buffer out to 16 bytes so
+    // they all start aligned when the block is read back...
+    size16 = (size16 + 1) >> 1;
+    size8 = (size8 + 3) >> 2;
+    S32 pad32 = (size32 + 3) & ~3;
+    S32 pad16 = (size16 + 3) & ~3;
+    S32 pad8 = (size8 + 3) & ~3;
+
+    BakedHeader header;
+    dMemset(&header, 0, sizeof(header));
+    header.magic = smBakedMagic;
+    header.bakedVersion = smBakedVersion;
+    header.shapeVersion = smVersion | (mExporterVersion << 16);
+    header.sourceCRC = sourceCRC;
+    header.flags = getBakedFlags();
+    header.sizeMemBuffer = pad32 + pad16 + pad8;
+    header.start16 = pad32;
+    header.start8 = pad32 + pad16;
+
+    // write handles endian-flip
+    for (U32 i = 0; i < sizeof(header) / sizeof(U32); i++)
+        s->write(((U32*)&header)[i]);
+
+    // one block, in the layout it'll be used in
+    S32* block = new S32[header.sizeMemBuffer];
+    dMemset(block, 0, header.sizeMemBuffer * sizeof(S32));
+    dMemcpy(block, buffer32, alloc.getBufferSize32() * sizeof(S32));
+    dMemcpy(block + header.start16, buffer16, alloc.getBufferSize16() * sizeof(S16));
+    dMemcpy(block + header.start8, buffer8, alloc.getBufferSize8());
+    fixEndian(block, (S16*)(block + header.start16), (S8*)(block + header.start8), pad32, pad16, pad8);
+    s->write(header.sizeMemBuffer * sizeof(S32), (U8*)block);
+    delete[] block;
+
+    // sequences and materials are small, they go as in a .dts
+    s->write(sequences.size());
+    for (S32 i = 0; i < sequences.size(); i++)
+        sequences[i].write(s);
+
+    materialList->write(*s);
+
+    delete[] buffer32;
+    delete[] buffer16;
+    delete[] buffer8;
+
+    return s->getStatus() == Stream::Ok;
+}
+
+//-------------------------------------------------
+// read baked shape
+//-------------------------------------------------
+bool TSShape::readBaked(Stream* s, U32 sourceCRC)
+{
+    BakedHeader header;
+    for (U32 i = 0; i < sizeof(header) / sizeof(U32); i++)
+        s->read(&((U32*)&header)[i]);
+
+    if (s->getStatus() != Stream::Ok || header.magic != smBakedMagic)
+    {
+        Con::errorf(ConsoleLogEntry::General, "Error: bad baked shape file.");
+        return false;
+    }
+
+    // a stale or differently converted bake quietly falls back to the .dts
+    if (header.bakedVersion != smBakedVersion || (header.shapeVersion & 0xFF) != smVersion ||
+        header.flags != getBakedFlags() || (sourceCRC != InvalidCRC && header.sourceCRC != sourceCRC) ||
+        header.start16 > header.start8 || header.start8 > header.sizeMemBuffer)
+        return false;
+
+    mExporterVersion = header.shapeVersion >> 16;
+    mReadVersion = smReadVersion = header.shapeVersion & 0xFF;
+
+    mBakedBlock = new S32[header.sizeMemBuffer];
+    s->read(header.sizeMemBuffer * sizeof(S32), (U8*)mBakedBlock);
+
+    S32 numSequences;
+    s->read(&numSequences);
+    if (s->getStatus() != Stream::Ok)
+    {
+        Con::errorf(ConsoleLogEntry::General, "Error: bad baked shape file.");
+        return false;
+    }
+    sequences.setSize(numSequences);
+    for (S32 i = 0; i < numSequences; i++)
+    {
+        constructInPlace(&sequences[i]);
+        sequences[i].read(s);
+    }
+
+    delete materialList;
+    materialList = new TSMaterialList;
+    materialList->read(*s);
+
+    alloc.setInPlace(true);
+    assembleBuffers(mBakedBlock, (S16*)(mBakedBlock + header.start16), (S8*)(mBakedBlock + header.start8),
+        header.start16, header.start8 - header.start16, header.sizeMemBuffer - header.start8);
+    alloc.setInPlace(false);
+
+    if (smInitOnRead)
+        init();
+    return true;
+}
+
 //-------------------------------------------------
 // read whole shape
 //-------------------------------------------------
@@ -1428,17 +1564,8 @@ bool TSShape::read(Stream* s)
         materialList->read(*s);
     }
 
-    // since we read in the buffers, we need to endian-flip their entire contents...
-    fixEndian(memBuffer32, memBuffer16, memBuffer8, count32, count16, count8);
-
-    alloc.setRead(memBuffer32, memBuffer16, memBuffer8, true);
-    assembleShape(); // determine size of buffer needed
-    S32 buffSize = alloc.getSize();
-    alloc.doAlloc();
-    mMemoryBlock = alloc.getBuffer();
-    alloc.setRead(memBuffer32, memBuffer16, memBuffer8, false);
-    assembleShape(); // copy to buffer
-    AssertFatal(alloc.getSize() == buffSize, "TSShape::read: shape data buffer size mis-calculated");
+    alloc.setInPlace(false);
+    assembleBuffers(memBuffer32, memBuffer16, memBuffer8, count32, count16, count8);
 
     if (smReadVersion < 19)
     {
@@ -1454,6 +1581,21 @@ bool TSShape::read(Stream* s)
     return true;
 }
 
+void TSShape::assembleBuffers(S32* memBuffer32, S16* memBuffer16, S8* memBuffer8, S32 count32, S32 count16, S32 count8)
+{
+    // since we read in the buffers, we need to endian-flip their entire contents...
+    fixEndian(memBuffer32, memBuffer16, memBuffer8, count32, count16, count8);
+
+    alloc.setRead(memBuffer32, memBuffer16, memBuffer8, true);
+    assembleShape(); // determine size of buffer needed
+    S32 buffSize = alloc.getSize();
+    alloc.doAlloc();
+    mMemoryBlock = alloc.getBuffer();
+    alloc.setRead(memBuffer32, memBuffer16, memBuffer8, false);
+    assembleShape(); // copy to buffer
+    AssertFatal(alloc.getSize() == buffSize, "TSShape::read: shape data buffer size mis-calculated");
+}
+
 void TSShape::fixEndian(S32* buff32, S16* buff16, S8*, S32 count32, S32 count16, S32)
 {
     // if endian-ness isn't the same, need to flip the buffer contents.
@@ -1578,9 +1720,50 @@ void TSShape::readIflMaterials(const char* shapePath)
 
 }
 
-ResourceInstance* constructTSShape(Stream& stream)
+extern ResourceObject* curResourceObj;
+
+/// Look for a .dtb baked from the .dts being loaded.
+static TSShape* readBakedShape(ResourceObject* source)
 {
+    if (!source || source->crc == InvalidCRC)
+        return NULL;
+
+    char bakedName[1024];
+    dSprintf(bakedName, sizeof(bakedName), "%s/%s", source->path, source->name);
+    char* ext = dStrrchr(bakedName, '.');
+    if (!ext || dStricmp(ext, ".dts"))
+        return NULL;
+    dStrcpy(ext, ".dtb");
+
+    // only look at files the resource manager already knows about, so a
+    // missing .dtb isn't logged as a missing file
+    ResourceObject* baked = ResourceManager->find(bakedName, ResourceObject::File);
+    if (!baked)
+        baked = ResourceManager->find(bakedName, ResourceObject::VolumeBlock);
+    if (!baked)
+        return NULL;
+
+    Stream* stream = ResourceManager->openStream(baked);
+    if (!stream)
+        return NULL;
+
     TSShape* ret = new TSShape;
+    if (!ret->readBaked(stream, source->crc))
+    {
+        delete ret;
+        ret = NULL;
+    }
+    ResourceManager->closeStream(stream);
+    return ret;
+}
+
+ResourceInstance* constructTSShape(Stream& stream)
+{
+    TSShape* ret = readBakedShape(curResourceObj);
+    if (ret)
+        return ret;
+
+    ret = new TSShape;
     if (!ret->read(&stream))
     {
         delete ret;
@@ -1590,6 +1773,69 @@ ResourceInstance* constructTSShape(Stream& stream)
     return ret;
 }
 
+ResourceInstance* constructTSShapeBaked(Stream& stream)
+{
+    TSShape* ret = new TSShape;
+    if (!ret->readBaked(&stream, InvalidCRC))
+    {
+        delete ret;
+        ret = NULL;
+    }
+
+    return ret;
+}
+
+ConsoleFunction(bakeShape, bool, 2, 3, "(string shapePath, string bakedPath = \"\")"
+    "Write a .dts out as a baked shape, by default to a .dtb next to it.  "
+    "The .dtb is loaded in place of the .dts from then on, until either changes.")
+{
+    char shapePath[1024];
+    char bakedPath[1024];
+    Con::expandScriptFilename(shapePath, sizeof(shapePath), argv[1]);
+    if (argc > 2 && argv[2][0])
+        Con::expandScriptFilename(bakedPath, sizeof(bakedPath), argv[2]);
+    else
+    {
+        dStrcpy(bakedPath, shapePath);
+        char* ext = dStrrchr(bakedPath, '.');
+        if (!ext)
+        {
+            Con::errorf("bakeShape: '%s' has no extension.", shapePath);
+            return false;
+        }
+        dStrcpy(ext, ".dtb");
+    }
+
+    // skipped details aren't in the shape to be written back out
+    if (TSShape::smNumSkipLoadDetails)
+    {
+        Con::errorf("bakeShape: $pref::TS::skipLoadDLs must be 0 to bake shapes.");
+        return false;
+    }
+
+    // bake a fresh copy, so nothing that's been rendered with is written
+    ResourceObject* source = ResourceManager->find(shapePath);
+    TSShape* shape = source ? (TSShape*)ResourceManager->loadInstance(source, true) : NULL;
+    if (!shape)
+    {
+        Con::errorf("bakeShape: unable to load '%s'.", shapePath);
+        return false;
+    }
+
+    Stream* stream;
+    bool ok = ResourceManager->openFileForWrite(stream, bakedPath);
+    if (ok)
+    {
+        ok = shape->writeBaked(stream, source->crc);
+        delete stream;
+    }
+    delete shape;
+
+    if (!ok)
+        Con::errorf("bakeShape: unable to write '%s'.", bakedPath);
+    return ok;
+}
+
 //ResourceInstance* constructColladaShape(Stream& stream)
 //{
 //    FileStream& fs = static_cast<FileStream&>(stream);
@@ -345,6 +345,12 @@ public:
     /// vectors are resizeable
     S8* mMemoryBlock;
 
+    /// Memory buffer of a baked shape.
+    ///
+    /// Baked shapes keep the buffer they were read into, and the mesh
+    /// arrays point into it rather than being copied into mMemoryBlock.
+    S32* mBakedBlock;
+
     TSMaterialList* materialList;
 
     /// @name Bounding
@@ -478,6 +484,55 @@ public:
     static const U32 smMostRecentExporterVersion;
     ///@}
 
+    /// @name Baked Shapes
+    ///
+    /// A baked shape (.dtb) holds the same buffers as a .dts, but already
+    /// converted to the primitive form this build renders with and laid
+    /// out aligned.  It's read with one read into a block the shape
+    /// keeps, and the vertex, normal, index and skin arrays are used where
+    /// they lie instead of being copied out.  A .dtb next to a .dts is
+    /// loaded in its place as long as it was baked from that .dts with the
+    /// same mesh settings.
+    /// @{
+
+    enum BakedFlags
+    {
+        BakedTriangles = BIT(0),
+        BakedOneStrip = BIT(1),
+        BakedEncodedNormals = BIT(2),
+    };
+
+    /// Header at the front of a baked shape, which is padded out so
+    /// the buffers after it start 16 byte aligned.
+    struct BakedHeader
+    {
+        U32 magic;
+        U32 bakedVersion;
+        U32 shapeVersion;     ///< smVersion and exporter version, as in a .dts
+        U32 sourceCRC;        ///< CRC of the .dts it was baked from
+        U32 flags;            ///< BakedFlags the meshes were converted with
+        U32 sizeMemBuffer;    ///< in dwords, as in a .dts
+        U32 start16;
+        U32 start8;
+        U32 pad[8];
+    };
+
+    static const U32 smBakedMagic;
+    static const U32 smBakedVersion;
+
+    /// BakedFlags for the current mesh settings.
+    static U32 getBakedFlags();
+
+    /// Write the shape as a baked shape.  sourceCRC is the CRC of the .dts
+    /// it came from, or InvalidCRC.
+    bool writeBaked(Stream*, U32 sourceCRC);
+
+    /// Read a baked shape.  If sourceCRC isn't InvalidCRC the shape must
+    /// have been baked from a .dts with that CRC.  Returns false without
+    /// touching the shape if the header doesn't match.
+    bool readBaked(Stream*, U32 sourceCRC);
+    /// @}
+
     /// @name Persist Methods
     /// Methods for saving/loading shapes to/from streams
     /// @{
@@ -499,6 +554,7 @@ public:
 
     static TSShapeAlloc alloc;
     void fixEndian(S32*, S16*, S8*, S32, S32, S32);
+    void assembleBuffers(S32*, S16*, S8*, S32, S32, S32);
     /// @}
 
     /// @name Memory Buffer Transfer Methods
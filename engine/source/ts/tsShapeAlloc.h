@@ -72,6 +72,9 @@ class TSShapeAlloc
     S32 mSize;
     S32 mMult; ///< mult incoming sizes by this (when 0, then mDest doesn't grow --> skip mode)
 
+    /// reading only...input buffers outlive the shape, so bulk data may be used where it lies
+    bool mInPlace;
+
 public:
 
     enum { ReadMode = 0, WriteMode = 1, PageSize = 1024 }; ///< PageSize must be multiple of 4 so that we can always
@@ -87,6 +90,11 @@ public:
     S32 getSize() { return mSize; }
     void setSkipMode(bool skip) { mMult = skip ? 0 : 1; }
 
+    /// When the input buffers are kept by the shape (baked shapes), meshes
+    /// point their arrays into them instead of copying into the destination.
+    void setInPlace(bool inPlace) { mInPlace = inPlace; }
+    bool isInPlace() { return mInPlace; }
+
     /// @name Reading Operations:
     ///
     /// get(): reads one or more entries of type from input buffer (doesn't affect output buffer)
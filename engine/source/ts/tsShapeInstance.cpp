@@ -28,15 +28,7 @@ S32                           TSShapeInstance::smNumSkipRenderDetails = 0;
 bool                          TSShapeInstance::smSkipFirstFog = false;
 bool                          TSShapeInstance::smSkipFog = false;
 
-Vector<QuatF>                 TSShapeInstance::smNodeCurrentRotations(__FILE__, __LINE__);
-Vector<Point3F>               TSShapeInstance::smNodeCurrentTranslations(__FILE__, __LINE__);
-Vector<F32>                   TSShapeInstance::smNodeCurrentUniformScales(__FILE__, __LINE__);
-Vector<Point3F>               TSShapeInstance::smNodeCurrentAlignedScales(__FILE__, __LINE__);
-Vector<TSScale>               TSShapeInstance::smNodeCurrentArbitraryScales(__FILE__, __LINE__);
-
-Vector<TSThread*>             TSShapeInstance::smRotationThreads(__FILE__, __LINE__);
-Vector<TSThread*>             TSShapeInstance::smTranslationThreads(__FILE__, __LINE__);
-Vector<TSThread*>             TSShapeInstance::smScaleThreads(__FILE__, __LINE__);
+Vector<TSShapeInstance*>      TSShapeInstance::smAnimateQueue(__FILE__, __LINE__);
 
 namespace {
 
@@ -121,6 +113,16 @@ TSShapeInstance::~TSShapeInstance()
     setMaterialList(NULL);
 
     delete[] mDirtyFlags;
+
+    if (mAnimateQueued)
+    {
+        for (i = 0; i < smAnimateQueue.size(); i++)
+            if (smAnimateQueue[i] == this)
+            {
+                smAnimateQueue.erase(i);
+                break;
+            }
+    }
 }
 
 void TSShapeInstance::init()
@@ -194,6 +196,9 @@ void TSShapeInstance::buildInstanceData(TSShape* _shape, bool loadMaterials)
     mData = 0;
     mScaleCurrentlyAnimated = false;
 
+    mLastAnimSubShape = -1;
+    mAnimateQueued = false;
+
     if (loadMaterials)
     {
         setMaterialList(mShape->materialList);
@@ -654,6 +659,19 @@ void TSShapeInstance::render(S32 dl, F32 intraDL, const Point3F* objectScale)
         smRenderData.currentTransform = NULL;
         S32 start = smNoRenderNonTranslucent ? mShape->subShapeFirstTranslucentObject[ss] : mShape->subShapeFirstObject[ss];
         S32 end = smNoRenderTranslucent ? mShape->subShapeFirstTranslucentObject[ss] : mShape->subShapeFirstObject[ss] + mShape->subShapeNumObjects[ss];
+
+        // Skin all the skin meshes before drawing any, so they can be
+        // skinned in parallel
+        PROFILE_START(TSShapeInstanceSkin);
+        for (i = start; i < end; i++)
+        {
+            TSMesh* mesh = mMeshObjects[i].getMesh(od);
+            if (mesh && mesh->getMeshType() == TSMesh::SkinMeshType && mMeshObjects[i].visible > 0.01f)
+                mMeshObjects[i].queueSkin(static_cast<TSSkinMesh*>(mesh));
+        }
+        TSSkinMesh::runSkinJobs();
+        PROFILE_END();
+
         for (i = start; i < end; i++)
         {
             smRenderData.currentObjectInstance = &mMeshObjects[i];
@@ -2021,6 +2039,19 @@ void TSShapeInstance::MeshObjectInstance::render(S32 objectDetail, TSMaterialLis
     }
 }
 
+bool TSShapeInstance::MeshObjectInstance::queueSkin(TSSkinMesh* mesh)
+{
+    if (!mesh->updateBones(mSkinBones) && mSkinMesh == mesh)
+        return false;
+
+    mSkinMesh = mesh;
+    mSkinVerts.setSize(mesh->initialVerts.size());
+    mSkinNorms.setSize(mesh->initialVerts.size());
+    mesh->queueSkin(mSkinBones.address(), mSkinVerts.address(), mSkinNorms.address());
+    mSkinVBGeneration = 0;
+    return true;
+}
+
 void TSShapeInstance::DecalObjectInstance::render(S32 objectDetail, TSMaterialList* materials)
 {
     /*
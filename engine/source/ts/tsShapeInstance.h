@@ -137,6 +137,25 @@ public:
         // when rendering.
         GFXVertexBufferHandle<MeshVertex> mVB;
 
+        /// @name Skinning
+        /// Skin meshes are skinned into these rather than into shared buffers,
+        /// so every instance keeps its own pose and instances can be skinned
+        /// at the same time.  They're only redone when the pose or the detail
+        /// level changes.
+        /// @{
+        Vector<Point3F> mSkinVerts;
+        Vector<Point3F> mSkinNorms;
+        Vector<MatrixF> mSkinBones;   ///< bone transforms the buffers were skinned with
+        const TSMesh* mSkinMesh;      ///< detail mesh the buffers were skinned for
+        U32 mSkinVBGeneration;        ///< TSSkinMesh::smSkinVBGeneration when mVB was filled, 0 if stale
+
+        MeshObjectInstance() : mSkinMesh(NULL), mSkinVBGeneration(0) { }
+
+        /// Queue skinning of the mesh, unless the buffers already hold this
+        /// pose.  Returns true if anything was queued.
+        bool queueSkin(TSSkinMesh* mesh);
+        /// @}
+
         S32 getSizeVB(S32 size);
         bool hasMergeIndices();
         /// @name Vertex Buffer functions
@@ -226,20 +245,50 @@ public:
     /// @}
 
     /// @name Workspace for Node Transforms
+    /// Kept per instance so different instances can be animated at once.
     /// @{
-    static Vector<QuatF>   smNodeCurrentRotations;
-    static Vector<Point3F> smNodeCurrentTranslations;
-    static Vector<F32>     smNodeCurrentUniformScales;
-    static Vector<Point3F> smNodeCurrentAlignedScales;
-    static Vector<TSScale> smNodeCurrentArbitraryScales;
+    Vector<QuatF>   mNodeCurrentRotations;
+    Vector<Point3F> mNodeCurrentTranslations;
+    Vector<F32>     mNodeCurrentUniformScales;
+    Vector<Point3F> mNodeCurrentAlignedScales;
+    Vector<TSScale> mNodeCurrentArbitraryScales;
     /// @}
 
     /// @name Threads
-    /// keep track of who controls what on currently animating shape
+    /// keep track of who controls what on this shape
     /// @{
-    static Vector<TSThread*> smRotationThreads;
-    static Vector<TSThread*> smTranslationThreads;
-    static Vector<TSThread*> smScaleThreads;
+    Vector<TSThread*> mRotationThreads;
+    Vector<TSThread*> mTranslationThreads;
+    Vector<TSThread*> mScaleThreads;
+    /// @}
+
+    /// @name Animation Memo
+    /// Where each thread was when the nodes were last animated, so
+    /// animateNodes can skip sampling the sequences when nothing has moved.
+    /// @{
+    struct AnimSample
+    {
+        const TSSequence* sequence;
+        S32 keyNum1;
+        S32 keyNum2;
+        F32 keyPos;
+        F32 transitionPos;
+        bool inTransition;
+        bool blendDisabled;
+    };
+    Vector<AnimSample> mLastAnimSamples;
+    S32 mLastAnimSubShape;   ///< subshape the samples are for, -1 if none
+
+    /// Record where the threads are now, and return true if the nodes of
+    /// subshape ss were last animated from the same place.
+    bool sameAnimSamples(S32 ss);
+    void clearAnimSamples() { mLastAnimSubShape = -1; }
+    /// @}
+
+    /// @name Batched Animation
+    /// @{
+    static Vector<TSShapeInstance*> smAnimateQueue;
+    bool mAnimateQueued;
     /// @}
 
  //-------------------------------------------------------------------------------------
@@ -577,6 +626,12 @@ public:
 
     void animate();
     void animate(S32 dl);
+
+    /// Have the instance animate() when flushAnimateQueue is next called.
+    /// Queued instances are animated together on the ThreadPool.
+    static void queueAnimate(TSShapeInstance* instance);
+    static void flushAnimateQueue();
+
     void animateNodes(S32 ss);
     void animateVisibility(S32 ss);
     void animateFrame(S32 ss);
@@ -633,18 +633,34 @@ void TSShapeInstance::clearTransition(TSThread* thread)
 
 void TSShapeInstance::updateTransitions()
 {
+    // The reference transforms and transition nodes are about to change
+    clearAnimSamples();
+
     if (mTransitionThreads.empty())
         return;
 
     S32 i;
+
+    // A shape which hasn't animated yet transitions from its default pose
+    if (mNodeCurrentRotations.size() != mShape->nodes.size())
+    {
+        mNodeCurrentRotations.setSize(mShape->nodes.size());
+        mNodeCurrentTranslations.setSize(mShape->nodes.size());
+        for (i = 0; i < mShape->nodes.size(); i++)
+        {
+            mShape->defaultRotations[i].getQuatF(&mNodeCurrentRotations[i]);
+            mNodeCurrentTranslations[i] = mShape->defaultTranslations[i];
+        }
+    }
+
     mNodeReferenceRotations.setSize(mShape->nodes.size());
     mNodeReferenceTranslations.setSize(mShape->nodes.size());
     for (i = 0; i < mShape->nodes.size(); i++)
     {
         if (mTransitionRotationNodes.test(i))
-            mNodeReferenceRotations[i].set(smNodeCurrentRotations[i]);
+            mNodeReferenceRotations[i].set(mNodeCurrentRotations[i]);
         if (mTransitionTranslationNodes.test(i))
-            mNodeReferenceTranslations[i] = smNodeCurrentTranslations[i];
+            mNodeReferenceTranslations[i] = mNodeCurrentTranslations[i];
     }
 
     if (animatesScale())
@@ -655,7 +671,7 @@ void TSShapeInstance::updateTransitions()
             for (i = 0; i < mShape->nodes.size(); i++)
             {
                 if (mTransitionScaleNodes.test(i))
-                    mNodeReferenceUniformScales[i] = smNodeCurrentUniformScales[i];
+                    mNodeReferenceUniformScales[i] = i < mNodeCurrentUniformScales.size() ? mNodeCurrentUniformScales[i] : 1.0f;
             }
         }
         else if (animatesAlignedScale())
@@ -664,7 +680,7 @@ void TSShapeInstance::updateTransitions()
             for (i = 0; i < mShape->nodes.size(); i++)
             {
                 if (mTransitionScaleNodes.test(i))
-                    mNodeReferenceScaleFactors[i] = smNodeCurrentAlignedScales[i];
+                    mNodeReferenceScaleFactors[i] = i < mNodeCurrentAlignedScales.size() ? mNodeCurrentAlignedScales[i] : Point3F(1.0f, 1.0f, 1.0f);
             }
         }
         else
@@ -675,8 +691,13 @@ void TSShapeInstance::updateTransitions()
             {
                 if (mTransitionScaleNodes.test(i))
                 {
-                    mNodeReferenceScaleFactors[i] = smNodeCurrentArbitraryScales[i].mScale;
-                    mNodeReferenceArbitraryScaleRots[i].set(smNodeCurrentArbitraryScales[i].mRotate);
+                    TSScale scale;
+                    if (i < mNodeCurrentArbitraryScales.size())
+                        scale = mNodeCurrentArbitraryScales[i];
+                    else
+                        scale.identity();
+                    mNodeReferenceScaleFactors[i] = scale.mScale;
+                    mNodeReferenceArbitraryScaleRots[i].set(scale.mRotate);
                 }
             }
         }
@@ -16,6 +16,8 @@ $pref::shadows = "2";
 $pref::HudMessageLogSize = 40;
 $pref::ChatHudLength = 1;
 $pref::useStencilShadows = true;
+// Live particle budget shared by all emitters, 0 for no limit
+$pref::Particles::maxParticles = 8192;
 $pref::forceDirectConnect = false;
 $pref::ForceSecretMode = false;
 $Pref::DisableSecretMode = false;
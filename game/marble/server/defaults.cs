@@ -28,6 +28,10 @@ $Pref::Server::ConnectionError = $Text::ErrorCannotConnect;
 // overrides pref::net::port for dedicated servers
 $Pref::Server::Port = 28000;
 
+// Receive and send game packets on a separate network thread instead of
+// the main loop (currently Linux only).
+$pref::Net::NetworkThread = false;
+
 // If the password is set, clients must provide it in order
 // to connect to the server
 $Pref::Server::Password = "";